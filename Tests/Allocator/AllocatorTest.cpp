@@ -0,0 +1,91 @@
+#include <Allocator.hpp>
+#include <Random.hpp>
+#include <UnorderedMap.hpp>
+#include <stdio.h>
+
+int main()
+{
+    {
+        // small sizes come back from the free list of their class
+        alignas(16) static hsd::uchar buf[4096];
+        static hsd::u64 outside;
+        hsd::size_class_allocator<hsd::u64> alloc{buf, sizeof(buf)};
+
+        auto* _first = alloc.allocate(3).unwrap();
+        auto* _second = alloc.allocate(3).unwrap();
+        alloc.deallocate(_first, 3).unwrap();
+        auto* _third = alloc.allocate(2).unwrap();
+
+        printf("%d %d\n", _third == _first, _second != _first);
+        printf("%d\n", alloc.deallocate(&outside, 1).is_ok());
+        printf("%d\n", alloc.allocate(1 << 20).is_ok());
+    }
+
+    puts("============");
+
+    {
+        // many live blocks, random order of frees, checked contents
+        static hsd::uchar buf[1 << 20];
+        hsd::size_class_allocator<hsd::uchar> alloc{buf, sizeof(buf)};
+        hsd::mt19937_64 rng;
+
+        constexpr hsd::usize count = 2000;
+        static hsd::uchar* ptrs[count];
+        static hsd::usize sizes[count];
+        hsd::usize _failed = 0;
+
+        for (hsd::usize _round = 0; _round < 20; _round++)
+        {
+            for (hsd::usize _index = 0; _index < count; _index++)
+            {
+                if (ptrs[_index] != nullptr && rng.generate() % 2 == 0)
+                {
+                    for (hsd::usize _byte = 0; _byte < sizes[_index]; _byte++)
+                    {
+                        if (ptrs[_index][_byte] != static_cast<hsd::uchar>(_index))
+                            _failed++;
+                    }
+
+                    alloc.deallocate(ptrs[_index], sizes[_index]).unwrap();
+                    ptrs[_index] = nullptr;
+                }
+                else if (ptrs[_index] == nullptr)
+                {
+                    hsd::usize _size = rng.generate() % 8 == 0 ?
+                        rng.generate() % 4000 + 513 : rng.generate() % 300 + 1;
+
+                    auto _result = alloc.allocate(_size);
+
+                    if (_result)
+                    {
+                        ptrs[_index] = _result.unwrap();
+                        sizes[_index] = _size;
+
+                        for (hsd::usize _byte = 0; _byte < _size; _byte++)
+                            ptrs[_index][_byte] = static_cast<hsd::uchar>(_index);
+                    }
+                }
+            }
+        }
+
+        for (hsd::usize _index = 0; _index < count; _index++)
+            alloc.deallocate(ptrs[_index], sizes[_index]).unwrap();
+
+        printf("%zu %d\n", _failed, alloc.allocate(256 * 1024).is_ok());
+    }
+
+    puts("============");
+
+    {
+        static hsd::uchar buf[256 * 1024];
+        hsd::buffered_umap<hsd::i32, hsd::i32> map{{buf, sizeof(buf)}};
+
+        for (hsd::i32 _index = 0; _index < 1000; _index++)
+            map.emplace(_index, _index * 2);
+
+        for (hsd::i32 _index = 0; _index < 1000; _index += 2)
+            map.erase(map.find(_index)).unwrap();
+
+        printf("%zu %d\n", map.size(), map[999]);
+    }
+}
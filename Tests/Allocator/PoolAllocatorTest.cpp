@@ -0,0 +1,234 @@
+#include <PoolAllocator.hpp>
+#include <List.hpp>
+#include <UniquePtr.hpp>
+#include <SharedPtr.hpp>
+#include <Thread.hpp>
+#include <Vector.hpp>
+#include <MPMCQueue.hpp>
+#include <Functional.hpp>
+#include <stdio.h>
+
+struct Node
+{
+    hsd::u64 key;
+    hsd::u64 value;
+};
+
+// No other test uses a pool of this size
+struct Unique
+{
+    hsd::u64 data[5];
+};
+
+static hsd::atomic_usize corrupted = 0;
+
+// Every thread keeps a window of live nodes and checks them before the
+// free, so a slot handed out twice shows up as a wrong key
+template < template <typename> typename Allocator >
+static void churn(hsd::u64 id)
+{
+    Allocator<Node> alloc;
+    Node* live[64] = {};
+
+    for (hsd::u64 _round = 0; _round < 20000; _round++)
+    {
+        auto& _slot = live[_round % 64];
+
+        if (_slot != nullptr)
+        {
+            if (_slot->key != id || _slot->value != _round - 64)
+                corrupted++;
+
+            alloc.deallocate(_slot, 1).unwrap();
+        }
+
+        _slot = alloc.allocate(1).unwrap();
+        _slot->key = id;
+        _slot->value = _round;
+    }
+
+    for (auto* _node : live)
+        alloc.deallocate(_node, 1).unwrap();
+}
+
+int main()
+{
+    {
+        // a freed slot is the next one handed out, same sized types share the pool
+        hsd::pool_allocator<Node> alloc;
+        hsd::pool_allocator<hsd::f64[2]> other;
+
+        auto* _first = alloc.allocate(1).unwrap();
+        auto* _second = alloc.allocate(1).unwrap();
+        alloc.deallocate(_first, 1).unwrap();
+        auto* _third = other.allocate(1).unwrap();
+
+        printf("%d %d\n", hsd::bit_cast<void*>(_third) == _first, _second != _first);
+
+        auto* _array = alloc.allocate(10).unwrap();
+        alloc.deallocate(_array, 10).unwrap();
+        other.deallocate(_third, 1).unwrap();
+        alloc.deallocate(_second, 1).unwrap();
+    }
+
+    puts("============");
+
+    {
+        hsd::list<hsd::i32, hsd::pool_allocator> first;
+        hsd::list<hsd::i32, hsd::pool_allocator> second;
+
+        for (hsd::i32 _index = 0; _index < 1000; _index++)
+            (_index % 2 ? first : second).push_back(_index);
+
+        first.clear();
+
+        for (hsd::i32 _index = 0; _index < 3; _index++)
+            second.pop_front();
+
+        hsd::i32 _sum = 0;
+
+        for (auto _value : second)
+            _sum += _value;
+
+        printf("%zu %zu %d\n", first.size(), second.size(), _sum);
+
+        hsd::unique_ptr<Node, hsd::pool_allocator> _node =
+            hsd::make_unique<Node, hsd::pool_allocator>(Node{1, 2});
+
+        printf("%llu %llu\n", _node->key, _node->value);
+    }
+
+    puts("============");
+
+    {
+        // the counters of these come from the pool of the thread
+        auto _ptr = hsd::make_safe_shared<Node>(Node{3, 4});
+        auto _copy = _ptr;
+
+        printf("%zu %llu\n", _ptr.get_count(), _copy->value);
+    }
+
+    puts("============");
+
+    {
+        hsd::vector<hsd::thread> threads;
+
+        for (hsd::u64 _index = 0; _index < 4; _index++)
+            threads.emplace_back(churn<hsd::atomic_pool_allocator>, _index);
+
+        for (hsd::u64 _index = 4; _index < 8; _index++)
+            threads.emplace_back(churn<hsd::pool_allocator>, _index);
+
+        for (auto& _thread : threads)
+            _thread.join().unwrap();
+
+        printf("%zu\n", corrupted.load());
+    }
+
+    puts("============");
+
+    {
+        // nodes made here and freed by other threads, which give
+        // them back to the shared pool when they exit
+        static Node* nodes[1000];
+        hsd::pool_allocator<Node> alloc;
+
+        for (hsd::usize _round = 0; _round < 4; _round++)
+        {
+            for (auto*& _node : nodes)
+            {
+                _node = alloc.allocate(1).unwrap();
+                *_node = {_round, _round};
+            }
+
+            hsd::thread _consumer{[]
+            {
+                hsd::pool_allocator<Node> _alloc;
+
+                for (auto* _node : nodes)
+                    _alloc.deallocate(_node, 1).unwrap();
+            }};
+
+            _consumer.join().unwrap();
+        }
+
+        printf("%d\n", alloc.allocate(1).is_ok());
+    }
+
+    puts("============");
+
+    {
+        // the free slots and the unused run of a thread come back when it exits
+        for (hsd::usize _round = 0; _round < 3; _round++)
+        {
+            hsd::thread _worker{[]
+            {
+                hsd::pool_allocator<Unique> _alloc;
+                Unique* _slots[10];
+
+                for (auto*& _slot : _slots)
+                    _slot = _alloc.allocate(1).unwrap();
+
+                for (auto* _slot : _slots)
+                    _alloc.deallocate(_slot, 1).unwrap();
+            }};
+
+            _worker.join().unwrap();
+
+            hsd::usize _count = 0;
+            auto& _pool = hsd::pool_detail::shared_pool<sizeof(Unique), 64>;
+            void* _first = _pool.take_all(_count);
+
+            printf("%zu\n", _count);
+            _pool.give_back(_first);
+        }
+    }
+
+    puts("============");
+
+    {
+        // counters shared by many threads and freed by whichever is
+        // last, and a queue destroyed with jobs still in it
+        hsd::function<void()> _job = [] {};
+        hsd::MPMCQueue<hsd::function<void()>> _queue{64};
+        hsd::vector<hsd::thread> _threads;
+
+        for (hsd::usize _index = 0; _index < 48; _index++)
+            _queue.emplace(hsd::function<void()>{_job});
+
+        for (hsd::usize _index = 0; _index < 4; _index++)
+        {
+            _threads.emplace_back([&_queue]
+            {
+                hsd::function<void()> _task = nullptr;
+
+                for (hsd::usize _count = 0; _count < 8 && _queue.try_pop(_task); _count++)
+                    _task().unwrap();
+
+                for (hsd::usize _round = 0; _round < 1000; _round++)
+                {
+                    auto _shared = hsd::make_safe_shared<Node>(Node{_round, _round});
+                    auto _copy = _shared;
+                    corrupted += _copy->key != _round;
+                }
+            });
+        }
+
+        for (auto& _thread : _threads)
+            _thread.join().unwrap();
+
+        _job = nullptr;
+    }
+
+    {
+        // a slot freed twice or written after its free breaks the
+        // free list of this thread, which these would run into
+        hsd::vector<hsd::safe_shared_ptr<Node>> _nodes;
+
+        for (hsd::u64 _index = 0; _index < 1000; _index++)
+            _nodes.emplace_back(hsd::make_safe_shared<Node>(Node{_index, _index}));
+
+        _nodes.clear();
+        printf("%zu\n", corrupted.load());
+    }
+}
@@ -0,0 +1,110 @@
+#define HSD_USE_TL_CACHE
+#include <Allocator.hpp>
+#include <String.hpp>
+#include <Vector.hpp>
+#include <Thread.hpp>
+#include <stdio.h>
+
+static void* blocks[1000];
+
+int main()
+{
+    {
+        // same class comes back from the magazine, growing inside the class stays in place
+        hsd::tl_cache_allocator<hsd::uchar> alloc;
+
+        auto* _first = alloc.allocate(40).unwrap();
+        alloc.deallocate(_first, 40).unwrap();
+        auto* _second = alloc.allocate(48).unwrap();
+        auto* _grown = alloc.reallocate(_second, 48, 33).unwrap();
+        auto* _moved = alloc.reallocate(_grown, 33, 100).unwrap();
+
+        printf("%d %d %d\n", _first == _second, _grown == _second, _moved != _grown);
+
+        auto* _large = alloc.allocate(1 << 16).unwrap();
+        _large[(1 << 16) - 1] = 42;
+        _large = alloc.reallocate(_large, 1 << 16, 1 << 17).unwrap();
+
+        printf("%d\n", _large[(1 << 16) - 1]);
+
+        alloc.deallocate(_large, 1 << 17).unwrap();
+        alloc.deallocate(_moved, 100).unwrap();
+    }
+
+    puts("============");
+
+    {
+        // with HSD_USE_TL_CACHE the strings and vectors go through the cache too
+        hsd::vector<hsd::string> strings;
+
+        for (hsd::i32 _index = 0; _index < 200; _index++)
+            strings.emplace_back(hsd::to_string(_index * 7));
+
+        hsd::usize _length = 0;
+
+        for (auto& _str : strings)
+            _length += _str.size();
+
+        printf("%zu %s\n", _length, strings[199].c_str());
+    }
+
+    puts("============");
+
+    {
+        // blocks freed by another thread go back to their owner
+        for (auto*& _block : blocks)
+            _block = hsd::tl_cache_detail::allocate(64);
+
+        hsd::thread _consumer{[]
+        {
+            for (auto* _block : blocks)
+                hsd::tl_cache_detail::deallocate(_block);
+        }};
+
+        _consumer.join().unwrap();
+
+        hsd::usize _reused = 0;
+
+        for (hsd::usize _index = 0; _index < 1000; _index++)
+        {
+            void* _block = hsd::tl_cache_detail::allocate(64);
+
+            for (auto* _old : blocks)
+                _reused += _old == _block;
+        }
+
+        printf("%zu\n", _reused);
+    }
+
+    puts("============");
+
+    {
+        // a block that outlives its thread, and the cache of that thread is adopted
+        static void* leftover = nullptr;
+
+        hsd::thread _first{[]
+        {
+            leftover = hsd::tl_cache_detail::allocate(200);
+        }};
+
+        _first.join().unwrap();
+        hsd::tl_cache_detail::deallocate(leftover);
+
+        static bool adopted = false;
+
+        hsd::thread _second{[]
+        {
+            for (auto*& _block : blocks)
+            {
+                _block = hsd::tl_cache_detail::allocate(200);
+                adopted |= _block == leftover;
+            }
+
+            for (auto* _block : blocks)
+                hsd::tl_cache_detail::deallocate(_block);
+        }};
+
+        _second.join().unwrap();
+        printf("%d\n", adopted);
+    }
+}
@@ -0,0 +1,129 @@
+#include <TrackingAllocator.hpp>
+#include <Vector.hpp>
+#include <List.hpp>
+#include <Thread.hpp>
+#include <stdio.h>
+
+template <typename T>
+using tracked = hsd::tracking_allocator<T>;
+
+template <typename T>
+using tracked_buffered = hsd::tracking_allocator<T, hsd::buffered_allocator>;
+
+static hsd::alloc_tag vectors{"vectors"};
+static hsd::alloc_tag workers{"workers"};
+
+static void print_stats(hsd::alloc_tag tag)
+{
+    auto _stats = tag.stats();
+
+    printf(
+        "%s: current %lld, peak %lld, total %llu, allocations %llu, deallocations %llu\n",
+        tag.name(), _stats.current_bytes, _stats.peak_bytes, _stats.total_bytes,
+        _stats.allocations, _stats.deallocations
+    );
+}
+
+int main()
+{
+    {
+        // every growth of the vector is an allocation of the tag
+        hsd::vector<hsd::i32, tracked> _vec{tracked<hsd::i32>{vectors}};
+
+        for (hsd::i32 _index = 0; _index < 100; _index++)
+            _vec.push_back(_index);
+
+        print_stats(vectors);
+        _vec.clear();
+        _vec.shrink_to_fit();
+    }
+
+    print_stats(vectors);
+
+    auto _stats = vectors.stats();
+    printf(
+        "%llu %llu %llu\n", _stats.histogram[0],
+        _stats.histogram[hsd::tracking_detail::bucket_of(256)], _stats.histogram[12]
+    );
+
+    puts("============");
+
+    {
+        // the tag of a call site is found again by the same call site
+        hsd::alloc_tag _first;
+
+        for (hsd::i32 _round = 0; _round < 2; _round++)
+        {
+            auto _alloc = tracked<hsd::u64>::here();
+            _alloc.deallocate(_alloc.allocate(4).unwrap(), 4).unwrap();
+
+            if (_round == 0)
+                _first = _alloc.tag();
+            else
+                printf("%d %d\n", _first.index() == _alloc.tag().index(), _first.location().line());
+        }
+
+        printf("%s %llu\n", _first.name(), _first.stats().allocations);
+    }
+
+    puts("============");
+
+    {
+        // any allocator can be wrapped, the list nodes are rebound from it
+        hsd::uchar _buf[1024] = {};
+        hsd::buffered_allocator<hsd::uchar> _inner{_buf, sizeof(_buf)};
+        hsd::alloc_tag _tag{"buffered list"};
+        hsd::list<hsd::i32, tracked_buffered> _list{tracked_buffered<hsd::i32>{
+            _tag, hsd::buffered_allocator<hsd::i32>{_inner}}};
+
+        for (hsd::i32 _index = 0; _index < 10; _index++)
+            _list.push_back(_index);
+
+        _list.pop_front();
+        print_stats(_tag);
+    }
+
+    puts("============");
+
+    {
+        // counters of many threads, some of them already exited
+        static hsd::u64* leftovers[8];
+        hsd::vector<hsd::thread> _threads;
+
+        for (hsd::usize _index = 0; _index < 8; _index++)
+        {
+            _threads.emplace_back([](hsd::usize id)
+            {
+                tracked<hsd::u64> _alloc{workers};
+
+                for (hsd::usize _round = 0; _round < 1000; _round++)
+                    _alloc.deallocate(_alloc.allocate(2).unwrap(), 2).unwrap();
+
+                leftovers[id] = _alloc.allocate(1).unwrap();
+            }, _index);
+        }
+
+        for (auto& _thread : _threads)
+            _thread.join().unwrap();
+
+        print_stats(workers);
+        tracked<hsd::u64> _alloc{workers};
+
+        // freed by another thread than the one that allocated them
+        for (auto* _leftover : leftovers)
+            _alloc.deallocate(_leftover, 1).unwrap();
+
+        print_stats(workers);
+    }
+
+    puts("============");
+
+    {
+        hsd::alloc_tag _tag{"say \"hi\""};
+        tracked<hsd::uchar> _alloc{_tag};
+        _alloc.deallocate(_alloc.allocate(100000).unwrap(), 100000).unwrap();
+
+        hsd::tracking_report::write_text();
+        hsd::tracking_report::write_json();
+    }
+}
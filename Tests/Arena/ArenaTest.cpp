@@ -0,0 +1,90 @@
+#include <Arena.hpp>
+#include <Vector.hpp>
+#include <String.hpp>
+#include <UnorderedMap.hpp>
+#include <SharedPtr.hpp>
+#include <stdio.h>
+
+template <typename T>
+using arena_vector = hsd::vector<T, hsd::arena_allocator>;
+
+int main()
+{
+    {
+        // starts in the stack buffer, then moves on to chunks
+        alignas(16) hsd::uchar buf[256];
+        hsd::arena scratch{buf, sizeof(buf)};
+
+        auto* _first = scratch.allocate(100).unwrap();
+        auto* _second = scratch.allocate(100).unwrap();
+        auto* _third = scratch.allocate(100).unwrap();
+
+        printf(
+            "%d %d %d\n", _first == buf, _second < buf + sizeof(buf),
+            _third >= buf && _third < buf + sizeof(buf)
+        );
+
+        scratch.reset();
+        printf("%d\n", scratch.allocate(8).unwrap() == buf);
+    }
+
+    puts("============");
+
+    {
+        hsd::arena scratch;
+        arena_vector<hsd::i32> _numbers{hsd::arena_allocator<hsd::i32>{scratch}};
+
+        for (hsd::i32 _index = 0; _index < 1000; _index++)
+            _numbers.push_back(_index);
+
+        hsd::i32 _sum = 0;
+
+        for (auto _value : _numbers)
+            _sum += _value;
+
+        printf("%d %zu\n", _sum, _numbers.size());
+
+        auto _mark = scratch.mark();
+
+        {
+            // the vector goes away before the scope rewinds
+            hsd::arena_scope _scope{scratch};
+            arena_vector<hsd::f64> _temporary{hsd::arena_allocator<hsd::f64>{scratch}};
+            _temporary.resize(10);
+        }
+
+        printf("%d\n", scratch.mark().ptr == _mark.ptr);
+
+        hsd::unordered_map<hsd::string, hsd::i32, hsd::hash<hsd::usize, hsd::string>, hsd::arena_allocator> 
+            _counts{hsd::arena_allocator<hsd::uchar>{scratch}};
+
+        const char* _words[] = {"get", "put", "get", "head", "get", "put"};
+
+        for (auto* _word : _words)
+            _counts[_word]++;
+
+        printf("%d %d %d\n", _counts["get"], _counts["put"], _counts["head"]);
+
+        hsd::arena_allocator<hsd::uchar> _alloc{scratch};
+        auto _shared = hsd::make_unsafe_shared<hsd::i32>(_alloc, 42);
+        auto _copy = _shared;
+        printf("%d\n", *_copy);
+    }
+
+    puts("============");
+
+    {
+        hsd::arena scratch{64};
+        auto _before = scratch.mark();
+
+        for (hsd::i32 _request = 0; _request < 3; _request++)
+        {
+            hsd::arena_scope _scope{scratch};
+
+            for (hsd::i32 _index = 0; _index < 100; _index++)
+                scratch.allocate(48).unwrap();
+        }
+
+        printf("%d\n", scratch.mark().ptr == _before.ptr);
+    }
+}
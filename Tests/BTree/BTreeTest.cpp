@@ -0,0 +1,78 @@
+#include <BTree.hpp>
+#include <String.hpp>
+#include <stdio.h>
+
+int main()
+{
+    {
+        hsd::btree_map<hsd::u64, hsd::u64> map;
+
+        // inserted out of order, iterated in order
+        for (hsd::u64 i = 0; i < 10000; i++)
+            map.emplace((i * 7919) % 10000, i);
+
+        for (hsd::u64 i = 0; i < 10000; i += 2)
+            map.erase(i);
+
+        hsd::u64 prev = 0, sorted = 1;
+
+        for (auto& [key, value] : map)
+        {
+            sorted &= (prev <= key);
+            prev = key;
+        }
+
+        printf(
+            "size: %zu, sorted: %llu, lower: %llu, upper: %llu\n", map.size(),
+            sorted, map.lower_bound(100)->first, map.upper_bound(101)->first
+        );
+
+        hsd::u64 sum = 0;
+
+        for (auto& [key, value] : map.range(1000, 1010))
+            sum += key;
+
+        printf("%llu %llu %d\n", sum, (--map.end())->first, map.at(42).is_ok());
+        puts("============");
+    }
+
+    {
+        hsd::btree_map<hsd::string, hsd::i32> map;
+        map.emplace("pear", 3);
+        map.emplace("apple", 1);
+        map.emplace("orange", 2);
+        map["banana"] = 4;
+
+        auto copy = map;
+        copy.erase("apple");
+
+        for (auto& [name, count] : map)
+            printf("%s %d\n", name.c_str(), count);
+
+        printf("%zu %d\n", copy.size(), copy.contains("apple"));
+        puts("============");
+    }
+
+    {
+        hsd::uchar buf[8192]{};
+        hsd::buffered_btree_set<hsd::i32> set{
+            hsd::buffered_allocator<hsd::uchar>{buf, 8192}
+        };
+
+        for (hsd::i32 i = 100; i > 0; i--)
+            set.insert(i % 37);
+
+        for (auto iter = set.begin(); iter != set.end();)
+        {
+            if (*iter % 3 == 0)
+                iter = set.erase(iter);
+            else
+                ++iter;
+        }
+
+        for (auto value : set.range(10, 20))
+            printf("%d ", value);
+
+        printf("\nsize: %zu\n", set.size());
+    }
+}
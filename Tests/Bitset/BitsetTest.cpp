@@ -0,0 +1,42 @@
+#include <Bitset.hpp>
+#include <stdio.h>
+
+int main()
+{
+    {
+        hsd::bitset<100> flags;
+        flags.set(3).set(64).set(99);
+        printf("count: %zu, test(64): %d, test(65): %d\n", flags.count(), flags[64], flags[65]);
+
+        for (hsd::usize pos : flags.set_bits())
+            printf("%zu ", pos);
+
+        auto inverted = ~flags;
+        printf("\ninverted count: %zu, all: %d\n", inverted.count(), (inverted | flags).all());
+        printf("first: %zu, next after 3: %zu\n", flags.find_first(), flags.find_next(3));
+        puts("============");
+    }
+
+    {
+        hsd::dynamic_bitset<> dirty(1000);
+        hsd::dynamic_bitset<> visible(1000, true);
+
+        for (hsd::usize i = 0; i < 1000; i += 7)
+            dirty.set(i);
+
+        visible.reset(7);
+        dirty &= visible;
+        printf("dirty and visible: %zu\n", dirty.count());
+
+        dirty.resize(1003, true);
+        printf("after resize: %zu, last: %d\n", dirty.count(), dirty[1002]);
+
+        hsd::dynamic_bitset<> bits;
+
+        for (hsd::usize i = 0; i < 70; i++)
+            bits.push_back(i % 3 == 0);
+
+        printf("%zu bits, %zu words, %zu set\n", bits.size(), bits.words().size(), bits.count());
+        printf("none: %d, at(70) is ok: %d\n", bits.none(), bits.at(70).is_ok());
+    }
+}
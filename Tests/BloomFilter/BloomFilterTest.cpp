@@ -0,0 +1,56 @@
+#include <BloomFilter.hpp>
+#include <String.hpp>
+#include <stdio.h>
+
+int main()
+{
+    {
+        hsd::bloom_filter<hsd::u64> filter{100000, 0.01};
+
+        for (hsd::u64 i = 0; i < 100000; i++)
+            filter.insert(i * 3);
+
+        hsd::usize missing = 0, false_positives = 0;
+
+        for (hsd::u64 i = 0; i < 100000; i++)
+        {
+            missing += !filter.contains(i * 3);
+            false_positives += filter.contains(i * 3 + 1);
+        }
+
+        // no false negatives, and roughly 1% false positives
+        printf("missing: %zu, fp below 2%%: %d\n", missing, false_positives < 2000);
+
+        auto bytes = filter.serialize();
+        auto copy = hsd::bloom_filter<hsd::u64>::deserialize(
+            bytes.data(), bytes.size()
+        ).unwrap();
+
+        printf(
+            "%zu %d %d\n", copy.size(), copy.contains(300),
+            hsd::bloom_filter<hsd::u64>::deserialize(bytes.data(), 10).is_ok()
+        );
+
+        puts("============");
+    }
+
+    {
+        hsd::counting_bloom_filter<hsd::string> filter{1000};
+        filter.insert("alpha");
+        filter.insert("beta");
+        filter.insert("beta");
+
+        printf("%d %d ", filter.contains("alpha"), filter.contains("gamma"));
+        filter.erase("alpha");
+        filter.erase("beta");
+        printf("%d %d %zu\n", filter.contains("alpha"), filter.contains("beta"), filter.size());
+
+        auto bytes = filter.serialize();
+        auto copy = hsd::counting_bloom_filter<hsd::string>::deserialize(
+            bytes.data(), bytes.size()
+        ).unwrap();
+
+        copy.erase("beta");
+        printf("%d %zu\n", copy.contains("beta"), copy.bits().size());
+    }
+}
@@ -0,0 +1,58 @@
+#include <ConcurrentMap.hpp>
+#include <Thread.hpp>
+#include <String.hpp>
+#include <stdio.h>
+
+static hsd::concurrent_umap<hsd::u64, hsd::u64> counters;
+
+static void worker(hsd::u64 id)
+{
+    for (hsd::u64 i = 0; i < 10000; i++)
+    {
+        counters.try_emplace(i % 1000, 0ull);
+        counters.update(i % 1000, [](hsd::u64& value) { value++; });
+        counters.insert_or_assign(100000 + id * 10000 + i, i);
+    }
+}
+
+int main()
+{
+    {
+        hsd::thread t0{worker, 0ull}, t1{worker, 1ull};
+        hsd::thread t2{worker, 2ull}, t3{worker, 3ull};
+        t0.join().unwrap();
+        t1.join().unwrap();
+        t2.join().unwrap();
+        t3.join().unwrap();
+
+        hsd::u64 total = 0;
+
+        for (hsd::u64 i = 0; i < 1000; i++)
+            counters.visit(i, [&](const hsd::u64& value) { total += value; });
+
+        printf("size: %zu, total: %llu\n", counters.size(), total);
+
+        hsd::usize erased = counters.erase_if(
+            [](const hsd::u64& key, hsd::u64&) { return key >= 100000; }
+        );
+
+        printf("erased: %zu, size: %zu\n", erased, counters.size());
+        puts("============");
+    }
+
+    {
+        hsd::concurrent_umap<hsd::string, hsd::i32> headers;
+        hsd::pair<const char*, hsd::i32> batch[] = {
+            {"Host", 1}, {"Accept", 2}, {"Host", 3}, {"Cookie", 4}
+        };
+
+        headers.insert_or_assign_batch(batch, batch + 4);
+        headers.erase("Cookie");
+
+        printf(
+            "%zu %d %d %d\n", headers.size(), headers.find("Host").unwrap(),
+            headers.find(hsd::string_view{"Accept"}).unwrap(),
+            headers.contains("Cookie")
+        );
+    }
+}
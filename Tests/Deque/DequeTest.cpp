@@ -0,0 +1,64 @@
+#include <Deque.hpp>
+#include <String.hpp>
+#include <stdio.h>
+
+int main()
+{
+    {
+        hsd::deque<hsd::i32> dq = {{3, 4, 5}};
+        dq.push_front(2);
+        dq.push_front(1);
+        dq.push_back(6);
+
+        for (auto& val : dq)
+            printf("%d ", val);
+
+        printf("\nfront: %d, back: %d, [2]: %d\n", dq.front(), dq.back(), dq[2]);
+        dq.pop_front();
+        dq.pop_back();
+        printf("size: %zu, at(10) is ok: %d\n", dq.size(), dq.at(10).is_ok());
+        puts("============");
+    }
+
+    {
+        // references survive pushes at both ends
+        hsd::deque<hsd::i32, hsd::allocator, 64> dq;
+        printf("block size: %zu\n", dq.block_size());
+        hsd::i32& first = dq.emplace_back(0);
+
+        for (hsd::i32 i = 1; i <= 1000; i++)
+        {
+            dq.push_back(i);
+            dq.push_front(-i);
+        }
+
+        hsd::i64 sum = 0;
+
+        for (auto val : dq)
+            sum += val;
+
+        printf("%zu %lld %d %d\n", dq.size(), sum, first, &first == &dq[1000]);
+
+        while (dq.size() > 1)
+        {
+            dq.pop_front();
+
+            if (dq.size() > 1)
+                dq.pop_back();
+        }
+
+        printf("%d %d\n", dq.front(), &first == &dq.front());
+        puts("============");
+    }
+
+    {
+        hsd::stable_vector<hsd::string> names;
+        auto& alice = names.emplace_back("alice");
+
+        for (hsd::i32 i = 0; i < 500; i++)
+            names.emplace_back(hsd::to_string(i));
+
+        auto names2 = names;
+        printf("%s %zu %s\n", alice.c_str(), names2.size(), names2.back().c_str());
+    }
+}
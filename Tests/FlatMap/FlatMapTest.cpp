@@ -0,0 +1,117 @@
+#include <FlatMap.hpp>
+#include <String.hpp>
+#include <TrackingAllocator.hpp>
+#include <stdio.h>
+
+static auto check_erase()
+{
+    hsd::flat_map<hsd::i32, hsd::i32> map;
+
+    for (hsd::i32 i = 0; i < 20; i++)
+        map.emplace(i * i, i);
+
+    for (auto iter = map.begin(); iter != map.end();)
+    {
+        if (iter->second % 3 == 0)
+        {
+            iter = map.erase(iter).unwrap();
+        }
+        else
+        {
+            iter++;
+        }
+    }
+
+    return map;
+}
+
+int main()
+{
+    {
+        auto map = check_erase();
+
+        for (hsd::i32 i = 0; i < 20; i++)
+        {
+            if (map.contains(i * i))
+                printf("%d %d\n", i * i, map[i * i]);
+        }
+
+        printf("size: %zu\n", map.size());
+        puts("============");
+    }
+
+    {
+        hsd::flat_map<hsd::u64, hsd::u64> map;
+
+        for (hsd::u64 i = 0; i < 100000; i++)
+            map.emplace(i, i * 2);
+
+        hsd::u64 sum = 0;
+
+        for (hsd::u64 i = 0; i < 100000; i += 2)
+            map.erase(i);
+
+        for (auto& [key, value] : map)
+            sum += value - key;
+
+        printf("size: %zu, sum: %llu, missing: %d\n",
+            map.size(), sum, map.at(100001).is_ok());
+
+        puts("============");
+    }
+
+    {
+        hsd::flat_map<hsd::string, hsd::i32> map;
+        map.emplace("first", 1);
+        map.emplace("second", 2);
+        map.emplace("third", 3);
+        map["second"] = 22;
+
+        auto copy = map;
+        copy.erase("first");
+
+        printf("%d %d %d\n", map["first"], map["second"], map["third"]);
+        printf("%zu %d\n", copy.size(), copy.contains("first"));
+        puts("============");
+    }
+
+    {
+        hsd::uchar buf[4096]{};
+        hsd::buffered_flat_map<hsd::i32, hsd::i32> map{
+            hsd::buffered_allocator<hsd::uchar>{buf, 4096}
+        };
+
+        for (hsd::i32 i = 1; i <= 14; i++)
+            map.emplace(i, i);
+
+        printf("%d\n========\n", map[8]);
+        printf("%d\n========\n", map[9]);
+    }
+
+    {
+        // the stolen buffers are freed by the allocator they came from,
+        // the numbers of each tag end at zero only if every one is
+        static hsd::alloc_tag first_tag{"first"};
+        static hsd::alloc_tag second_tag{"second"};
+
+        {
+            using map_type = hsd::flat_map<
+                hsd::i32, hsd::i32, hsd::hash<hsd::usize, hsd::i32>, hsd::tracking_allocator>;
+            map_type first{hsd::tracking_allocator<hsd::uchar>{first_tag}};
+            map_type second{hsd::tracking_allocator<hsd::uchar>{second_tag}};
+
+            first.emplace(1, 1);
+
+            for (hsd::i32 i = 0; i < 100; i++)
+                second.emplace(i, i * 2);
+
+            first = hsd::move(second);
+            printf("%zu %d %zu\n", first.size(), first[99], second.size());
+        }
+
+        printf(
+            "%lld %lld\n", first_tag.stats().current_bytes,
+            second_tag.stats().current_bytes
+        );
+    }
+}
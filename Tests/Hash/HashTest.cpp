@@ -0,0 +1,30 @@
+#include <String.hpp>
+#include <UnorderedMap.hpp>
+#include <stdio.h>
+
+template <typename T>
+using fast_hash = hsd::fast_hash<hsd::usize, T>;
+
+int main()
+{
+    // works in constant expressions as well
+    constexpr auto compile_time = fast_hash<const char*>::get_hash("HackySTL");
+    const char* text = "HackySTL";
+
+    printf("%d\n", compile_time == fast_hash<const char*>::get_hash(text));
+    printf(
+        "%d\n", fast_hash<hsd::string>::get_hash("some longer key") ==
+        fast_hash<hsd::string_view>::get_hash("some longer key")
+    );
+
+    // sequential keys are scattered
+    for (hsd::i32 i = 0; i < 4; i++)
+        printf("%zx\n", fast_hash<hsd::i32>::get_hash(i));
+
+    // and it can be used by the hash containers
+    hsd::unordered_map<hsd::string, hsd::i32, fast_hash<hsd::string>> map;
+    map.emplace("first", 1);
+    map.emplace("second", 2);
+
+    printf("%d %d\n", map["first"], map["second"]);
+}
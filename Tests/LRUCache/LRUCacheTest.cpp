@@ -0,0 +1,66 @@
+#include <LRUCache.hpp>
+#include <String.hpp>
+#include <stdio.h>
+
+int main()
+{
+    {
+        hsd::lru_cache<hsd::i32, hsd::i32> cache{3};
+        cache.on_evict([](const hsd::i32& key, hsd::i32& value) {
+            printf("evicted %d -> %d\n", key, value);
+        });
+
+        cache.put(1, 10);
+        cache.put(2, 20);
+        cache.put(3, 30);
+        cache.get(1).unwrap(); // 2 is now the least recently used
+        cache.put(4, 40);
+        cache.put(3, 33);
+        cache.put(5, 50);
+
+        printf(
+            "%zu %d %d %d %d\n", cache.size(), cache.contains(2),
+            cache.contains(1), cache.get(3).unwrap(), cache.get(2).is_ok()
+        );
+
+        printf("hits: %zu, misses: %zu\n", cache.hits(), cache.misses());
+        puts("============");
+    }
+
+    {
+        hsd::lru_cache<hsd::string, hsd::i32, hsd::hash<hsd::usize, hsd::string>,
+            hsd::cache_policy::clock> cache{4};
+
+        for (hsd::i32 i = 0; i < 4; i++)
+            cache.put(hsd::to_string(i), i);
+
+        // 0 and 1 get a second chance, 2 is the first victim
+        const auto& readers = cache;
+        readers.get("0").unwrap();
+        readers.get("1").unwrap();
+        cache.try_emplace("4", 4);
+        cache.try_emplace("5", 5);
+        cache.erase("1");
+
+        for (hsd::i32 i = 0; i < 6; i++)
+            printf("%d", cache.contains(hsd::to_string(i)));
+
+        printf("\nsize: %zu, ratio: %.2f\n", cache.size(), cache.hit_ratio());
+        puts("============");
+    }
+
+    {
+        hsd::lru_cache<hsd::i32, hsd::i32> cache{2};
+        cache.put(1, 10);
+        auto moved = hsd::move(cache);
+
+        // the moved-from cache finds nothing and can still be cleared
+        printf(
+            "%d %d %d %d ", cache.contains(1), cache.get(1).is_ok(),
+            cache.peek(1).is_ok(), cache.erase(1)
+        );
+
+        cache.clear();
+        printf("%zu %zu %d\n", cache.size(), cache.capacity(), moved.get(1).unwrap());
+    }
+}
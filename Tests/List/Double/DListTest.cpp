@@ -13,6 +13,16 @@ struct S
     {}
 };
 
+struct Task
+    : hsd::list_hook<>
+{
+    int id;
+
+    Task(int i)
+        : id{i}
+    {}
+};
+
 int main()
 {
     hsd::list<S> ls;
@@ -53,4 +63,50 @@ int main()
             iter++;
         }
     }
-}
\ No newline at end of file
+
+    puts("=========");
+
+    {
+        // freed nodes go back to the list's own pool
+        hsd::list<int> nums;
+
+        for (int round = 0; round < 3; round++)
+        {
+            for (int i = 0; i < 1000; i++)
+                nums.push_back(i);
+
+            while (nums.size() > 1)
+                nums.pop_front();
+
+            nums.pop_back();
+        }
+
+        nums = {{1, 2, 3}};
+        hsd::list<int> copy = nums;
+        hsd::list<int> moved = hsd::move(nums);
+
+        for (auto it = copy.rbegin(); it != copy.rend(); it--)
+            printf("%d ", *it);
+
+        printf("| %zu %zu\n", moved.size(), nums.size());
+    }
+
+    puts("=========");
+
+    {
+        Task tasks[] = {1, 2, 3, 4, 5};
+        hsd::intrusive_list<Task> queue;
+
+        for (auto& task : tasks)
+            queue.push_back(task);
+
+        queue.erase(tasks[2]);
+        queue.push_front(tasks[2]);
+        queue.pop_back();
+
+        for (auto& task : queue)
+            printf("%d ", task.id);
+
+        printf("| %zu %d %d\n", queue.size(), tasks[4].is_linked(), tasks[0].is_linked());
+    }
+}
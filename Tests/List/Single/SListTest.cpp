@@ -13,6 +13,16 @@ struct S
     {}
 };
 
+struct Task
+    : hsd::forward_list_hook<>
+{
+    int id;
+
+    Task(int i)
+        : id{i}
+    {}
+};
+
 int main()
 {
     hsd::forward_list<S> ls;
@@ -47,4 +57,37 @@ int main()
             iter++;
         }
     }
-}
\ No newline at end of file
+
+    puts("==========");
+
+    {
+        hsd::forward_list<int> nums = {{1, 2, 3, 4}};
+        nums.erase(++nums.begin()).unwrap();
+        nums.push_back(5);
+
+        for (auto it : nums)
+            printf("%d ", it);
+
+        printf("| %zu %d\n", nums.size(), nums.back());
+    }
+
+    puts("==========");
+
+    {
+        Task tasks[] = {1, 2, 3, 4, 5};
+        hsd::intrusive_forward_list<Task> stack;
+
+        for (auto& task : tasks)
+            stack.push_front(task);
+
+        stack.erase(tasks[2]).unwrap();
+        stack.pop_front();
+        stack.insert_after(stack.before_begin(), tasks[2]);
+        stack.erase_after(stack.begin());
+
+        for (auto& task : stack)
+            printf("%d ", task.id);
+
+        printf("| %zu %d\n", stack.size(), stack.back().id);
+    }
+}
@@ -0,0 +1,98 @@
+#include <PriorityQueue.hpp>
+#include <String.hpp>
+#include <stdio.h>
+
+int main()
+{
+    {
+        hsd::priority_queue<hsd::i32> queue;
+        hsd::i32 values[] = {5, 1, 9, 3, 7, 2, 8};
+        queue.assign(values, values + 7);
+        queue.push(0);
+        queue.push(6);
+
+        while (!queue.empty())
+            printf("%d ", queue.take().unwrap());
+
+        puts("\n============");
+    }
+
+    {
+        hsd::priority_queue<hsd::string, hsd::greater<hsd::string>> queue;
+        queue.emplace("apple");
+        queue.emplace("cherry");
+        queue.emplace("banana");
+
+        // rebuilding the heap from its own elements
+        queue.assign(queue.begin(), queue.end());
+
+        for (; !queue.empty(); queue.pop())
+            printf("%s ", queue.top().c_str());
+
+        puts("\n============");
+    }
+
+    {
+        // shortest paths on a small graph, with decrease_key
+        constexpr hsd::usize nodes = 5;
+        constexpr hsd::i32 inf = 1 << 30;
+        hsd::i32 weights[nodes][nodes] = {
+            {0, 4, 1, 0, 0},
+            {4, 0, 2, 5, 0},
+            {1, 2, 0, 8, 10},
+            {0, 5, 8, 0, 2},
+            {0, 0, 10, 2, 0}
+        };
+
+        struct item
+        {
+            hsd::i32 dist;
+            hsd::usize node;
+
+            bool operator<(const item& rhs) const
+            {
+                return dist < rhs.dist;
+            }
+        };
+
+        hsd::indexed_priority_queue<item> queue;
+        hsd::usize handles[nodes];
+        hsd::i32 dist[nodes];
+
+        for (hsd::usize i = 0; i < nodes; i++)
+        {
+            dist[i] = i == 0 ? 0 : inf;
+            handles[i] = queue.push({dist[i], i});
+        }
+
+        while (!queue.empty())
+        {
+            auto [d, node] = queue.take().unwrap();
+
+            for (hsd::usize next = 0; next < nodes; next++)
+            {
+                if (weights[node][next] != 0 && d + weights[node][next] < dist[next])
+                {
+                    dist[next] = d + weights[node][next];
+                    queue.decrease_key(handles[next], {dist[next], next}).unwrap();
+                }
+            }
+        }
+
+        for (hsd::usize i = 0; i < nodes; i++)
+            printf("%zu: %d\n", i, dist[i]);
+
+        puts("============");
+    }
+
+    {
+        hsd::indexed_priority_queue<hsd::i32> queue;
+        auto a = queue.push(10);
+        auto b = queue.push(20);
+        queue.push(30);
+        queue.erase(a).unwrap();
+        queue.update(b, 40).unwrap();
+        printf("%d %d %d\n", queue.top(), queue.get(b).unwrap(), queue.contains(a));
+        printf("handle reused: %d\n", queue.push(5) == a);
+    }
+}
@@ -0,0 +1,83 @@
+#include <RingBuffer.hpp>
+#include <String.hpp>
+#include <stdio.h>
+
+int main()
+{
+    {
+        hsd::ring_buffer<hsd::i32, 3> ring;
+        printf("capacity: %zu\n", ring.capacity());
+
+        for (hsd::i32 i = 0; i < 6; i++)
+            printf("push %d: %d\n", i, ring.push_back(i));
+
+        ring.pop_front();
+        ring.push_front(-1);
+
+        for (auto val : ring)
+            printf("%d ", val);
+
+        puts("\n============");
+    }
+
+    {
+        // keeps the last 4 samples
+        hsd::ring_buffer<hsd::string, 4, hsd::ring_policy::overwrite> history;
+
+        for (hsd::i32 i = 0; i < 10; i++)
+            history.emplace_back(hsd::to_string(i));
+
+        for (auto& str : history)
+            printf("%s ", str.c_str());
+
+        auto copy = history;
+        printf("\n%zu %s %s\n", copy.size(), copy.front().c_str(), copy.back().c_str());
+        puts("============");
+    }
+
+    {
+        hsd::ring_buffer<char> bytes{10};
+        printf("capacity: %zu\n", bytes.capacity());
+
+        for (char c = 'a'; c < 'm'; c++)
+            bytes.push_back(c);
+
+        bytes.consume_front(10);
+
+        // simulate a read straight into the free space
+        auto [free_first, free_second] = bytes.free_segments();
+        char next = 'm';
+
+        for (auto& c : free_first)
+            c = next++;
+
+        for (auto& c : free_second)
+            c = next++;
+
+        bytes.commit_back(free_first.size() + free_second.size());
+        auto [first, second] = bytes.segments();
+        printf("%zu + %zu: ", first.size(), second.size());
+
+        for (auto c : first)
+            putchar(c);
+
+        for (auto c : second)
+            putchar(c);
+
+        puts("");
+    }
+
+    puts("============");
+
+    {
+        // a moved-from buffer has no storage, pushing drops the value
+        hsd::ring_buffer<hsd::string, hsd::ring_detail::dynamic_capacity,
+            hsd::ring_policy::overwrite> lines{2};
+
+        lines.push_back("first");
+        auto moved = hsd::move(lines);
+
+        printf("%d %d ", lines.push_back("second"), lines.push_front("third"));
+        printf("%zu %zu %s\n", lines.size(), moved.size(), moved.front().c_str());
+    }
+}
@@ -0,0 +1,64 @@
+#include <SlotMap.hpp>
+#include <String.hpp>
+#include <stdio.h>
+
+struct Entity
+{
+    hsd::string name;
+    hsd::i32 health;
+};
+
+int main()
+{
+    hsd::slot_map<Entity> entities;
+    auto _orc = entities.emplace("orc", 30);
+    auto _elf = entities.emplace("elf", 20);
+    auto _imp = entities.emplace("imp", 5);
+
+    entities[_elf].health -= 5;
+    entities.erase(_orc).unwrap();
+
+    // the last value was moved into the hole, its key still works
+    printf("%s %d\n", entities[_imp].name.c_str(), entities[_imp].health);
+    printf("%d %d\n", entities.contains(_orc), entities.erase(_orc).is_ok());
+
+    // the freed slot is reused with a new generation
+    auto _troll = entities.emplace("troll", 80);
+    printf("%u %u %u\n", _troll.index, _orc.index, _troll.generation != _orc.generation);
+    printf("%d\n", entities.find(_orc) == nullptr);
+
+    for (auto& entity : entities)
+        printf("%s:%d ", entity.name.c_str(), entity.health);
+
+    puts("");
+
+    for (hsd::usize _pos = 0; _pos < entities.size(); _pos++)
+        printf("%d ", entities.key_at(_pos) == entities.key_at(_pos) && entities.contains(entities.key_at(_pos)));
+
+    puts("");
+
+    auto _key = hsd::slot_key::from_u64(_troll.to_u64());
+    printf("%d %d\n", entities.get(_key).unwrap().health, entities.get(hsd::slot_key{}).is_ok());
+
+    entities.clear();
+    printf("%zu %d %d\n", entities.size(), entities.contains(_elf), entities.contains(_troll));
+
+    {
+        // many erases in the middle stay O(1)
+        hsd::slot_map<hsd::u64> numbers;
+        hsd::vector<hsd::slot_key> keys;
+
+        for (hsd::u64 _index = 0; _index < 10000; _index++)
+            keys.push_back(numbers.insert(_index));
+
+        for (hsd::usize _index = 0; _index < keys.size(); _index += 2)
+            numbers.erase(keys[_index]).unwrap();
+
+        hsd::u64 _sum = 0;
+
+        for (hsd::usize _index = 1; _index < keys.size(); _index += 2)
+            _sum += numbers[keys[_index]];
+
+        printf("%zu %llu\n", numbers.size(), _sum);
+    }
+}
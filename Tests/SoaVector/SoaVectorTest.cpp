@@ -0,0 +1,83 @@
+#include <SoaVector.hpp>
+#include <String.hpp>
+#include <TrackingAllocator.hpp>
+#include <stdio.h>
+
+int main()
+{
+    {
+        // position, velocity and name of some particles
+        hsd::soa_vector<hsd::f32, hsd::f32, hsd::string> particles;
+
+        for (hsd::i32 i = 0; i < 100; i++)
+            particles.emplace_back(static_cast<hsd::f32>(i), 0.5f, hsd::to_string(i));
+
+        // the hot loop only walks the first two columns
+        auto positions = particles.column<0>();
+        auto velocities = particles.column<1>();
+        auto vel = velocities.begin();
+
+        for (auto& pos : positions)
+            pos += *vel++;
+
+        printf(
+            "aligned: %d %d %d\n",
+            reinterpret_cast<hsd::usize>(particles.column_data<0>()) % 64 == 0,
+            reinterpret_cast<hsd::usize>(particles.column_data<1>()) % 64 == 0,
+            reinterpret_cast<hsd::usize>(particles.column_data<2>()) % 64 == 0
+        );
+
+        particles.erase(0).unwrap();
+        particles.swap_erase(0).unwrap();
+        auto row = particles[0];
+        printf("%zu %.1f %s\n", particles.size(), row.get<0>(), row.get<2>().c_str());
+
+        row = hsd::tuple<hsd::f32, hsd::f32, hsd::string>{1.f, 2.f, hsd::string{"first"}};
+        hsd::tuple<hsd::f32, hsd::f32, hsd::string> copy = particles[0];
+        printf("%.1f %.1f %s\n", copy.get<0>(), copy.get<1>(), copy.get<2>().c_str());
+        puts("============");
+    }
+
+    {
+        hsd::soa_vector<hsd::i32, hsd::u8> table;
+        table.push_back({1, hsd::u8{'a'}});
+        table.push_back({2, hsd::u8{'b'}});
+        table.push_back({3, hsd::u8{'c'}});
+
+        auto table2 = table;
+        table2.pop_back();
+
+        for (auto row : table2)
+            printf("%d %c\n", row.get<0>(), row.get<1>());
+
+        printf("at(5) is ok: %d\n", table.at(5).is_ok());
+        puts("============");
+    }
+
+    {
+        // a moved block is freed by the allocator it came from, the
+        // numbers of each tag end at zero only if every block is
+        static hsd::alloc_tag first_tag{"first"};
+        static hsd::alloc_tag second_tag{"second"};
+
+        {
+            using table_type = hsd::basic_soa_vector<hsd::tracking_allocator, hsd::i32, hsd::f64>;
+            table_type first{hsd::tracking_allocator<hsd::uchar>{first_tag}};
+            table_type second{hsd::tracking_allocator<hsd::uchar>{second_tag}};
+
+            first.push_back({1, 1.5});
+
+            for (hsd::i32 _index = 0; _index < 100; _index++)
+                second.push_back({_index, _index * 0.5});
+
+            first = hsd::move(second);
+
+            printf("%zu %d %zu\n", first.size(), first[99].get<0>(), second.size());
+        }
+
+        printf(
+            "%lld %lld\n", first_tag.stats().current_bytes,
+            second_tag.stats().current_bytes
+        );
+    }
+}
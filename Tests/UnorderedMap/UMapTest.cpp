@@ -1,5 +1,6 @@
 #include <UnorderedMap.hpp>
 #include <HeapArray.hpp>
+#include <String.hpp>
 #include <stdio.h>
 
 static auto check_erase()
@@ -25,12 +26,37 @@ static auto check_erase()
     return map;
 }
 
+constexpr auto make_static_umap()
+{
+    hsd::static_umap<const char*, hsd::i32, 10> map;
+    map.emplace("add", 1);
+    map.emplace("sub", 2);
+    map.emplace("mul", 3);
+    map.emplace("div", 4);
+    map.emplace("mod", 5);
+
+    return map;
+}
+
 int main()
 {
+    {
+        // the perfect hash is built at compile time
+        constexpr auto opcodes = make_static_umap();
+        static_assert(opcodes["mul"] == 3 && !opcodes.contains("pow"));
+
+        for (auto& [name, code] : opcodes)
+            printf("%s %d\n", name, code);
+
+        puts("============");
+    }
+
     hsd::heap_array<hsd::uchar, 4096> buf{};
     hsd::buffered_umap<hsd::i32, hsd::i32> map{{buf.data(), buf.size()}};
 
-    check_erase();
+    auto erased = check_erase();
+    puts("============");
+    printf("%d %d\n", erased[361], erased.at(144).is_ok());
     puts("============");
 
     for (hsd::i32 i = 1; i <= 14; i++)
@@ -41,4 +67,30 @@ int main()
 
     for (auto& _it : map)
         printf("%d\n", _it.first);
+
+    puts("============");
+    hsd::unordered_map<hsd::u64, hsd::u64> presized;
+    presized.max_load_factor(1.f);
+    presized.reserve(1000);
+    hsd::usize buckets = presized.bucket_count();
+
+    for (hsd::u64 i = 0; i < 1000; i++)
+        presized.emplace(i, i * i);
+
+    printf("%zu %d %llu\n", buckets, buckets == presized.bucket_count(), presized[999]);
+    presized.rehash(4096);
+    printf("%zu %llu\n", presized.bucket_count(), presized[999]);
+
+    puts("============");
+    // lookups by view or C string don't build a temporary string
+    hsd::unordered_map<hsd::string, hsd::i32> headers;
+    headers.try_emplace("Host", 1);
+    headers.try_emplace(hsd::string_view{"Accept"}, 2);
+    headers.emplace(hsd::string{"Accept-Encoding"}, 3);
+    auto [iter, inserted] = headers.try_emplace("Host", 42);
+
+    printf(
+        "%d %d %d %d %d\n", headers.at(hsd::string_view{"Accept"}).unwrap(), 
+        headers["Accept-Encoding"], iter->second, inserted, headers.contains("Acc")
+    );
 }
\ No newline at end of file
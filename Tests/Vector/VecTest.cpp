@@ -1,4 +1,6 @@
 #include <Vector.hpp>
+#include <String.hpp>
+#include <UniquePtr.hpp>
 #include <cstdio>
 #include <iterator>
 
@@ -108,7 +110,7 @@ int main()
     {
         // let's test the buffred vector
         hsd::uchar buf[1000]{};
-        hsd::buffered_allocator<hsd::uchar> alloc = {buf, 200};
+        hsd::size_class_allocator<hsd::uchar> alloc = {buf, 200};
         hsd::buffered_vector<hsd::i32> vec{alloc};
         hsd::buffered_vector<hsd::i32> vec2{alloc};
         vec.push_back(1);
@@ -195,4 +197,128 @@ int main()
             auto verb3 = hsd::move(verb); // move
         }
     }
-}
\ No newline at end of file
+
+    std::puts("==========");
+    {
+        hsd::small_vector<hsd::i32, 4> sv = {{1, 2, 3}};
+        std::printf("inline: %d, capacity: %zu\n", sv.is_inline(), sv.capacity());
+
+        for (hsd::i32 i = 4; i <= 8; i++)
+            sv.push_back(i);
+
+        std::printf("inline: %d, size: %zu\n", sv.is_inline(), sv.size());
+        sv.erase_for(sv.begin() + 1, sv.begin() + 6).unwrap();
+
+        for (auto val : sv)
+            std::printf("%d\n", val);
+
+        sv.shrink_to_fit();
+        std::printf("inline: %d, capacity: %zu\n", sv.is_inline(), sv.capacity());
+    }
+
+    std::puts("==========");
+    {
+        std::puts("--- init 2");
+        hsd::small_vector<verbose, 3> verb(2);
+        std::puts("--- move inline");
+        auto verb2 = hsd::move(verb);
+        std::puts("--- spill");
+        verb2.emplace_back();
+        verb2.emplace_back();
+        std::puts("--- move heap");
+        auto verb3 = hsd::move(verb2);
+        std::printf("%zu %zu\n", verb2.size(), verb3.size());
+    }
+
+    std::puts("==========");
+    {
+        static_assert(hsd::is_trivially_relocatable<hsd::i32>::value);
+        static_assert(hsd::is_trivially_relocatable<hsd::string>::value);
+        static_assert(hsd::is_trivially_relocatable<hsd::unique_ptr<hsd::i32>>::value);
+        static_assert(!hsd::is_trivially_relocatable<verbose>::value);
+
+        // strings are moved around with memcpy while growing
+        hsd::vector<hsd::string> strs;
+
+        for (hsd::i32 i = 0; i < 100; i++)
+            strs.emplace_back(hsd::to_string(i));
+
+        strs.erase_for(strs.begin() + 1, strs.begin() + 98).unwrap();
+
+        for (auto& str : strs)
+            std::printf("%s\n", str.c_str());
+
+        hsd::vector<hsd::i32> ints;
+
+        for (hsd::i32 i = 0; i < 100000; i++)
+            ints.push_back(i);
+
+        auto ints2 = ints;
+        ints2.erase(ints2.begin()).unwrap();
+        ints = ints2;
+        std::printf("%zu %d %d\n", ints.size(), ints.front(), ints.back());
+    }
+
+    std::puts("==========");
+    {
+        // the last block of the buffer grows in place
+        hsd::uchar buf[1000]{};
+        hsd::size_class_allocator<hsd::uchar> alloc = {buf, 1000};
+        hsd::buffered_vector<hsd::i32> vec{alloc};
+        vec.push_back(1);
+        auto* first = vec.data();
+
+        for (hsd::i32 i = 2; i <= 100; i++)
+            vec.push_back(i);
+
+        std::printf("in place: %d, sum of ends: %d\n", first == vec.data(), vec.front() + vec.back());
+    }
+
+    std::puts("==========");
+    {
+        hsd::vector<hsd::i32> ints = {{1, 2, 6}};
+        hsd::i32 middle[] = {3, 4, 5};
+        ints.insert(ints.begin() + 2, middle, middle + 3).unwrap();
+
+        hsd::vector<hsd::i32> tail = {{7, 8}};
+        ints.append(tail.to_span());
+
+        for (auto val : ints)
+            std::printf("%d ", val);
+
+        std::puts("");
+        hsd::vector<hsd::string> strs = {{hsd::string{"a"}, hsd::string{"d"}}};
+        const char* words[] = {"b", "c"};
+        strs.insert(strs.begin() + 1, words, words + 2).unwrap();
+        std::printf("%s%s%s%s\n", strs[0].c_str(), strs[1].c_str(), strs[2].c_str(), strs[3].c_str());
+
+        ints.assign(middle, middle + 3);
+        std::printf("%zu %d\n", ints.size(), ints.back());
+
+        hsd::vector<hsd::uchar> buffer;
+        buffer.resize_for_overwrite(1 << 20);
+        buffer[(1 << 20) - 1] = 42;
+        std::printf("%zu %d\n", buffer.size(), buffer.back());
+    }
+
+    std::puts("==========");
+    {
+        // the source ranges are the vector's own elements
+        hsd::vector<hsd::string> strs = {{hsd::string{"a"}, hsd::string{"b"}}};
+        strs.insert(strs.begin(), strs.begin(), strs.end()).unwrap();
+        strs.append(strs.to_span());
+        strs.insert(strs.begin() + 1, strs.begin() + 6, strs.end()).unwrap();
+
+        for (auto& str : strs)
+            std::printf("%s", str.c_str());
+
+        std::puts("");
+        strs.assign(strs.begin() + 2, strs.begin() + 5);
+        strs.assign(strs.begin(), strs.end());
+
+        for (auto& str : strs)
+            std::printf("%s", str.c_str());
+
+        std::printf(" %zu\n", strs.size());
+    }
+}
@@ -4,9 +4,11 @@
 #include "Math.hpp"
 #include "StackArray.hpp"
 #include "IntegerSequence.hpp"
+#include "ThreadCache.hpp"
 
 #include <malloc.h>
 #include <string.h>
+#include <stddef.h>
 #include <new>
 
 namespace hsd
@@ -28,6 +30,35 @@ namespace hsd
                 return _err;
             }
         };
+
+        // Define HSD_USE_TL_CACHE to send `mallocator`, `allocator` and
+        // through them `basic_string` to the per thread caches
+        static inline void* raw_allocate(usize size)
+        {
+            #ifdef HSD_USE_TL_CACHE
+            return tl_cache_detail::allocate(size);
+            #else
+            return malloc(size);
+            #endif
+        }
+
+        static inline void raw_deallocate(void* ptr)
+        {
+            #ifdef HSD_USE_TL_CACHE
+            tl_cache_detail::deallocate(ptr);
+            #else
+            free(ptr);
+            #endif
+        }
+
+        static inline void* raw_reallocate(void* ptr, usize size)
+        {
+            #ifdef HSD_USE_TL_CACHE
+            return tl_cache_detail::reallocate(ptr, size);
+            #else
+            return realloc(ptr, size);
+            #endif
+        }
     } // namespace allocator_detail
     
     struct mallocator
@@ -42,7 +73,7 @@ namespace hsd
         [[nodiscard]] static inline auto allocate_single(Args&&... args)
             -> Result< T*, allocator_detail::allocator_error >
         {
-            T* _result = static_cast<T*>(malloc(sizeof(T)));
+            T* _result = static_cast<T*>(allocator_detail::raw_allocate(sizeof(T)));
 
             if (_result == nullptr)
             {
@@ -65,7 +96,7 @@ namespace hsd
             }
             else
             {
-                T* _result = static_cast<T*>(malloc(sizeof(T) * size));
+                T* _result = static_cast<T*>(allocator_detail::raw_allocate(sizeof(T) * size));
 
                 if (_result == nullptr)
                 {
@@ -106,7 +137,7 @@ namespace hsd
             }
             else
             {
-                T* _result = static_cast<T*>(malloc(sizeof(T) * size));
+                T* _result = static_cast<T*>(allocator_detail::raw_allocate(sizeof(T) * size));
 
                 if (_result == nullptr)
                 {
@@ -140,7 +171,7 @@ namespace hsd
 
         static inline void deallocate(void* ptr)
         {
-            free(ptr);
+            allocator_detail::raw_deallocate(ptr);
         }
     };    
 
@@ -216,12 +247,12 @@ namespace hsd
                     {
                         _block_ptr->size = size * sizeof(T);
                         _block_ptr->in_use = true;
-                        return bit_cast<T*>(_block_ptr->data);
+                        return {bit_cast<T*>(_block_ptr->data), ok_value{}};
                     }
                     else if (_block_ptr->size >= size * sizeof(T))
                     {
                         _block_ptr->in_use = true;
-                        return bit_cast<T*>(_block_ptr->data);
+                        return {bit_cast<T*>(_block_ptr->data), ok_value{}};
                     }
                     else
                     {
@@ -234,7 +265,7 @@ namespace hsd
                         {
                             _block_back->size = _free_size;
                             _block_back->in_use = true;
-                            return bit_cast<T*>(_block_back->data);
+                            return {bit_cast<T*>(_block_back->data), ok_value{}};
                         }
                     }
                 }
@@ -278,6 +309,51 @@ namespace hsd
             return {};
         }
 
+        // Grows the block in place if it is big enough already or if it
+        // is the last one in the buffer, otherwise moves the bytes to a
+        // new block. Only meant for trivially relocatable types
+        [[nodiscard]] auto reallocate(T* ptr, usize old_size, usize new_size)
+            -> Result< T*, allocator_detail::allocator_error >
+        {
+            if (ptr == nullptr)
+                return allocate(new_size);
+
+            if (bit_cast<uchar*>(ptr) < _buf || bit_cast<uchar*>(ptr) >= _buf + _size)
+                return allocator_detail::allocator_error{"Pointer out of bounds"};
+
+            auto* _block_ptr = bit_cast<block*>(
+                bit_cast<uchar*>(ptr) - sizeof(block)
+            );
+
+            usize _new_bytes = new_size * sizeof(T);
+
+            if (_block_ptr->size >= _new_bytes)
+                return ptr;
+
+            auto* _next_ptr = bit_cast<block*>(_block_ptr->data + _block_ptr->size);
+
+            if (_next_ptr->size == 0 && !_next_ptr->in_use &&
+                _block_ptr->data + _new_bytes + sizeof(block) <= _buf + _size)
+            {
+                _block_ptr->size = static_cast<u32>(_new_bytes);
+                return ptr;
+            }
+
+            auto _result = allocate(new_size);
+
+            if (_result)
+            {
+                memcpy(
+                    static_cast<void*>(_result.unwrap()), static_cast<void*>(ptr),
+                    (old_size < new_size ? old_size : new_size) * sizeof(T)
+                );
+
+                deallocate(ptr, old_size).unwrap();
+            }
+
+            return _result;
+        }
+
         #ifndef NDEBUG
         void print_buffer() const
         {
@@ -299,12 +375,465 @@ namespace hsd
         #endif
     };
 
+    namespace size_class_detail
+    {
+        static constexpr usize alignment = 16;
+        static constexpr usize min_block = 16;
+        static constexpr usize max_small = 512;
+        static constexpr usize small_classes = 16;
+        static constexpr usize large_bins = 8;
+        static constexpr u32 in_use = 1;
+
+        // Every block starts with this, the payload follows it. The
+        // size of the block before is what lets a freed block find
+        // its left neighbour, the boundary tag
+        struct block
+        {
+            u32 prev_size;
+            u32 size_flags;
+        };
+
+        // Kept in the payload of a free large block
+        struct free_links
+        {
+            u32 next;
+            u32 prev;
+        };
+
+        // Lives at the start of the buffer, so that every copy and
+        // rebind of the allocator shares it. Offsets are relative to
+        // the start of the buffer and 0 stands for none
+        struct control
+        {
+            u32 small_heads[small_classes];
+            u32 large_heads[large_bins];
+            u32 heap_begin;
+            u32 heap_end;
+        };
+
+        // Block size for a payload of `bytes`, header included
+        static constexpr usize block_size(usize bytes)
+        {
+            usize _size = (bytes + sizeof(block) + alignment - 1) & ~(alignment - 1);
+            return _size < min_block ? min_block : _size;
+        }
+
+        // 16 byte steps up to 128, then four classes per doubling up to 512
+        static constexpr usize class_index(usize size)
+        {
+            if (size <= 128)
+                return size / 16 - 1;
+            else if (size <= 256)
+                return 8 + (size - 129) / 32;
+            else
+                return 12 + (size - 257) / 64;
+        }
+
+        static constexpr usize class_size(usize index)
+        {
+            if (index < 8)
+                return (index + 1) * 16;
+            else if (index < 12)
+                return 160 + (index - 8) * 32;
+            else
+                return 320 + (index - 12) * 64;
+        }
+
+        // One bin per power of two from 1 KiB, the first one takes
+        // everything smaller and the last one everything bigger
+        static constexpr usize bin_index(usize size)
+        {
+            usize _bin = 0;
+
+            for (size >>= 10; size != 0 && _bin < large_bins - 1; size >>= 1)
+                _bin++;
+
+            return _bin;
+        }
+    } // namespace size_class_detail
+
+    // Fixed buffer allocator with segregated free lists. Requests up to
+    // 512 bytes are rounded to a size class and served from the list of
+    // that class in O(1), bigger ones come from power of two bins of
+    // free blocks that are merged with their free neighbours when
+    // released. The bookkeeping is written at the start of the buffer
+    // by the constructor, so build one allocator per buffer and copy it
+    template <typename T>
+    class size_class_allocator
+    {
+    private:
+        using block = size_class_detail::block;
+        using control = size_class_detail::control;
+
+        uchar* _buf = nullptr;
+
+        template <typename U>
+        friend class size_class_allocator;
+
+        inline control& _control() const
+        {
+            return *bit_cast<control*>(_buf);
+        }
+
+        inline block* _block_at(u32 offset) const
+        {
+            return bit_cast<block*>(_buf + offset);
+        }
+
+        inline u32 _offset_of(const block* blk) const
+        {
+            return static_cast<u32>(bit_cast<const uchar*>(blk) - _buf);
+        }
+
+        static inline usize _size_of(const block* blk)
+        {
+            return blk->size_flags & ~size_class_detail::in_use;
+        }
+
+        static inline bool _is_used(const block* blk)
+        {
+            return (blk->size_flags & size_class_detail::in_use) != 0;
+        }
+
+        static inline block* _next_of(block* blk)
+        {
+            return bit_cast<block*>(bit_cast<uchar*>(blk) + _size_of(blk));
+        }
+
+        static inline size_class_detail::free_links* _links(block* blk)
+        {
+            return bit_cast<size_class_detail::free_links*>(blk + 1);
+        }
+
+        static inline T* _payload(block* blk)
+        {
+            return bit_cast<T*>(blk + 1);
+        }
+
+        // Also keeps the boundary tag of the next block up to date
+        static inline void _set_size(block* blk, usize size, bool used)
+        {
+            blk->size_flags = static_cast<u32>(size) | (used ? size_class_detail::in_use : 0);
+            _next_of(blk)->prev_size = static_cast<u32>(size);
+        }
+
+        inline bool _owns(const void* ptr) const
+        {
+            auto* _ptr = static_cast<const uchar*>(ptr);
+
+            return _ptr >= _buf + _control().heap_begin + sizeof(block) &&
+                _ptr < _buf + _control().heap_end;
+        }
+
+        inline void _push_large(block* blk)
+        {
+            u32& _head = _control().large_heads[size_class_detail::bin_index(_size_of(blk))];
+            u32 _offset = _offset_of(blk);
+
+            _links(blk)->next = _head;
+            _links(blk)->prev = 0;
+
+            if (_head != 0)
+                _links(_block_at(_head))->prev = _offset;
+
+            _head = _offset;
+        }
+
+        inline void _unlink_large(block* blk)
+        {
+            auto* _blk_links = _links(blk);
+
+            if (_blk_links->prev != 0)
+                _links(_block_at(_blk_links->prev))->next = _blk_links->next;
+            else
+                _control().large_heads[size_class_detail::bin_index(_size_of(blk))] = _blk_links->next;
+
+            if (_blk_links->next != 0)
+                _links(_block_at(_blk_links->next))->prev = _blk_links->prev;
+        }
+
+        // Marks `blk` as used with `size` bytes, the rest of it goes
+        // back to the bins if it can hold a block of its own
+        inline void _split(block* blk, usize total, usize size)
+        {
+            if (total - size >= size_class_detail::min_block)
+            {
+                _set_size(blk, size, true);
+                block* _rest = _next_of(blk);
+                _set_size(_rest, total - size, false);
+                _push_large(_rest);
+            }
+            else
+            {
+                _set_size(blk, total, true);
+            }
+        }
+
+        // First fit in the bin of `size`, any block of a bigger bin
+        // is big enough so those only look at the head
+        inline block* _take_large(usize size)
+        {
+            usize _bin = size_class_detail::bin_index(size);
+            u32 _offset = _control().large_heads[_bin];
+
+            while (_offset != 0 && _size_of(_block_at(_offset)) < size)
+                _offset = _links(_block_at(_offset))->next;
+
+            for (_bin++; _offset == 0 && _bin < size_class_detail::large_bins; _bin++)
+                _offset = _control().large_heads[_bin];
+
+            if (_offset == 0)
+                return nullptr;
+
+            block* _blk = _block_at(_offset);
+            _unlink_large(_blk);
+            _split(_blk, _size_of(_blk), size);
+            return _blk;
+        }
+
+        // Hands the blocks cached in the class lists back to the bins,
+        // only done when a bin search comes up empty
+        inline bool _reclaim_small()
+        {
+            bool _reclaimed = false;
+
+            for (u32& _head : _control().small_heads)
+            {
+                while (_head != 0)
+                {
+                    block* _blk = _block_at(_head);
+                    _head = _links(_blk)->next;
+                    _free_large(_blk);
+                    _reclaimed = true;
+                }
+            }
+
+            return _reclaimed;
+        }
+
+        inline void _free_large(block* blk)
+        {
+            usize _size = _size_of(blk);
+            block* _next = _next_of(blk);
+
+            if (!_is_used(_next))
+            {
+                _unlink_large(_next);
+                _size += _size_of(_next);
+            }
+
+            if (blk->prev_size != 0)
+            {
+                auto* _prev = bit_cast<block*>(bit_cast<uchar*>(blk) - blk->prev_size);
+
+                if (!_is_used(_prev))
+                {
+                    _unlink_large(_prev);
+                    _size += _size_of(_prev);
+                    blk = _prev;
+                }
+            }
+
+            _set_size(blk, _size, false);
+            _push_large(blk);
+        }
+
+        static constexpr bool _valid_length(usize size)
+        {
+            return size <= (limits<u32>::max / 2) / sizeof(T);
+        }
+
+    public:
+        using pointer_type = T*;
+        using value_type = T;
+
+        inline size_class_allocator(uchar* buf, usize size)
+        {
+            using namespace size_class_detail;
+
+            usize _skip = (alignment - bit_cast<usize>(buf) % alignment) % alignment;
+            usize _heap_begin = ((sizeof(control) + sizeof(block) + alignment - 1) 
+                & ~(alignment - 1)) - sizeof(block);
+
+            if (size < _skip + _heap_begin + sizeof(block))
+                return;
+
+            _buf = buf + _skip;
+            usize _usable = size - _skip;
+
+            if (_usable > limits<u32>::max)
+                _usable = limits<u32>::max;
+
+            // the heap ends with a used block of size 0, so that the
+            // last real block always has a neighbour to look at
+            usize _heap_end = _heap_begin + 
+                ((_usable - sizeof(block) - _heap_begin) & ~(alignment - 1));
+
+            control& _ctrl = _control();
+            _ctrl = control{};
+            _ctrl.heap_begin = static_cast<u32>(_heap_begin);
+            _ctrl.heap_end = static_cast<u32>(_heap_end);
+
+            block* _sentinel = _block_at(_ctrl.heap_end);
+            _sentinel->size_flags = in_use;
+            _sentinel->prev_size = 0;
+
+            if (_heap_end != _heap_begin)
+            {
+                block* _first = _block_at(_ctrl.heap_begin);
+                _first->prev_size = 0;
+                _set_size(_first, _heap_end - _heap_begin, false);
+                _push_large(_first);
+            }
+        }
+
+        template <typename U>
+        inline size_class_allocator(const size_class_allocator<U>& other)
+            : _buf{other._buf}
+        {}
+
+        template <typename U>
+        inline size_class_allocator& operator=(const size_class_allocator<U>& rhs)
+        {
+            _buf = rhs._buf;
+            return *this;
+        }
+
+        template <typename... Args>
+        static inline void construct_at(T* ptr, Args&&... args)
+        {
+            new (ptr) T{forward<Args>(args)...};
+        }
+
+        [[nodiscard]] inline auto allocate(usize size)
+            -> Result< T*, allocator_detail::allocator_error >
+        {
+            if constexpr (alignof(T) > size_class_detail::alignment)
+                return allocator_detail::allocator_error{"Alignment is not supported"};
+
+            if (!_valid_length(size))
+                return allocator_detail::allocator_error{"Bad length for allocation"};
+
+            if (_buf == nullptr)
+                return allocator_detail::allocator_error{"Insufficient memory"};
+
+            usize _size = size_class_detail::block_size(size * sizeof(T));
+
+            if (_size <= size_class_detail::max_small)
+            {
+                usize _index = size_class_detail::class_index(_size);
+                u32& _head = _control().small_heads[_index];
+
+                if (_head != 0)
+                {
+                    block* _blk = _block_at(_head);
+                    _head = _links(_blk)->next;
+                    return {_payload(_blk), ok_value{}};
+                }
+
+                _size = size_class_detail::class_size(_index);
+            }
+
+            block* _blk = _take_large(_size);
+
+            if (_blk == nullptr && _reclaim_small())
+                _blk = _take_large(_size);
+
+            if (_blk == nullptr)
+                return allocator_detail::allocator_error{"Insufficient memory"};
+
+            return {_payload(_blk), ok_value{}};
+        }
+
+        // Blocks that have the size of a class go to its list and stay
+        // marked as used, the others are merged with their neighbours
+        inline auto deallocate(T* ptr, usize)
+            -> Result< void, allocator_detail::allocator_error >
+        {
+            if (ptr == nullptr)
+                return {};
+
+            if (_buf == nullptr || !_owns(ptr))
+                return allocator_detail::allocator_error{"Pointer out of bounds"};
+
+            block* _blk = bit_cast<block*>(ptr) - 1;
+            usize _size = _size_of(_blk);
+
+            if (_size <= size_class_detail::max_small &&
+                size_class_detail::class_size(size_class_detail::class_index(_size)) == _size)
+            {
+                u32& _head = _control().small_heads[size_class_detail::class_index(_size)];
+                _links(_blk)->next = _head;
+                _head = _offset_of(_blk);
+            }
+            else
+            {
+                _free_large(_blk);
+            }
+
+            return {};
+        }
+
+        // Grows the block into a free neighbour when there is one big
+        // enough, otherwise moves the bytes to a new block. Only meant
+        // for trivially relocatable types
+        [[nodiscard]] inline auto reallocate(T* ptr, usize old_size, usize new_size)
+            -> Result< T*, allocator_detail::allocator_error >
+        {
+            if (ptr == nullptr)
+                return allocate(new_size);
+
+            if (!_valid_length(new_size))
+                return allocator_detail::allocator_error{"Bad length for allocation"};
+
+            if (_buf == nullptr || !_owns(ptr))
+                return allocator_detail::allocator_error{"Pointer out of bounds"};
+
+            block* _blk = bit_cast<block*>(ptr) - 1;
+            usize _size = size_class_detail::block_size(new_size * sizeof(T));
+
+            if (_size_of(_blk) >= _size)
+                return {ptr, ok_value{}};
+
+            block* _next = _next_of(_blk);
+
+            if (!_is_used(_next) && _size_of(_blk) + _size_of(_next) >= _size)
+            {
+                _unlink_large(_next);
+                _split(_blk, _size_of(_blk) + _size_of(_next), _size);
+                return {ptr, ok_value{}};
+            }
+
+            auto _result = allocate(new_size);
+
+            if (_result)
+            {
+                memcpy(
+                    static_cast<void*>(_result.unwrap()), static_cast<void*>(ptr),
+                    (old_size < new_size ? old_size : new_size) * sizeof(T)
+                );
+
+                deallocate(ptr, old_size).unwrap();
+            }
+
+            return _result;
+        }
+    };
+
     template <typename T>
     class allocator
     {
     private:
         usize _type_size = sizeof(T);
         usize _alignment = alignof(T);
+
+        // malloc already gives this alignment, and unlike operator
+        // new its blocks can be grown in place with realloc
+        #ifdef __cpp_aligned_new
+        static constexpr bool _uses_malloc = alignof(T) <= alignof(max_align_t);
+        #else
+        static constexpr bool _uses_malloc = true;
+        #endif
         
         template <typename U>
         friend class allocator;
@@ -314,16 +843,15 @@ namespace hsd
         using value_type = T;
         inline allocator() = default;
 
+        // The size and alignment always describe `T`, so
+        // rebinding from another type must not copy them
         template <typename U = T>
-        inline allocator(const allocator<U>& other)
-            : _type_size{other._type_size}, _alignment{other._alignment}
+        inline allocator(const allocator<U>&)
         {}
 
         template <typename U = T>
-        inline allocator& operator=(const allocator<U>& rhs)
+        inline allocator& operator=(const allocator<U>&)
         {
-            _type_size = rhs._type_size;
-            _alignment = rhs._alignment;
             return *this;
         }
 
@@ -337,11 +865,20 @@ namespace hsd
             else
             {
                 #ifdef __cpp_aligned_new
-                T* _result = static_cast<pointer_type>(::operator new(
-                    size * _type_size, static_cast<std::align_val_t>(_alignment)
-                ));
+                T* _result = nullptr;
+
+                if constexpr (_uses_malloc)
+                {
+                    _result = static_cast<pointer_type>(allocator_detail::raw_allocate(size * _type_size));
+                }
+                else
+                {
+                    _result = static_cast<pointer_type>(::operator new(
+                        size * _type_size, static_cast<std::align_val_t>(_alignment)
+                    ));
+                }
                 #else
-                T* _result = static_cast<pointer_type>(::operator new(size * _type_size));
+                T* _result = static_cast<pointer_type>(allocator_detail::raw_allocate(size * _type_size));
                 #endif
 
                 if (_result == nullptr)
@@ -350,7 +887,7 @@ namespace hsd
                 }
                 else
                 {
-                    return _result;
+                    return {_result, ok_value{}};
                 }
             }
         }
@@ -364,16 +901,308 @@ namespace hsd
             }
             else
             {
-                #ifdef __cpp_sized_deallocation
-                ::operator delete(ptr, size * _type_size, static_cast<std::align_val_t>(_alignment));
+                #ifdef __cpp_aligned_new
+                if constexpr (_uses_malloc)
+                {
+                    allocator_detail::raw_deallocate(ptr);
+                }
+                else
+                {
+                    #ifdef __cpp_sized_deallocation
+                    ::operator delete(ptr, size * _type_size, static_cast<std::align_val_t>(_alignment));
+                    #else
+                    ::operator delete(ptr, static_cast<std::align_val_t>(_alignment));
+                    #endif
+                }
                 #else
-                ::operator delete(ptr, static_cast<std::align_val_t>(_alignment));
+                allocator_detail::raw_deallocate(ptr);
                 #endif
 
                 return {};
             }
         }
 
+        // Resizes a block returned by `allocate`, in place when possible.
+        // The bytes are carried over as they are, so this is only meant
+        // for trivially relocatable types
+        [[nodiscard]] inline auto reallocate(pointer_type ptr, usize old_size, usize new_size)
+            -> Result< T*, allocator_detail::allocator_error >
+        {
+            if (new_size > limits<usize>::max / sizeof(T))
+            {
+                return {allocator_detail::allocator_error{"Bad length for allocation"}, err_value{}};
+            }
+            else if constexpr (_uses_malloc)
+            {
+                T* _result = static_cast<pointer_type>(
+                    allocator_detail::raw_reallocate(static_cast<void*>(ptr), new_size * _type_size)
+                );
+
+                if (_result == nullptr)
+                    return {allocator_detail::allocator_error{"No space left in RAM"}, err_value{}};
+
+                return {_result, ok_value{}};
+            }
+            else
+            {
+                T* _result = allocate(new_size).unwrap();
+
+                if (ptr != nullptr)
+                {
+                    memcpy(
+                        static_cast<void*>(_result), static_cast<void*>(ptr),
+                        (old_size < new_size ? old_size : new_size) * _type_size
+                    );
+
+                    deallocate(ptr, old_size).unwrap();
+                }
+
+                return {_result, ok_value{}};
+            }
+        }
+
+        template <typename... Args>
+        static inline void construct_at(T* ptr, Args&&... args)
+        {
+            new (ptr) T{forward<Args>(args)...};
+        }
+    };
+
+    // Goes to the per thread caches of ThreadCache.hpp whether or not
+    // HSD_USE_TL_CACHE is defined, so it can be picked per container.
+    // Types aligned beyond `max_align_t` are left to `allocator`
+    template <typename T>
+    class tl_cache_allocator
+    {
+    private:
+        static constexpr bool _uses_cache = alignof(T) <= alignof(max_align_t);
+
+    public:
+        using pointer_type = T*;
+        using value_type = T;
+
+        inline tl_cache_allocator() = default;
+
+        template <typename U>
+        inline tl_cache_allocator(const tl_cache_allocator<U>&)
+        {}
+
+        template <typename U>
+        inline tl_cache_allocator& operator=(const tl_cache_allocator<U>&)
+        {
+            return *this;
+        }
+
+        [[nodiscard]] inline auto allocate(usize size)
+            -> Result< T*, allocator_detail::allocator_error >
+        {
+            if constexpr (!_uses_cache)
+                return allocator<T>{}.allocate(size);
+
+            if (size > limits<usize>::max / sizeof(T))
+                return allocator_detail::allocator_error{"Bad length for allocation"};
+
+            auto* _result = static_cast<T*>(tl_cache_detail::allocate(size * sizeof(T)));
+
+            if (_result == nullptr)
+                return allocator_detail::allocator_error{"No space left in RAM"};
+
+            return {_result, ok_value{}};
+        }
+
+        inline auto deallocate(pointer_type ptr, usize size)
+            -> Result< void, allocator_detail::allocator_error >
+        {
+            if constexpr (!_uses_cache)
+                return allocator<T>{}.deallocate(ptr, size);
+
+            tl_cache_detail::deallocate(ptr);
+            return {};
+        }
+
+        // Only meant for trivially relocatable types, like `allocator`
+        [[nodiscard]] inline auto reallocate(pointer_type ptr, usize old_size, usize new_size)
+            -> Result< T*, allocator_detail::allocator_error >
+        {
+            if constexpr (!_uses_cache)
+                return allocator<T>{}.reallocate(ptr, old_size, new_size);
+
+            if (new_size > limits<usize>::max / sizeof(T))
+                return allocator_detail::allocator_error{"Bad length for allocation"};
+
+            auto* _result = static_cast<T*>(tl_cache_detail::reallocate(ptr, new_size * sizeof(T)));
+
+            if (_result == nullptr)
+                return allocator_detail::allocator_error{"No space left in RAM"};
+
+            return {_result, ok_value{}};
+        }
+
+        template <typename... Args>
+        static inline void construct_at(T* ptr, Args&&... args)
+        {
+            new (ptr) T{forward<Args>(args)...};
+        }
+    };
+
+    // Allocator for containers that take their elements one at a time,
+    // like the nodes of a list. Single elements are carved out of chunks
+    // that grow geometrically and come back through a free list, the
+    // chunks are only released when the pool is destroyed. Every copy
+    // starts with an empty pool, so each container owns its own
+    template <typename T>
+    class node_pool_allocator
+    {
+    private:
+        union slot
+        {
+            slot* next;
+            alignas(T) uchar storage[sizeof(T)];
+        };
+
+        struct chunk_header
+        {
+            slot* next_chunk;
+            usize slots;
+        };
+
+        static constexpr usize _header_slots =
+            (sizeof(chunk_header) + sizeof(slot) - 1) / sizeof(slot);
+        static constexpr usize _first_chunk = 8;
+        static constexpr usize _max_chunk = 1024;
+
+        slot* _chunks = nullptr;
+        slot* _free = nullptr;
+        slot* _bump = nullptr;
+        slot* _bump_end = nullptr;
+        usize _next_chunk = _first_chunk;
+
+        template <typename U>
+        friend class node_pool_allocator;
+
+        inline auto _add_chunk()
+            -> Result< void, allocator_detail::allocator_error >
+        {
+            usize _slots = _header_slots + _next_chunk;
+            auto _result = allocator<slot>{}.allocate(_slots);
+
+            if (!_result)
+                return _result.unwrap_err();
+
+            slot* _chunk = _result.unwrap();
+            new (_chunk) chunk_header{_chunks, _slots};
+            _chunks = _chunk;
+
+            _bump = _chunk + _header_slots;
+            _bump_end = _chunk + _slots;
+
+            if (_next_chunk < _max_chunk)
+                _next_chunk *= 2;
+
+            return {};
+        }
+
+        inline void _release()
+        {
+            while (_chunks != nullptr)
+            {
+                auto* _header = bit_cast<chunk_header*>(_chunks);
+                slot* _next = _header->next_chunk;
+                allocator<slot>{}.deallocate(_chunks, _header->slots).unwrap();
+                _chunks = _next;
+            }
+
+            _free = _bump = _bump_end = nullptr;
+            _next_chunk = _first_chunk;
+        }
+
+    public:
+        using pointer_type = T*;
+        using value_type = T;
+
+        inline node_pool_allocator() = default;
+
+        inline node_pool_allocator(const node_pool_allocator&)
+        {}
+
+        template <typename U>
+        inline node_pool_allocator(const node_pool_allocator<U>&)
+        {}
+
+        inline node_pool_allocator(node_pool_allocator&& other)
+            : _chunks{exchange(other._chunks, nullptr)},
+            _free{exchange(other._free, nullptr)},
+            _bump{exchange(other._bump, nullptr)},
+            _bump_end{exchange(other._bump_end, nullptr)},
+            _next_chunk{exchange(other._next_chunk, _first_chunk)}
+        {}
+
+        inline ~node_pool_allocator()
+        {
+            _release();
+        }
+
+        // The pool stays with the memory it handed out
+        inline node_pool_allocator& operator=(const node_pool_allocator&)
+        {
+            return *this;
+        }
+
+        inline node_pool_allocator& operator=(node_pool_allocator&& rhs)
+        {
+            swap(_chunks, rhs._chunks);
+            swap(_free, rhs._free);
+            swap(_bump, rhs._bump);
+            swap(_bump_end, rhs._bump_end);
+            swap(_next_chunk, rhs._next_chunk);
+            return *this;
+        }
+
+        // Anything but a single element goes straight to `allocator`
+        [[nodiscard]] inline auto allocate(usize size)
+            -> Result< T*, allocator_detail::allocator_error >
+        {
+            if (size != 1)
+                return allocator<T>{}.allocate(size);
+
+            slot* _result = _free;
+
+            if (_result != nullptr)
+            {
+                _free = _result->next;
+            }
+            else
+            {
+                if (_bump == _bump_end)
+                {
+                    auto _added = _add_chunk();
+
+                    if (!_added)
+                        return {_added.unwrap_err(), err_value{}};
+                }
+
+                _result = _bump++;
+            }
+
+            return {bit_cast<T*>(_result), ok_value{}};
+        }
+
+        inline auto deallocate(pointer_type ptr, usize size)
+            -> Result< void, allocator_detail::allocator_error >
+        {
+            if (size != 1)
+                return allocator<T>{}.deallocate(ptr, size);
+
+            if (ptr != nullptr)
+            {
+                slot* _slot = bit_cast<slot*>(ptr);
+                _slot->next = _free;
+                _free = _slot;
+            }
+
+            return {};
+        }
+
         template <typename... Args>
         static inline void construct_at(T* ptr, Args&&... args)
         {
@@ -0,0 +1,308 @@
+#pragma once
+
+#include "Allocator.hpp"
+
+namespace hsd
+{
+    namespace arena_detail
+    {
+        static constexpr usize default_chunk_size = 4096;
+        static constexpr usize max_chunk_size = 1024 * 1024;
+
+        struct alignas(max_align_t) chunk_header
+        {
+            chunk_header* next;
+            usize size;
+        };
+
+        static inline uchar* align_up(uchar* ptr, usize alignment)
+        {
+            usize _address = bit_cast<usize>(ptr);
+            return ptr + ((alignment - _address % alignment) % alignment);
+        }
+    } // namespace arena_detail
+
+    // A point of an `arena` to go back to, everything allocated after
+    // it is released by `rewind`
+    struct arena_mark
+    {
+        arena_detail::chunk_header* chunk;
+        uchar* ptr;
+    };
+
+    // Bump pointer allocator over a list of chunks, memory is only given
+    // back all at once by `reset` or down to a mark by `rewind`. It can
+    // start from a buffer of the caller, the chunks are only allocated
+    // once that is full. The biggest released chunk is kept for reuse
+    class arena
+    {
+    private:
+        using chunk_header = arena_detail::chunk_header;
+
+        uchar* _ptr = nullptr;
+        uchar* _end = nullptr;
+        chunk_header* _chunks = nullptr;
+        chunk_header* _spare = nullptr;
+        uchar* _initial = nullptr;
+        usize _initial_size = 0;
+        usize _next_chunk_size = arena_detail::default_chunk_size;
+
+        static inline uchar* _chunk_begin(chunk_header* chunk)
+        {
+            return bit_cast<uchar*>(chunk + 1);
+        }
+
+        static inline uchar* _chunk_end(chunk_header* chunk)
+        {
+            return bit_cast<uchar*>(chunk) + chunk->size;
+        }
+
+        // Keeps the biggest of the chunks that are let go
+        inline void _retire(chunk_header* chunk)
+        {
+            if (_spare == nullptr)
+            {
+                _spare = chunk;
+            }
+            else if (_spare->size < chunk->size)
+            {
+                free(_spare);
+                _spare = chunk;
+            }
+            else
+            {
+                free(chunk);
+            }
+        }
+
+        inline auto _grow(usize min_size)
+            -> Result< void, allocator_detail::allocator_error >
+        {
+            usize _size = _next_chunk_size;
+
+            if (_size < min_size + sizeof(chunk_header))
+                _size = min_size + sizeof(chunk_header);
+
+            chunk_header* _chunk = nullptr;
+
+            if (_spare != nullptr && _spare->size >= _size)
+            {
+                _chunk = exchange(_spare, nullptr);
+            }
+            else
+            {
+                _chunk = static_cast<chunk_header*>(malloc(_size));
+
+                if (_chunk == nullptr)
+                    return allocator_detail::allocator_error{"No space left in RAM"};
+
+                _chunk->size = _size;
+
+                if (_next_chunk_size < arena_detail::max_chunk_size)
+                    _next_chunk_size *= 2;
+            }
+
+            _chunk->next = _chunks;
+            _chunks = _chunk;
+            _ptr = _chunk_begin(_chunk);
+            _end = _chunk_end(_chunk);
+            return {};
+        }
+
+    public:
+        inline arena(usize chunk_size = arena_detail::default_chunk_size)
+            : _next_chunk_size{chunk_size}
+        {}
+
+        // Allocations are served from `buf` until it runs out
+        inline arena(uchar* buf, usize size, usize chunk_size = arena_detail::default_chunk_size)
+            : _ptr{buf}, _end{buf + size}, _initial{buf},
+            _initial_size{size}, _next_chunk_size{chunk_size}
+        {}
+
+        inline arena(const arena&) = delete;
+        inline arena& operator=(const arena&) = delete;
+
+        inline ~arena()
+        {
+            release();
+        }
+
+        [[nodiscard]] inline auto allocate(usize size, usize alignment = alignof(max_align_t))
+            -> Result< uchar*, allocator_detail::allocator_error >
+        {
+            uchar* _result = arena_detail::align_up(_ptr, alignment);
+
+            if (_ptr == nullptr || _result > _end || size > static_cast<usize>(_end - _result))
+            {
+                auto _grown = _grow(size + alignment);
+
+                if (!_grown)
+                    return {_grown.unwrap_err(), err_value{}};
+
+                _result = arena_detail::align_up(_ptr, alignment);
+            }
+
+            _ptr = _result + size;
+            return {_result, ok_value{}};
+        }
+
+        // Grows the last allocation in place if it has room to
+        inline bool try_extend(uchar* ptr, usize old_size, usize new_size)
+        {
+            if (ptr + old_size != _ptr || new_size - old_size > static_cast<usize>(_end - _ptr))
+                return false;
+
+            _ptr = ptr + new_size;
+            return true;
+        }
+
+        inline arena_mark mark() const
+        {
+            return {_chunks, _ptr};
+        }
+
+        // Releases everything allocated since `pos`, which has to be
+        // a mark taken after the last rewind to an earlier point
+        inline void rewind(const arena_mark& pos)
+        {
+            while (_chunks != pos.chunk)
+                _retire(exchange(_chunks, _chunks->next));
+
+            _ptr = pos.ptr;
+
+            if (_chunks != nullptr)
+                _end = _chunk_end(_chunks);
+            else
+                _end = _initial + _initial_size;
+        }
+
+        // Releases everything, in O(chunks)
+        inline void reset()
+        {
+            rewind({nullptr, _initial});
+        }
+
+        // Like `reset`, and gives the spare chunk back as well
+        inline void release()
+        {
+            reset();
+
+            if (_spare != nullptr)
+                free(exchange(_spare, nullptr));
+        }
+
+        // Bytes left before a new chunk is needed
+        inline usize available() const
+        {
+            return static_cast<usize>(_end - _ptr);
+        }
+    };
+
+    // Rewinds the arena to where it was at the start of the scope
+    class arena_scope
+    {
+    private:
+        arena& _arena;
+        arena_mark _mark;
+
+    public:
+        inline arena_scope(arena& owner)
+            : _arena{owner}, _mark{owner.mark()}
+        {}
+
+        inline arena_scope(const arena_scope&) = delete;
+        inline arena_scope& operator=(const arena_scope&) = delete;
+
+        inline ~arena_scope()
+        {
+            _arena.rewind(_mark);
+        }
+    };
+
+    // Adapter for the `Allocator` parameter of the containers. It only
+    // refers to the arena, which has to outlive every container using
+    // it. Deallocation does nothing, the arena takes the memory back
+    template <typename T>
+    class arena_allocator
+    {
+    private:
+        arena* _arena = nullptr;
+
+        template <typename U>
+        friend class arena_allocator;
+
+    public:
+        using pointer_type = T*;
+        using value_type = T;
+
+        inline arena_allocator(arena& owner)
+            : _arena{&owner}
+        {}
+
+        template <typename U>
+        inline arena_allocator(const arena_allocator<U>& other)
+            : _arena{other._arena}
+        {}
+
+        template <typename U>
+        inline arena_allocator& operator=(const arena_allocator<U>& rhs)
+        {
+            _arena = rhs._arena;
+            return *this;
+        }
+
+        [[nodiscard]] inline auto allocate(usize size)
+            -> Result< T*, allocator_detail::allocator_error >
+        {
+            if (size > limits<usize>::max / sizeof(T))
+                return allocator_detail::allocator_error{"Bad length for allocation"};
+
+            auto _result = _arena->allocate(size * sizeof(T), alignof(T));
+
+            if (!_result)
+                return {_result.unwrap_err(), err_value{}};
+
+            return {bit_cast<T*>(_result.unwrap()), ok_value{}};
+        }
+
+        inline auto deallocate(pointer_type, usize)
+            -> Result< void, allocator_detail::allocator_error >
+        {
+            return {};
+        }
+
+        // The last allocation of the arena grows in place. Only meant
+        // for trivially relocatable types
+        [[nodiscard]] inline auto reallocate(pointer_type ptr, usize old_size, usize new_size)
+            -> Result< T*, allocator_detail::allocator_error >
+        {
+            if (new_size > limits<usize>::max / sizeof(T))
+                return allocator_detail::allocator_error{"Bad length for allocation"};
+
+            if (ptr != nullptr && new_size >= old_size &&
+                _arena->try_extend(bit_cast<uchar*>(ptr), old_size * sizeof(T), new_size * sizeof(T)))
+            {
+                return {ptr, ok_value{}};
+            }
+
+            auto _result = allocate(new_size);
+
+            if (_result && ptr != nullptr)
+            {
+                memcpy(
+                    static_cast<void*>(_result.unwrap()), static_cast<void*>(ptr),
+                    (old_size < new_size ? old_size : new_size) * sizeof(T)
+                );
+            }
+
+            return _result;
+        }
+
+        template <typename... Args>
+        static inline void construct_at(T* ptr, Args&&... args)
+        {
+            new (ptr) T{forward<Args>(args)...};
+        }
+    };
+} // namespace hsd
@@ -0,0 +1,1201 @@
+#pragma once
+
+#include "Result.hpp"
+#include "Pair.hpp"
+#include "Reference.hpp"
+#include "Allocator.hpp"
+
+namespace hsd
+{
+    namespace btree_detail
+    {
+        struct bad_key
+        {
+            const char* operator()() const
+            {
+                return "Tried to use an invalid key";
+            }
+        };
+
+        // Nodes are sized in bytes rather than in elements, so a node
+        // always spans the same number of cache lines whatever the
+        // size of the stored type is (with a floor on the fan-out)
+        static constexpr usize default_node_size = 256;
+        static constexpr usize max_depth = 32;
+
+        // Lookups with a type that can't be ordered against the key
+        // (e.g. a C string for a string key) build a key first
+        template <typename K, typename Key>
+        concept Comparable = requires(const K& lhs, const Key& rhs)
+        {
+            { lhs < rhs } -> std::convertible_to<bool>;
+            { rhs < lhs } -> std::convertible_to<bool>;
+        };
+
+        // An integer of the other signedness is converted to the key
+        // type up front, as the comparison would do, without a warning
+        template <typename K, typename Key>
+        concept MixedSign = is_integral<K>::value && is_integral<Key>::value &&
+            is_signed<K>::value != is_signed<Key>::value;
+
+        struct node_base
+        {
+            u16 _count = 0;
+            bool _leaf = true;
+        };
+
+        template <typename Value, usize NodeSize>
+        struct leaf_node : node_base
+        {
+            static constexpr usize capacity =
+                (NodeSize - 3 * sizeof(void*)) / sizeof(Value) > 4 ?
+                (NodeSize - 3 * sizeof(void*)) / sizeof(Value) : 4;
+
+            leaf_node* _prev = nullptr;
+            leaf_node* _next = nullptr;
+            alignas(Value) uchar _storage[capacity * sizeof(Value)];
+
+            inline Value* values()
+            {
+                return bit_cast<Value*>(&_storage[0]);
+            }
+
+            inline const Value* values() const
+            {
+                return bit_cast<const Value*>(&_storage[0]);
+            }
+        };
+
+        template <typename Key, usize NodeSize>
+        struct inner_node : node_base
+        {
+            static constexpr usize capacity =
+                (NodeSize - 2 * sizeof(void*)) / (sizeof(Key) + sizeof(void*)) > 4 ?
+                (NodeSize - 2 * sizeof(void*)) / (sizeof(Key) + sizeof(void*)) : 4;
+
+            node_base* _children[capacity + 1];
+            alignas(Key) uchar _storage[capacity * sizeof(Key)];
+
+            inline Key* keys()
+            {
+                return bit_cast<Key*>(&_storage[0]);
+            }
+
+            inline const Key* keys() const
+            {
+                return bit_cast<const Key*>(&_storage[0]);
+            }
+        };
+
+        // Moves [first, last) into the uninitialized or already moved
+        // from memory that starts at `dest`, regions may overlap
+        template <typename T>
+        static inline void relocate(T* first, T* last, T* dest)
+        {
+            if (dest < first)
+            {
+                for (; first != last; first++, dest++)
+                {
+                    new (dest) T(move(*first));
+                    first->~T();
+                }
+            }
+            else if (dest > first)
+            {
+                dest += last - first;
+
+                while (last != first)
+                {
+                    last--; dest--;
+                    new (dest) T(move(*last));
+                    last->~T();
+                }
+            }
+        }
+
+        template < typename Value, usize NodeSize >
+        class iterator
+        {
+        private:
+            using leaf_type = leaf_node<remove_cv_t<Value>, NodeSize>;
+
+            leaf_type* _leaf = nullptr;
+            usize _index = 0;
+            leaf_type* const* _tail = nullptr;
+
+            template < typename, template <typename> typename, usize >
+            friend class tree;
+
+            template < typename, usize >
+            friend class iterator;
+
+        public:
+            inline iterator() = default;
+
+            inline iterator(leaf_type* leaf, usize index, leaf_type* const* tail)
+                : _leaf{leaf}, _index{index}, _tail{tail}
+            {}
+
+            template <typename U>
+            requires (IsSame<const U, Value>)
+            inline iterator(const iterator<U, NodeSize>& other)
+                : _leaf{other._leaf}, _index{other._index}, _tail{other._tail}
+            {}
+
+            inline bool operator==(const iterator& rhs) const
+            {
+                return _leaf == rhs._leaf && _index == rhs._index;
+            }
+
+            inline bool operator!=(const iterator& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            inline iterator& operator++()
+            {
+                if (++_index == _leaf->_count)
+                {
+                    _leaf = _leaf->_next;
+                    _index = 0;
+                }
+
+                return *this;
+            }
+
+            inline iterator operator++(i32)
+            {
+                iterator _tmp = *this;
+                operator++();
+                return _tmp;
+            }
+
+            // Decrementing end() gives the last element
+            inline iterator& operator--()
+            {
+                if (_leaf == nullptr)
+                {
+                    _leaf = *_tail;
+                    _index = _leaf->_count - 1u;
+                }
+                else if (_index == 0)
+                {
+                    _leaf = _leaf->_prev;
+                    _index = _leaf->_count - 1u;
+                }
+                else
+                {
+                    _index--;
+                }
+
+                return *this;
+            }
+
+            inline iterator operator--(i32)
+            {
+                iterator _tmp = *this;
+                operator--();
+                return _tmp;
+            }
+
+            inline Value& operator*() const
+            {
+                return _leaf->values()[_index];
+            }
+
+            inline Value* operator->() const
+            {
+                return &_leaf->values()[_index];
+            }
+        };
+
+        template < typename Iterator >
+        class range_view
+        {
+        private:
+            Iterator _begin, _end;
+
+        public:
+            inline range_view(Iterator begin, Iterator end)
+                : _begin{begin}, _end{end}
+            {}
+
+            inline Iterator begin() const
+            {
+                return _begin;
+            }
+
+            inline Iterator end() const
+            {
+                return _end;
+            }
+
+            inline bool empty() const
+            {
+                return _begin == _end;
+            }
+        };
+
+        // Common B+tree of btree_map and btree_set: the values only
+        // live in the leaves, which are linked in order so iteration
+        // and range scans never go back up the tree. `Traits` gives
+        // the key type, the value type and how to get the key
+        template < typename Traits, template <typename> typename Allocator, usize NodeSize >
+        class tree
+        {
+        public:
+            using key_type = typename Traits::key_type;
+            using value_type = typename Traits::value_type;
+            using iterator = btree_detail::iterator<value_type, NodeSize>;
+            using const_iterator = btree_detail::iterator<const value_type, NodeSize>;
+
+        private:
+            using leaf_type = leaf_node<value_type, NodeSize>;
+            using inner_type = inner_node<key_type, NodeSize>;
+
+            static constexpr usize _leaf_cap = leaf_type::capacity;
+            static constexpr usize _inner_cap = inner_type::capacity;
+            static constexpr usize _leaf_min = _leaf_cap / 2;
+            static constexpr usize _inner_min = _inner_cap / 2;
+
+            Allocator<leaf_type> _leaf_alloc;
+            Allocator<inner_type> _inner_alloc;
+            node_base* _root = nullptr;
+            leaf_type* _head = nullptr;
+            leaf_type* _tail = nullptr;
+            usize _size = 0;
+
+            struct path_entry
+            {
+                inner_type* node;
+                usize index;
+            };
+
+            static inline const key_type& _key(const value_type& value)
+            {
+                return Traits::key_of(value);
+            }
+
+            static inline leaf_type* _as_leaf(node_base* node)
+            {
+                return static_cast<leaf_type*>(node);
+            }
+
+            static inline inner_type* _as_inner(node_base* node)
+            {
+                return static_cast<inner_type*>(node);
+            }
+
+            // Index of the first key in `node` that is not less than `key`
+            template <typename K>
+            static inline usize _lower(const leaf_type* node, const K& key)
+            {
+                usize _low = 0, _high = node->_count;
+
+                while (_low < _high)
+                {
+                    usize _mid = (_low + _high) / 2;
+
+                    if (_key(node->values()[_mid]) < key)
+                        _low = _mid + 1;
+                    else
+                        _high = _mid;
+                }
+
+                return _low;
+            }
+
+            // Index of the child of `node` that may contain `key`
+            template <typename K>
+            static inline usize _child(const inner_type* node, const K& key)
+            {
+                usize _low = 0, _high = node->_count;
+
+                while (_low < _high)
+                {
+                    usize _mid = (_low + _high) / 2;
+
+                    if (key < node->keys()[_mid])
+                        _high = _mid;
+                    else
+                        _low = _mid + 1;
+                }
+
+                return _low;
+            }
+
+            inline leaf_type* _new_leaf()
+            {
+                return new (_leaf_alloc.allocate(1).unwrap()) leaf_type;
+            }
+
+            inline inner_type* _new_inner()
+            {
+                auto* _node = new (_inner_alloc.allocate(1).unwrap()) inner_type;
+                _node->_leaf = false;
+                return _node;
+            }
+
+            inline void _free_leaf(leaf_type* node)
+            {
+                for (usize _index = 0; _index < node->_count; _index++)
+                    node->values()[_index].~value_type();
+
+                node->~leaf_type();
+                _leaf_alloc.deallocate(node, 1).unwrap();
+            }
+
+            inline void _free_inner(inner_type* node)
+            {
+                for (usize _index = 0; _index < node->_count; _index++)
+                    node->keys()[_index].~key_type();
+
+                node->~inner_type();
+                _inner_alloc.deallocate(node, 1).unwrap();
+            }
+
+            inline void _free(node_base* node)
+            {
+                if (node->_leaf)
+                {
+                    _free_leaf(_as_leaf(node));
+                }
+                else
+                {
+                    auto* _inner = _as_inner(node);
+
+                    for (usize _index = 0; _index <= _inner->_count; _index++)
+                        _free(_inner->_children[_index]);
+
+                    _free_inner(_inner);
+                }
+            }
+
+            template <typename K>
+            inline leaf_type* _descend(const K& key, path_entry* path, usize& depth) const
+            {
+                node_base* _node = _root;
+                depth = 0;
+
+                while (!_node->_leaf)
+                {
+                    auto* _inner = _as_inner(_node);
+                    usize _index = _child(_inner, key);
+
+                    if (path != nullptr)
+                        path[depth] = {_inner, _index};
+
+                    depth++;
+                    _node = _inner->_children[_index];
+                }
+
+                return _as_leaf(_node);
+            }
+
+            // Adds `key` and `right` after child `index` of `node`
+            // (which must not be full)
+            static inline void _inner_insert(
+                inner_type* node, usize index, key_type&& key, node_base* right)
+            {
+                key_type* _keys = node->keys();
+
+                relocate(_keys + index, _keys + node->_count, _keys + index + 1);
+                new (_keys + index) key_type(move(key));
+
+                for (usize _pos = node->_count + 1u; _pos > index + 1; _pos--)
+                    node->_children[_pos] = node->_children[_pos - 1];
+
+                node->_children[index + 1] = right;
+                node->_count++;
+            }
+
+            // Hooks the node split off at `path[depth - 1]` into the
+            // parents, splitting them as well while they are full
+            inline void _insert_split(
+                path_entry* path, usize depth, key_type&& key, node_base* right)
+            {
+                while (depth != 0)
+                {
+                    auto [_node, _index] = path[--depth];
+
+                    if (_node->_count < _inner_cap)
+                    {
+                        _inner_insert(_node, _index, move(key), right);
+                        return;
+                    }
+
+                    // The middle key moves up and is not kept
+                    // in either half, like in any B-tree
+                    constexpr usize _mid = _inner_cap / 2;
+                    auto* _right = _new_inner();
+                    key_type* _keys = _node->keys();
+
+                    relocate(_keys + _mid + 1, _keys + _inner_cap, _right->keys());
+
+                    for (usize _pos = _mid + 1; _pos <= _inner_cap; _pos++)
+                        _right->_children[_pos - _mid - 1] = _node->_children[_pos];
+
+                    _right->_count = static_cast<u16>(_inner_cap - _mid - 1);
+                    _node->_count = static_cast<u16>(_mid);
+                    key_type _up = move(_keys[_mid]);
+                    _keys[_mid].~key_type();
+
+                    if (_index <= _mid)
+                        _inner_insert(_node, _index, move(key), right);
+                    else
+                        _inner_insert(_right, _index - _mid - 1, move(key), right);
+
+                    key = move(_up);
+                    right = _right;
+                }
+
+                auto* _new_root = _new_inner();
+                new (_new_root->keys()) key_type(move(key));
+                _new_root->_children[0] = _root;
+                _new_root->_children[1] = right;
+                _new_root->_count = 1;
+                _root = _new_root;
+            }
+
+            inline void _unlink_leaf(leaf_type* node)
+            {
+                if (node->_prev != nullptr)
+                    node->_prev->_next = node->_next;
+                else
+                    _head = node->_next;
+
+                if (node->_next != nullptr)
+                    node->_next->_prev = node->_prev;
+                else
+                    _tail = node->_prev;
+            }
+
+            // Removes key `index` and child `index + 1` from `node`
+            static inline void _inner_remove(inner_type* node, usize index)
+            {
+                key_type* _keys = node->keys();
+                _keys[index].~key_type();
+                relocate(_keys + index + 1, _keys + node->_count, _keys + index);
+
+                for (usize _pos = index + 1; _pos < node->_count; _pos++)
+                    node->_children[_pos] = node->_children[_pos + 1];
+
+                node->_count--;
+            }
+
+            inline void _rebalance_leaf(leaf_type* node, path_entry* path, usize depth)
+            {
+                auto [_parent, _index] = path[depth - 1];
+                auto* _left = _index > 0 ?
+                    _as_leaf(_parent->_children[_index - 1]) : nullptr;
+                auto* _right = _index < _parent->_count ?
+                    _as_leaf(_parent->_children[_index + 1]) : nullptr;
+
+                if (_left != nullptr && _left->_count > _leaf_min)
+                {
+                    value_type* _values = node->values();
+                    relocate(_values, _values + node->_count, _values + 1);
+                    relocate(
+                        _left->values() + _left->_count - 1,
+                        _left->values() + _left->_count, _values
+                    );
+
+                    _left->_count--;
+                    node->_count++;
+                    _parent->keys()[_index - 1] = _key(_values[0]);
+                }
+                else if (_right != nullptr && _right->_count > _leaf_min)
+                {
+                    value_type* _values = _right->values();
+                    relocate(_values, _values + 1, node->values() + node->_count);
+                    relocate(_values + 1, _values + _right->_count, _values);
+
+                    _right->_count--;
+                    node->_count++;
+                    _parent->keys()[_index] = _key(_values[0]);
+                }
+                else
+                {
+                    // Merge into the left one of the two neighbours
+                    if (_left == nullptr)
+                    {
+                        _left = node;
+                        node = _right;
+                        _index++;
+                    }
+
+                    relocate(
+                        node->values(), node->values() + node->_count,
+                        _left->values() + _left->_count
+                    );
+
+                    _left->_count += node->_count;
+                    node->_count = 0;
+                    _unlink_leaf(node);
+                    _free_leaf(node);
+                    _inner_remove(_parent, _index - 1);
+                    _rebalance_inner(path, depth - 1);
+                }
+            }
+
+            inline void _rebalance_inner(path_entry* path, usize depth)
+            {
+                inner_type* _node = path[depth].node;
+
+                if (depth == 0)
+                {
+                    if (_node->_count == 0)
+                    {
+                        _root = _node->_children[0];
+                        _free_inner(_node);
+                    }
+
+                    return;
+                }
+
+                if (_node->_count >= _inner_min)
+                    return;
+
+                auto [_parent, _index] = path[depth - 1];
+                auto* _left = _index > 0 ?
+                    _as_inner(_parent->_children[_index - 1]) : nullptr;
+                auto* _right = _index < _parent->_count ?
+                    _as_inner(_parent->_children[_index + 1]) : nullptr;
+                key_type* _sep = _parent->keys();
+
+                if (_left != nullptr && _left->_count > _inner_min)
+                {
+                    key_type* _keys = _node->keys();
+                    relocate(_keys, _keys + _node->_count, _keys + 1);
+                    new (_keys) key_type(move(_sep[_index - 1]));
+
+                    for (usize _pos = _node->_count + 1u; _pos > 0; _pos--)
+                        _node->_children[_pos] = _node->_children[_pos - 1];
+
+                    _node->_children[0] = _left->_children[_left->_count];
+                    _sep[_index - 1] = move(_left->keys()[_left->_count - 1]);
+                    _left->keys()[_left->_count - 1].~key_type();
+                    _left->_count--;
+                    _node->_count++;
+                }
+                else if (_right != nullptr && _right->_count > _inner_min)
+                {
+                    key_type* _keys = _right->keys();
+                    new (_node->keys() + _node->_count) key_type(move(_sep[_index]));
+                    _node->_children[_node->_count + 1] = _right->_children[0];
+                    _sep[_index] = move(_keys[0]);
+                    _keys[0].~key_type();
+                    relocate(_keys + 1, _keys + _right->_count, _keys);
+
+                    for (usize _pos = 0; _pos < _right->_count; _pos++)
+                        _right->_children[_pos] = _right->_children[_pos + 1];
+
+                    _right->_count--;
+                    _node->_count++;
+                }
+                else
+                {
+                    if (_left == nullptr)
+                    {
+                        _left = _node;
+                        _node = _right;
+                        _index++;
+                    }
+
+                    // The separator comes down between the two halves
+                    new (_left->keys() + _left->_count) key_type(move(_sep[_index - 1]));
+                    relocate(
+                        _node->keys(), _node->keys() + _node->_count,
+                        _left->keys() + _left->_count + 1
+                    );
+
+                    for (usize _pos = 0; _pos <= _node->_count; _pos++)
+                        _left->_children[_left->_count + 1 + _pos] = _node->_children[_pos];
+
+                    _left->_count += _node->_count + 1;
+                    _node->_count = 0;
+                    _free_inner(_node);
+                    _inner_remove(_parent, _index - 1);
+                    _rebalance_inner(path, depth - 1);
+                }
+            }
+
+        public:
+            template <typename K>
+            static inline decltype(auto) _lookup(const K& key)
+            {
+                if constexpr (Comparable<K, key_type> && !MixedSign<K, key_type>)
+                    return (key);
+                else
+                    return key_type(key);
+            }
+
+            inline tree() = default;
+
+            template <typename Alloc>
+            inline tree(const Alloc& alloc)
+                : _leaf_alloc(alloc), _inner_alloc(alloc)
+            {}
+
+            inline tree(const tree& other)
+                : _leaf_alloc(other._leaf_alloc), _inner_alloc(other._inner_alloc)
+            {
+                // Sorted input always appends to the last leaf
+                for (auto& _value : other)
+                {
+                    _insert_unique(_key(_value), [&](value_type* ptr)
+                    {
+                        new (ptr) value_type(_value);
+                    });
+                }
+            }
+
+            inline tree(tree&& other)
+                : _leaf_alloc(move(other._leaf_alloc)),
+                _inner_alloc(move(other._inner_alloc)),
+                _root{exchange(other._root, nullptr)},
+                _head{exchange(other._head, nullptr)},
+                _tail{exchange(other._tail, nullptr)},
+                _size{exchange(other._size, 0u)}
+            {}
+
+            inline ~tree()
+            {
+                clear();
+            }
+
+            inline tree& operator=(const tree& rhs)
+            {
+                if (this != &rhs)
+                {
+                    clear();
+
+                    for (auto& _value : rhs)
+                    {
+                        _insert_unique(_key(_value), [&](value_type* ptr)
+                        {
+                            new (ptr) value_type(_value);
+                        });
+                    }
+                }
+
+                return *this;
+            }
+
+            inline tree& operator=(tree&& rhs)
+            {
+                clear();
+                swap(_leaf_alloc, rhs._leaf_alloc);
+                swap(_inner_alloc, rhs._inner_alloc);
+                swap(_root, rhs._root);
+                swap(_head, rhs._head);
+                swap(_tail, rhs._tail);
+                swap(_size, rhs._size);
+                return *this;
+            }
+
+            // Calls `make(value_type*)` to build the value in place,
+            // only when `key` is not in the tree yet
+            template < typename K, typename Make >
+            inline pair<iterator, bool> _insert_unique(const K& key, Make&& make)
+            {
+                if (_root == nullptr)
+                {
+                    _head = _tail = _new_leaf();
+                    _root = _head;
+                }
+
+                path_entry _path[max_depth];
+                usize _depth = 0;
+                leaf_type* _leaf = _descend(key, _path, _depth);
+                usize _index = _lower(_leaf, key);
+
+                if (_index < _leaf->_count && !(key < _key(_leaf->values()[_index])))
+                    return {iterator{_leaf, _index, &_tail}, false};
+
+                if (_leaf->_count == _leaf_cap)
+                {
+                    // Appending in order leaves full nodes behind
+                    // instead of a trail of half empty ones
+                    usize _keep = (_index == _leaf_cap && _leaf->_next == nullptr) ?
+                        _leaf_cap : _leaf_cap / 2;
+
+                    auto* _right = _new_leaf();
+                    relocate(
+                        _leaf->values() + _keep, _leaf->values() + _leaf_cap,
+                        _right->values()
+                    );
+
+                    _right->_count = static_cast<u16>(_leaf_cap - _keep);
+                    _leaf->_count = static_cast<u16>(_keep);
+                    _right->_prev = _leaf;
+                    _right->_next = _leaf->_next;
+
+                    if (_leaf->_next != nullptr)
+                        _leaf->_next->_prev = _right;
+                    else
+                        _tail = _right;
+
+                    _leaf->_next = _right;
+                    leaf_type* _target = _leaf;
+
+                    if (_index > _keep || (_index == _keep && _keep == _leaf_cap))
+                    {
+                        _target = _right;
+                        _index -= _keep;
+                    }
+
+                    value_type* _values = _target->values();
+                    relocate(_values + _index, _values + _target->_count, _values + _index + 1);
+                    make(_values + _index);
+                    _target->_count++;
+                    _size++;
+
+                    _insert_split(_path, _depth, key_type(_key(_right->values()[0])), _right);
+                    return {iterator{_target, _index, &_tail}, true};
+                }
+
+                value_type* _values = _leaf->values();
+                relocate(_values + _index, _values + _leaf->_count, _values + _index + 1);
+                make(_values + _index);
+                _leaf->_count++;
+                _size++;
+
+                return {iterator{_leaf, _index, &_tail}, true};
+            }
+
+            template <typename K>
+            inline bool _erase(const K& key)
+            {
+                if (_root == nullptr)
+                    return false;
+
+                path_entry _path[max_depth];
+                usize _depth = 0;
+                leaf_type* _leaf = _descend(key, _path, _depth);
+                usize _index = _lower(_leaf, key);
+
+                if (_index == _leaf->_count || key < _key(_leaf->values()[_index]))
+                    return false;
+
+                value_type* _values = _leaf->values();
+                _values[_index].~value_type();
+                relocate(_values + _index + 1, _values + _leaf->_count, _values + _index);
+                _leaf->_count--;
+                _size--;
+
+                if (_depth == 0)
+                {
+                    if (_leaf->_count == 0)
+                    {
+                        _free_leaf(_leaf);
+                        _root = _head = _tail = nullptr;
+                    }
+                }
+                else if (_leaf->_count < _leaf_min)
+                {
+                    _rebalance_leaf(_leaf, _path, _depth);
+                }
+
+                return true;
+            }
+
+            template <typename K>
+            inline iterator _lower_bound(const K& key) const
+            {
+                if (_root == nullptr)
+                    return _end();
+
+                usize _depth = 0;
+                leaf_type* _leaf = _descend(key, nullptr, _depth);
+                usize _index = _lower(_leaf, key);
+
+                if (_index == _leaf->_count)
+                    return {_leaf->_next, 0, &_tail};
+
+                return {_leaf, _index, &_tail};
+            }
+
+            template <typename K>
+            inline iterator _upper_bound(const K& key) const
+            {
+                iterator _iter = _lower_bound(key);
+
+                if (_iter != _end() && !(key < _key(*_iter)))
+                    ++_iter;
+
+                return _iter;
+            }
+
+            template <typename K>
+            inline iterator _find(const K& key) const
+            {
+                iterator _iter = _lower_bound(key);
+
+                if (_iter == _end() || key < _key(*_iter))
+                    return _end();
+
+                return _iter;
+            }
+
+            inline iterator _begin() const
+            {
+                return {_head, 0, &_tail};
+            }
+
+            inline iterator _end() const
+            {
+                return {nullptr, 0, &_tail};
+            }
+
+            inline iterator begin()
+            {
+                return _begin();
+            }
+
+            inline const_iterator begin() const
+            {
+                return _begin();
+            }
+
+            inline iterator end()
+            {
+                return _end();
+            }
+
+            inline const_iterator end() const
+            {
+                return _end();
+            }
+
+            inline void clear()
+            {
+                if (_root != nullptr)
+                    _free(_root);
+
+                _root = _head = _tail = nullptr;
+                _size = 0;
+            }
+
+            inline usize size() const
+            {
+                return _size;
+            }
+
+            inline bool empty() const
+            {
+                return _size == 0;
+            }
+
+            inline usize height() const
+            {
+                usize _height = 0;
+
+                for (node_base* _node = _root; _node != nullptr; _height++)
+                {
+                    if (_node->_leaf)
+                        return _height + 1;
+
+                    _node = _as_inner(_node)->_children[0];
+                }
+
+                return _height;
+            }
+        };
+
+        template <typename Key, typename T>
+        struct map_traits
+        {
+            using key_type = Key;
+            using value_type = pair<Key, T>;
+
+            static inline const Key& key_of(const value_type& value)
+            {
+                return value.first;
+            }
+        };
+
+        template <typename Key>
+        struct set_traits
+        {
+            using key_type = Key;
+            using value_type = Key;
+
+            static inline const Key& key_of(const value_type& value)
+            {
+                return value;
+            }
+        };
+    } // namespace btree_detail
+
+    // Ordered map kept in a B+tree, keys are ordered by their operator<
+    // and every lookup accepts any type comparable with the key.
+    // Iterators are invalidated by insertions and erasures
+    template < typename Key, typename T,
+        template <typename> typename Allocator = allocator,
+        usize NodeSize = btree_detail::default_node_size >
+    class btree_map
+        : public btree_detail::tree<btree_detail::map_traits<Key, T>, Allocator, NodeSize>
+    {
+    private:
+        using base_type = btree_detail::tree<
+            btree_detail::map_traits<Key, T>, Allocator, NodeSize
+        >;
+
+    public:
+        using typename base_type::iterator;
+        using typename base_type::const_iterator;
+        using base_type::base_type;
+
+        template <typename U = Key>
+        inline auto at(const U& key)
+            -> Result< reference<T>, btree_detail::bad_key >
+        {
+            auto _iter = this->_find(this->_lookup(key));
+
+            if (_iter == this->_end())
+                return btree_detail::bad_key{};
+
+            return {_iter->second};
+        }
+
+        template <typename U = Key>
+        inline auto at(const U& key) const
+            -> Result< reference<const T>, btree_detail::bad_key >
+        {
+            auto _iter = this->_find(this->_lookup(key));
+
+            if (_iter == this->_end())
+                return btree_detail::bad_key{};
+
+            return {_iter->second};
+        }
+
+        template <typename U = Key>
+        inline auto& operator[](U&& key)
+        {
+            return try_emplace(forward<U>(key)).first->second;
+        }
+
+        template <typename U = Key>
+        inline iterator find(const U& key)
+        {
+            return this->_find(this->_lookup(key));
+        }
+
+        template <typename U = Key>
+        inline const_iterator find(const U& key) const
+        {
+            return this->_find(this->_lookup(key));
+        }
+
+        template <typename U = Key>
+        inline bool contains(const U& key) const
+        {
+            return this->_find(this->_lookup(key)) != this->_end();
+        }
+
+        template <typename U = Key>
+        inline iterator lower_bound(const U& key)
+        {
+            return this->_lower_bound(this->_lookup(key));
+        }
+
+        template <typename U = Key>
+        inline const_iterator lower_bound(const U& key) const
+        {
+            return this->_lower_bound(this->_lookup(key));
+        }
+
+        template <typename U = Key>
+        inline iterator upper_bound(const U& key)
+        {
+            return this->_upper_bound(this->_lookup(key));
+        }
+
+        template <typename U = Key>
+        inline const_iterator upper_bound(const U& key) const
+        {
+            return this->_upper_bound(this->_lookup(key));
+        }
+
+        // Elements with keys in [low, high)
+        template < typename U = Key, typename V = Key >
+        inline auto range(const U& low, const V& high)
+        {
+            return btree_detail::range_view<iterator>{
+                this->_lower_bound(this->_lookup(low)),
+                this->_lower_bound(this->_lookup(high))
+            };
+        }
+
+        template < typename U = Key, typename V = Key >
+        inline auto range(const U& low, const V& high) const
+        {
+            return btree_detail::range_view<const_iterator>{
+                this->_lower_bound(this->_lookup(low)),
+                this->_lower_bound(this->_lookup(high))
+            };
+        }
+
+        // The key and the value are only built on insertion
+        template < typename NewKey, typename... Args >
+        inline pair<iterator, bool> try_emplace(NewKey&& key, Args&&... args)
+        {
+            if constexpr (btree_detail::Comparable<remove_cvref_t<NewKey>, Key>)
+            {
+                return this->_insert_unique(key, [&](pair<Key, T>* ptr)
+                {
+                    new (ptr) pair<Key, T>{
+                        Key(forward<NewKey>(key)), T{forward<Args>(args)...}
+                    };
+                });
+            }
+            else
+            {
+                return try_emplace(Key(forward<NewKey>(key)), forward<Args>(args)...);
+            }
+        }
+
+        template < typename NewKey, typename... Args >
+        inline pair<iterator, bool> emplace(NewKey&& key, Args&&... args)
+        {
+            return try_emplace(forward<NewKey>(key), forward<Args>(args)...);
+        }
+
+        template < typename NewKey, typename Value >
+        inline pair<iterator, bool> insert_or_assign(NewKey&& key, Value&& value)
+        {
+            auto _res = try_emplace(forward<NewKey>(key), forward<Value>(value));
+
+            if (!_res.second)
+                _res.first->second = forward<Value>(value);
+
+            return _res;
+        }
+
+        template <typename U = Key>
+        inline bool erase(const U& key)
+        {
+            return this->_erase(this->_lookup(key));
+        }
+
+        // Returns the iterator to the element after `pos`
+        inline iterator erase(const_iterator pos)
+        {
+            Key _key = pos->first;
+            this->_erase(_key);
+            return this->_upper_bound(_key);
+        }
+
+        inline iterator erase(iterator pos)
+        {
+            return erase(const_iterator{pos});
+        }
+    };
+
+    // Ordered set kept in a B+tree, see btree_map
+    template < typename Key, template <typename> typename Allocator = allocator,
+        usize NodeSize = btree_detail::default_node_size >
+    class btree_set
+        : public btree_detail::tree<btree_detail::set_traits<Key>, Allocator, NodeSize>
+    {
+    private:
+        using base_type = btree_detail::tree<
+            btree_detail::set_traits<Key>, Allocator, NodeSize
+        >;
+
+    public:
+        // The keys of a set can't be modified in place
+        using iterator = typename base_type::const_iterator;
+        using const_iterator = typename base_type::const_iterator;
+        using base_type::base_type;
+
+        inline const_iterator begin() const
+        {
+            return base_type::begin();
+        }
+
+        inline const_iterator end() const
+        {
+            return base_type::end();
+        }
+
+        template <typename U = Key>
+        inline const_iterator find(const U& key) const
+        {
+            return this->_find(this->_lookup(key));
+        }
+
+        template <typename U = Key>
+        inline bool contains(const U& key) const
+        {
+            return this->_find(this->_lookup(key)) != this->_end();
+        }
+
+        template <typename U = Key>
+        inline const_iterator lower_bound(const U& key) const
+        {
+            return this->_lower_bound(this->_lookup(key));
+        }
+
+        template <typename U = Key>
+        inline const_iterator upper_bound(const U& key) const
+        {
+            return this->_upper_bound(this->_lookup(key));
+        }
+
+        // Keys in [low, high)
+        template < typename U = Key, typename V = Key >
+        inline auto range(const U& low, const V& high) const
+        {
+            return btree_detail::range_view<const_iterator>{
+                this->_lower_bound(this->_lookup(low)),
+                this->_lower_bound(this->_lookup(high))
+            };
+        }
+
+        template <typename U = Key>
+        inline pair<const_iterator, bool> insert(U&& key)
+        {
+            if constexpr (btree_detail::Comparable<remove_cvref_t<U>, Key>)
+            {
+                auto [_iter, _inserted] = this->_insert_unique(key, [&](Key* ptr)
+                {
+                    new (ptr) Key(forward<U>(key));
+                });
+
+                return {_iter, _inserted};
+            }
+            else
+            {
+                return insert(Key(forward<U>(key)));
+            }
+        }
+
+        template <typename... Args>
+        inline pair<const_iterator, bool> emplace(Args&&... args)
+        {
+            return insert(Key{forward<Args>(args)...});
+        }
+
+        template <typename U = Key>
+        inline bool erase(const U& key)
+        {
+            return this->_erase(this->_lookup(key));
+        }
+
+        inline const_iterator erase(const_iterator pos)
+        {
+            Key _key = *pos;
+            this->_erase(_key);
+            return this->_upper_bound(_key);
+        }
+    };
+
+    template < typename Key, typename T >
+    using buffered_btree_map = btree_map<Key, T, buffered_allocator>;
+
+    template < typename Key >
+    using buffered_btree_set = btree_set<Key, buffered_allocator>;
+} // namespace hsd
@@ -0,0 +1,530 @@
+#pragma once
+
+#include "Vector.hpp"
+
+namespace hsd
+{
+    namespace bitset_detail
+    {
+        static constexpr usize word_bits = 64;
+        static constexpr usize npos = static_cast<usize>(-1);
+
+        struct bad_access
+        {
+            const char* operator()() const
+            {
+                return "Tried to access a bit out of bounds";
+            }
+        };
+
+        static constexpr usize words_for(usize bits)
+        {
+            return (bits + word_bits - 1) / word_bits;
+        }
+
+        // The bits past the size in the last word are kept at zero,
+        // so that counting and comparing can work on whole words
+        static constexpr u64 tail_mask(usize bits)
+        {
+            return bits % word_bits == 0 ? ~0ull : (1ull << (bits % word_bits)) - 1;
+        }
+
+        // The loops below work a whole word at a time and have no
+        // dependencies between iterations, so they get vectorized
+        static inline void and_words(u64* lhs, const u64* rhs, usize count)
+        {
+            for (usize _index = 0; _index < count; _index++)
+                lhs[_index] &= rhs[_index];
+        }
+
+        static inline void or_words(u64* lhs, const u64* rhs, usize count)
+        {
+            for (usize _index = 0; _index < count; _index++)
+                lhs[_index] |= rhs[_index];
+        }
+
+        static inline void xor_words(u64* lhs, const u64* rhs, usize count)
+        {
+            for (usize _index = 0; _index < count; _index++)
+                lhs[_index] ^= rhs[_index];
+        }
+
+        static inline void flip_words(u64* words, usize count)
+        {
+            for (usize _index = 0; _index < count; _index++)
+                words[_index] = ~words[_index];
+        }
+
+        static inline usize count_words(const u64* words, usize count)
+        {
+            usize _result = 0;
+
+            for (usize _index = 0; _index < count; _index++)
+                _result += static_cast<usize>(__builtin_popcountll(words[_index]));
+
+            return _result;
+        }
+
+        static inline bool equal_words(const u64* lhs, const u64* rhs, usize count)
+        {
+            u64 _diff = 0;
+
+            for (usize _index = 0; _index < count; _index++)
+                _diff |= lhs[_index] ^ rhs[_index];
+
+            return _diff == 0;
+        }
+
+        // First set bit at or after `pos`, npos if there is none
+        static inline usize find_from(const u64* words, usize count, usize pos)
+        {
+            usize _word = pos / word_bits;
+
+            if (_word >= count)
+                return npos;
+
+            u64 _bits = words[_word] & (~0ull << (pos % word_bits));
+
+            while (_bits == 0)
+            {
+                if (++_word == count)
+                    return npos;
+
+                _bits = words[_word];
+            }
+
+            return _word * word_bits + static_cast<usize>(__builtin_ctzll(_bits));
+        }
+
+        // Walks the set bits, clearing the lowest one of a copy
+        // of the current word at every step
+        class set_bit_iterator
+        {
+        private:
+            const u64* _words = nullptr;
+            usize _count = 0;
+            usize _word = 0;
+            u64 _bits = 0;
+
+            inline void _skip_empty()
+            {
+                while (_bits == 0 && ++_word < _count)
+                    _bits = _words[_word];
+            }
+
+        public:
+            inline set_bit_iterator(const u64* words, usize count, usize word)
+                : _words{words}, _count{count}, _word{word}
+            {
+                if (_word < _count)
+                {
+                    _bits = _words[_word];
+                    _skip_empty();
+                }
+            }
+
+            inline bool operator==(const set_bit_iterator& rhs) const
+            {
+                return _word == rhs._word && _bits == rhs._bits;
+            }
+
+            inline bool operator!=(const set_bit_iterator& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            inline set_bit_iterator& operator++()
+            {
+                _bits &= _bits - 1;
+                _skip_empty();
+                return *this;
+            }
+
+            inline set_bit_iterator operator++(i32)
+            {
+                set_bit_iterator _tmp = *this;
+                operator++();
+                return _tmp;
+            }
+
+            inline usize operator*() const
+            {
+                return _word * word_bits + static_cast<usize>(__builtin_ctzll(_bits));
+            }
+        };
+
+        class set_bit_range
+        {
+        private:
+            const u64* _words;
+            usize _count;
+
+        public:
+            inline set_bit_range(const u64* words, usize count)
+                : _words{words}, _count{count}
+            {}
+
+            inline set_bit_iterator begin() const
+            {
+                return {_words, _count, 0};
+            }
+
+            inline set_bit_iterator end() const
+            {
+                return {_words, _count, _count};
+            }
+        };
+
+        // The operations shared by the static and the dynamic bitset,
+        // `Derived` provides `_data()`, `_word_count()` and `size()`
+        template <typename Derived>
+        class bitset_base
+        {
+        private:
+            inline Derived& _self()
+            {
+                return static_cast<Derived&>(*this);
+            }
+
+            inline const Derived& _self() const
+            {
+                return static_cast<const Derived&>(*this);
+            }
+
+            inline void _trim()
+            {
+                if (_self()._word_count() != 0)
+                    _self()._data()[_self()._word_count() - 1] &= tail_mask(_self().size());
+            }
+
+        public:
+            inline bool operator[](usize pos) const
+            {
+                return test(pos);
+            }
+
+            inline bool test(usize pos) const
+            {
+                return (_self()._data()[pos / word_bits] >> (pos % word_bits)) & 1;
+            }
+
+            inline auto at(usize pos) const
+                -> Result<bool, bad_access>
+            {
+                if (pos >= _self().size())
+                    return bad_access{};
+
+                return test(pos);
+            }
+
+            inline Derived& set(usize pos)
+            {
+                _self()._data()[pos / word_bits] |= 1ull << (pos % word_bits);
+                return _self();
+            }
+
+            inline Derived& set(usize pos, bool value)
+            {
+                return value ? set(pos) : reset(pos);
+            }
+
+            inline Derived& reset(usize pos)
+            {
+                _self()._data()[pos / word_bits] &= ~(1ull << (pos % word_bits));
+                return _self();
+            }
+
+            inline Derived& flip(usize pos)
+            {
+                _self()._data()[pos / word_bits] ^= 1ull << (pos % word_bits);
+                return _self();
+            }
+
+            inline Derived& set()
+            {
+                u64* _words = _self()._data();
+
+                for (usize _index = 0; _index < _self()._word_count(); _index++)
+                    _words[_index] = ~0ull;
+
+                _trim();
+                return _self();
+            }
+
+            inline Derived& reset()
+            {
+                u64* _words = _self()._data();
+
+                for (usize _index = 0; _index < _self()._word_count(); _index++)
+                    _words[_index] = 0;
+
+                return _self();
+            }
+
+            inline Derived& flip()
+            {
+                flip_words(_self()._data(), _self()._word_count());
+                _trim();
+                return _self();
+            }
+
+            inline usize count() const
+            {
+                return count_words(_self()._data(), _self()._word_count());
+            }
+
+            inline bool any() const
+            {
+                return find_first() != npos;
+            }
+
+            inline bool none() const
+            {
+                return find_first() == npos;
+            }
+
+            inline bool all() const
+            {
+                return count() == _self().size();
+            }
+
+            // Position of the first set bit, npos if there is none
+            inline usize find_first() const
+            {
+                return find_from(_self()._data(), _self()._word_count(), 0);
+            }
+
+            // Position of the first set bit after `pos`, npos if there is none
+            inline usize find_next(usize pos) const
+            {
+                return find_from(_self()._data(), _self()._word_count(), pos + 1);
+            }
+
+            // For `for (usize pos : bits.set_bits())`
+            inline set_bit_range set_bits() const
+            {
+                return {_self()._data(), _self()._word_count()};
+            }
+
+            // The operators below work on the words both sides have,
+            // the two bitsets are expected to be the same size
+            inline Derived& operator&=(const Derived& rhs)
+            {
+                and_words(_self()._data(), rhs._data(), _common_words(rhs));
+                return _self();
+            }
+
+            inline Derived& operator|=(const Derived& rhs)
+            {
+                or_words(_self()._data(), rhs._data(), _common_words(rhs));
+                _trim();
+                return _self();
+            }
+
+            inline Derived& operator^=(const Derived& rhs)
+            {
+                xor_words(_self()._data(), rhs._data(), _common_words(rhs));
+                _trim();
+                return _self();
+            }
+
+            inline Derived operator~() const
+            {
+                Derived _result = _self();
+                _result.flip();
+                return _result;
+            }
+
+            inline Derived operator&(const Derived& rhs) const
+            {
+                Derived _result = _self();
+                _result &= rhs;
+                return _result;
+            }
+
+            inline Derived operator|(const Derived& rhs) const
+            {
+                Derived _result = _self();
+                _result |= rhs;
+                return _result;
+            }
+
+            inline Derived operator^(const Derived& rhs) const
+            {
+                Derived _result = _self();
+                _result ^= rhs;
+                return _result;
+            }
+
+            inline bool operator==(const Derived& rhs) const
+            {
+                return _self().size() == rhs.size() &&
+                    equal_words(_self()._data(), rhs._data(), _self()._word_count());
+            }
+
+            inline bool operator!=(const Derived& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            // The underlying words, bit `i` is bit `i % 64` of word `i / 64`
+            inline auto words()
+            {
+                u64* _words = _self()._data();
+                return span<u64*>{_words, _words + _self()._word_count(), _self()._word_count()};
+            }
+
+            inline auto words() const
+            {
+                const u64* _words = _self()._data();
+                return span<const u64*>{_words, _words + _self()._word_count(), _self()._word_count()};
+            }
+
+        private:
+            inline usize _common_words(const Derived& rhs) const
+            {
+                return _self()._word_count() < rhs._word_count() ?
+                    _self()._word_count() : rhs._word_count();
+            }
+        };
+    } // namespace bitset_detail
+
+    template <usize N>
+    class bitset
+        : public bitset_detail::bitset_base< bitset<N> >
+    {
+    private:
+        static constexpr usize _words_count = bitset_detail::words_for(N);
+
+        u64 _words[_words_count ? _words_count : 1] = {};
+
+        friend class bitset_detail::bitset_base<bitset>;
+
+        inline u64* _data()
+        {
+            return _words;
+        }
+
+        inline const u64* _data() const
+        {
+            return _words;
+        }
+
+        static constexpr usize _word_count()
+        {
+            return _words_count;
+        }
+
+    public:
+        inline bitset() = default;
+
+        static constexpr usize size()
+        {
+            return N;
+        }
+    };
+
+    template < template <typename> typename Allocator = allocator >
+    class dynamic_bitset
+        : public bitset_detail::bitset_base< dynamic_bitset<Allocator> >
+    {
+    private:
+        vector<u64, Allocator> _words;
+        usize _size = 0;
+
+        friend class bitset_detail::bitset_base<dynamic_bitset>;
+
+        inline u64* _data()
+        {
+            return _words.data();
+        }
+
+        inline const u64* _data() const
+        {
+            return _words.begin();
+        }
+
+        inline usize _word_count() const
+        {
+            return _words.size();
+        }
+
+    public:
+        inline dynamic_bitset()
+            requires (std::is_default_constructible_v<Allocator<u64>>)
+        {}
+
+        inline dynamic_bitset(usize size, bool value = false)
+            requires (std::is_default_constructible_v<Allocator<u64>>)
+        {
+            resize(size, value);
+        }
+
+        template <typename Alloc>
+        inline dynamic_bitset(usize size, const Alloc& alloc)
+        requires (std::is_constructible_v<Allocator<u64>, Alloc>)
+            : _words{alloc}
+        {
+            resize(size);
+        }
+
+        // New bits are set to `value`
+        inline void resize(usize size, bool value = false)
+        {
+            usize _old_size = _size;
+            usize _old_words = _words.size();
+            usize _new_words = bitset_detail::words_for(size);
+
+            if (_new_words > _old_words)
+            {
+                _words.reserve(_new_words);
+
+                for (usize _index = _old_words; _index < _new_words; _index++)
+                    _words.push_back(value ? ~0ull : 0ull);
+            }
+            else
+            {
+                _words.resize(_new_words);
+            }
+
+            _size = size;
+
+            if (value && _old_size < size && _old_size % bitset_detail::word_bits != 0)
+                _words[_old_words - 1] |= ~bitset_detail::tail_mask(_old_size);
+
+            if (_words.size() != 0)
+                _words[_words.size() - 1] &= bitset_detail::tail_mask(_size);
+        }
+
+        inline void push_back(bool value)
+        {
+            if (_size % bitset_detail::word_bits == 0)
+                _words.push_back(0);
+
+            this->set(_size++, value);
+        }
+
+        inline void clear()
+        {
+            _words.clear();
+            _size = 0;
+        }
+
+        inline void reserve(usize bits)
+        {
+            _words.reserve(bitset_detail::words_for(bits));
+        }
+
+        inline usize size() const
+        {
+            return _size;
+        }
+
+        inline bool empty() const
+        {
+            return _size == 0;
+        }
+    };
+
+    using buffered_dynamic_bitset = dynamic_bitset<buffered_allocator>;
+} // namespace hsd
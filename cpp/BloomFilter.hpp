@@ -0,0 +1,665 @@
+#pragma once
+
+#include "Result.hpp"
+#include "Hash.hpp"
+#include "Math.hpp"
+#include "Vector.hpp"
+#include "Allocator.hpp"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace hsd
+{
+    namespace bloom_detail
+    {
+        class bad_buffer
+        {
+        private:
+            const char* _err = nullptr;
+
+        public:
+            constexpr bad_buffer(const char* error)
+                : _err{error}
+            {}
+
+            const char* operator()() const
+            {
+                return _err;
+            }
+        };
+
+        // One block is one cache line, every key sets one bit in each of
+        // its 8 words, so a probe touches a single line of memory
+        struct alignas(64) block
+        {
+            u64 words[8];
+        };
+
+        // Four bit counters for the 512 bits of a block
+        struct alignas(64) counter_block
+        {
+            u64 nibbles[32];
+        };
+
+        static constexpr usize block_bits = 512;
+        static constexpr u64 counter_max = 15;
+
+        // Odd constants of the split block Bloom filter used by Parquet
+        // and Impala, each one picks the bit of a word from the same hash
+        static constexpr u32 salt[8] = {
+            0x47b6'137bu, 0x4497'4d91u, 0x8824'ad5bu, 0xa2b7'289du,
+            0x7054'95c7u, 0x2df1'424bu, 0x9efc'4947u, 0x5c6b'fb31u
+        };
+
+        static constexpr u32 magic = 0x4642'5348u; // "HSBF"
+        static constexpr u16 version = 1;
+        static constexpr usize header_size = 24;
+
+        enum class filter_kind : u16
+        {
+            plain = 0,
+            counting = 1
+        };
+
+        static inline u32 bit_index(u32 hash, usize word)
+        {
+            return (hash * salt[word]) >> 26;
+        }
+
+        static inline void make_masks(u32 hash, u64 (&masks)[8])
+        {
+            for (usize _word = 0; _word < 8; _word++)
+                masks[_word] = 1ull << bit_index(hash, _word);
+        }
+
+        static inline bool test(const block& blk, const u64 (&masks)[8])
+        {
+            #if defined(__SSE2__) || defined(_M_X64)
+            // (word & mask) == mask for all 8 words at once
+            __m128i _result = _mm_set1_epi32(-1);
+
+            for (usize _part = 0; _part < 4; _part++)
+            {
+                __m128i _words = _mm_loadu_si128(
+                    bit_cast<const __m128i*>(&blk.words[_part * 2])
+                );
+                __m128i _mask = _mm_loadu_si128(
+                    bit_cast<const __m128i*>(&masks[_part * 2])
+                );
+
+                _result = _mm_and_si128(_result, _mm_cmpeq_epi32(
+                    _mm_and_si128(_words, _mask), _mask
+                ));
+            }
+
+            return _mm_movemask_epi8(_result) == 0xffff;
+            #else
+            u64 _missing = 0;
+
+            for (usize _word = 0; _word < 8; _word++)
+                _missing |= masks[_word] & ~blk.words[_word];
+
+            return _missing == 0;
+            #endif
+        }
+
+        // Maps the high half of the hash onto [0, count) without a division
+        static inline usize block_index(u64 hash, usize count)
+        {
+            return static_cast<usize>(((hash >> 32) * static_cast<u64>(count)) >> 32);
+        }
+
+        static inline usize block_count(usize expected, f64 false_positive)
+        {
+            if (expected == 0)
+                expected = 1;
+
+            if (false_positive <= 0. || false_positive >= 1.)
+                false_positive = 0.01;
+
+            // The classic m = -n ln(p) / ln(2)^2, blocking makes the
+            // load uneven so a quarter more bits are added to make up
+            f64 _bits = -static_cast<f64>(expected) * math::log(false_positive) /
+                (0.4804530139182014 /* ln(2)^2 */) * 1.25;
+
+            usize _count = static_cast<usize>(_bits / block_bits) + 1;
+            return _count;
+        }
+
+        template <typename Hasher, typename U>
+        static inline u64 hash_key(const U& key)
+        {
+            return hash_detail::int_hash(static_cast<u64>(Hasher::get_hash(key)));
+        }
+
+        static inline void write_header(
+            uchar* buf, filter_kind kind, u64 count, u64 size)
+        {
+            u32 _magic = magic;
+            u16 _version = version;
+            u16 _kind = static_cast<u16>(kind);
+
+            memcpy(buf, &_magic, 4);
+            memcpy(buf + 4, &_version, 2);
+            memcpy(buf + 6, &_kind, 2);
+            memcpy(buf + 8, &count, 8);
+            memcpy(buf + 16, &size, 8);
+        }
+
+        static inline auto read_header(
+            const uchar* buf, usize size, filter_kind kind, usize block_bytes)
+            -> Result< pair<u64, u64>, bad_buffer >
+        {
+            if (size < header_size)
+                return bad_buffer{"Buffer too small for a filter header"};
+
+            u32 _magic;
+            u16 _version, _kind;
+            u64 _count, _size;
+
+            memcpy(&_magic, buf, 4);
+            memcpy(&_version, buf + 4, 2);
+            memcpy(&_kind, buf + 6, 2);
+            memcpy(&_count, buf + 8, 8);
+            memcpy(&_size, buf + 16, 8);
+
+            if (_magic != magic || _version != version)
+                return bad_buffer{"Not a serialized filter"};
+
+            if (_kind != static_cast<u16>(kind))
+                return bad_buffer{"Serialized filter is of another kind"};
+
+            if (_count == 0 || _count > (size - header_size) / block_bytes ||
+                size - header_size != _count * block_bytes)
+            {
+                return bad_buffer{"Buffer size doesn't match the filter"};
+            }
+
+            return pair<u64, u64>{_count, _size};
+        }
+    } // namespace bloom_detail
+
+    // Cache line blocked Bloom filter: a key selects one 64 byte block
+    // and sets 8 bits in it, one per word. It never reports a present
+    // key as absent, absent keys are reported present with roughly the
+    // false positive rate given on construction. The serialized form
+    // stores the words in native byte order, and both ends must use
+    // the same `Hasher` (which has to be deterministic across runs)
+    template < typename T, typename Hasher = hash<u64, T>,
+        template <typename> typename Allocator = allocator >
+    class bloom_filter
+    {
+    private:
+        using block_type = bloom_detail::block;
+
+        Allocator<block_type> _alloc;
+        block_type* _blocks = nullptr;
+        usize _count = 0;
+        usize _size = 0;
+
+        template < typename, typename, template <typename> typename >
+        friend class counting_bloom_filter;
+
+        inline void _allocate(usize count)
+        {
+            _count = count;
+            _blocks = _alloc.allocate(count).unwrap();
+            clear();
+        }
+
+        inline void _release()
+        {
+            if (_blocks != nullptr)
+            {
+                _alloc.deallocate(_blocks, _count).unwrap();
+                _blocks = nullptr;
+            }
+        }
+
+        inline block_type& _block(u64 hash) const
+        {
+            return _blocks[bloom_detail::block_index(hash, _count)];
+        }
+
+        // Sets the bits of `hash`, returns false if they were all set
+        inline bool _insert_hash(u64 hash)
+        {
+            u64 _masks[8];
+            bloom_detail::make_masks(static_cast<u32>(hash), _masks);
+            auto& _blk = _block(hash);
+            u64 _new_bits = 0;
+
+            for (usize _word = 0; _word < 8; _word++)
+            {
+                _new_bits |= _masks[_word] & ~_blk.words[_word];
+                _blk.words[_word] |= _masks[_word];
+            }
+
+            return _new_bits != 0;
+        }
+
+        inline bool _test_hash(u64 hash) const
+        {
+            u64 _masks[8];
+            bloom_detail::make_masks(static_cast<u32>(hash), _masks);
+            return bloom_detail::test(_block(hash), _masks);
+        }
+
+    public:
+        inline bloom_filter(usize expected_items, f64 false_positive = 0.01)
+        requires (std::is_default_constructible_v<Allocator<block_type>>)
+        {
+            _allocate(bloom_detail::block_count(expected_items, false_positive));
+        }
+
+        template <typename Alloc>
+        inline bloom_filter(usize expected_items, f64 false_positive, const Alloc& alloc)
+            : _alloc(alloc)
+        {
+            _allocate(bloom_detail::block_count(expected_items, false_positive));
+        }
+
+        inline bloom_filter(const bloom_filter& other)
+            : _alloc(other._alloc), _size{other._size}
+        {
+            _count = other._count;
+            _blocks = _alloc.allocate(_count).unwrap();
+            memcpy(_blocks, other._blocks, _count * sizeof(block_type));
+        }
+
+        inline bloom_filter(bloom_filter&& other)
+            : _alloc(move(other._alloc)),
+            _blocks{exchange(other._blocks, nullptr)},
+            _count{exchange(other._count, 0u)},
+            _size{exchange(other._size, 0u)}
+        {}
+
+        inline ~bloom_filter()
+        {
+            _release();
+        }
+
+        inline bloom_filter& operator=(const bloom_filter& rhs)
+        {
+            if (this != &rhs)
+            {
+                if (_count != rhs._count)
+                {
+                    _release();
+                    _count = rhs._count;
+                    _blocks = _alloc.allocate(_count).unwrap();
+                }
+
+                memcpy(_blocks, rhs._blocks, _count * sizeof(block_type));
+                _size = rhs._size;
+            }
+
+            return *this;
+        }
+
+        inline bloom_filter& operator=(bloom_filter&& rhs)
+        {
+            swap(_alloc, rhs._alloc);
+            swap(_blocks, rhs._blocks);
+            swap(_count, rhs._count);
+            swap(_size, rhs._size);
+            return *this;
+        }
+
+        template <typename U = T>
+        inline void insert(const U& key)
+        {
+            _insert_hash(bloom_detail::hash_key<Hasher>(key));
+            _size++;
+        }
+
+        // False means the key was never inserted, true means it
+        // probably was (see the false positive rate)
+        template <typename U = T>
+        inline bool contains(const U& key) const
+        {
+            return _test_hash(bloom_detail::hash_key<Hasher>(key));
+        }
+
+        // Adds every key of `other`, both filters must have the same size
+        inline auto merge(const bloom_filter& other)
+            -> Result< void, bloom_detail::bad_buffer >
+        {
+            if (other._count != _count)
+                return bloom_detail::bad_buffer{"Filters of different sizes"};
+
+            for (usize _index = 0; _index < _count; _index++)
+            {
+                for (usize _word = 0; _word < 8; _word++)
+                    _blocks[_index].words[_word] |= other._blocks[_index].words[_word];
+            }
+
+            _size += other._size;
+            return {};
+        }
+
+        inline void clear()
+        {
+            memset(_blocks, 0, _count * sizeof(block_type));
+            _size = 0;
+        }
+
+        // Number of insertions (a key inserted twice counts twice)
+        inline usize size() const
+        {
+            return _size;
+        }
+
+        inline usize block_count() const
+        {
+            return _count;
+        }
+
+        inline usize bit_count() const
+        {
+            return _count * bloom_detail::block_bits;
+        }
+
+        inline usize serialized_size() const
+        {
+            return bloom_detail::header_size + _count * sizeof(block_type);
+        }
+
+        inline auto serialize(uchar* buf, usize size) const
+            -> Result< usize, bloom_detail::bad_buffer >
+        {
+            if (size < serialized_size())
+                return bloom_detail::bad_buffer{"Buffer too small for the filter"};
+
+            bloom_detail::write_header(
+                buf, bloom_detail::filter_kind::plain, _count, _size
+            );
+
+            memcpy(buf + bloom_detail::header_size, _blocks, _count * sizeof(block_type));
+            return serialized_size();
+        }
+
+        inline vector<uchar> serialize() const
+        {
+            vector<uchar> _buf(serialized_size());
+            serialize(_buf.data(), _buf.size()).unwrap();
+            return _buf;
+        }
+
+        template < typename... Alloc >
+        static inline auto deserialize(const uchar* buf, usize size, const Alloc&... alloc)
+            -> Result< bloom_filter, bloom_detail::bad_buffer >
+        {
+            auto _header = bloom_detail::read_header(
+                buf, size, bloom_detail::filter_kind::plain, sizeof(block_type)
+            );
+
+            if (!_header)
+                return _header.unwrap_err();
+
+            auto [_block_count, _item_count] = _header.unwrap();
+            bloom_filter _filter{1, 0.5, alloc...};
+
+            if (_block_count != _filter._count)
+            {
+                _filter._release();
+                _filter._allocate(_block_count);
+            }
+
+            memcpy(
+                _filter._blocks, buf + bloom_detail::header_size,
+                _block_count * sizeof(block_type)
+            );
+
+            _filter._size = _item_count;
+            return _filter;
+        }
+    };
+
+    // Bloom filter that supports erasing keys, each bit gets a four bit
+    // counter next to the bit blocks. The bits are kept in sync with the
+    // counters, so `contains` is exactly the probe of bloom_filter and
+    // the counters are only touched by insertions and erasures. A
+    // counter that reaches 15 sticks there, its bit is never cleared
+    template < typename T, typename Hasher = hash<u64, T>,
+        template <typename> typename Allocator = allocator >
+    class counting_bloom_filter
+    {
+    private:
+        using bits_type = bloom_filter<T, Hasher, Allocator>;
+        using counters_type = bloom_detail::counter_block;
+
+        bits_type _bits;
+        Allocator<counters_type> _alloc;
+        counters_type* _counters = nullptr;
+
+        inline void _allocate()
+        {
+            _counters = _alloc.allocate(_bits._count).unwrap();
+            memset(_counters, 0, _bits._count * sizeof(counters_type));
+        }
+
+        inline void _release()
+        {
+            if (_counters != nullptr)
+            {
+                _alloc.deallocate(_counters, _bits._count).unwrap();
+                _counters = nullptr;
+            }
+        }
+
+        inline counters_type& _counter_block(u64 hash) const
+        {
+            return _counters[bloom_detail::block_index(hash, _bits._count)];
+        }
+
+        struct counter_pos
+        {
+            usize index;
+            usize shift;
+        };
+
+        static inline counter_pos _position(u32 hash, usize word)
+        {
+            u32 _bit = bloom_detail::bit_index(hash, word);
+            return {word * 4 + _bit / 16, (_bit % 16) * 4};
+        }
+
+    public:
+        inline counting_bloom_filter(usize expected_items, f64 false_positive = 0.01)
+        requires (std::is_default_constructible_v<Allocator<counters_type>>)
+            : _bits{expected_items, false_positive}
+        {
+            _allocate();
+        }
+
+        template <typename Alloc>
+        inline counting_bloom_filter(
+            usize expected_items, f64 false_positive, const Alloc& alloc)
+            : _bits{expected_items, false_positive, alloc}, _alloc(alloc)
+        {
+            _allocate();
+        }
+
+        inline counting_bloom_filter(const counting_bloom_filter& other)
+            : _bits{other._bits}, _alloc(other._alloc)
+        {
+            _counters = _alloc.allocate(_bits._count).unwrap();
+            memcpy(_counters, other._counters, _bits._count * sizeof(counters_type));
+        }
+
+        inline counting_bloom_filter(counting_bloom_filter&& other)
+            : _bits{move(other._bits)}, _alloc(move(other._alloc)),
+            _counters{exchange(other._counters, nullptr)}
+        {}
+
+        inline ~counting_bloom_filter()
+        {
+            _release();
+        }
+
+        counting_bloom_filter& operator=(const counting_bloom_filter&) = delete;
+
+        inline counting_bloom_filter& operator=(counting_bloom_filter&& rhs)
+        {
+            _release();
+            _bits = move(rhs._bits);
+            swap(_alloc, rhs._alloc);
+            _counters = exchange(rhs._counters, nullptr);
+            return *this;
+        }
+
+        template <typename U = T>
+        inline void insert(const U& key)
+        {
+            u64 _hash = bloom_detail::hash_key<Hasher>(key);
+            auto& _blk = _counter_block(_hash);
+
+            for (usize _word = 0; _word < 8; _word++)
+            {
+                auto [_index, _shift] = _position(static_cast<u32>(_hash), _word);
+
+                if (((_blk.nibbles[_index] >> _shift) & 0xf) != bloom_detail::counter_max)
+                    _blk.nibbles[_index] += 1ull << _shift;
+            }
+
+            _bits._insert_hash(_hash);
+            _bits._size++;
+        }
+
+        // Only keys that were inserted may be erased, erasing anything
+        // else can remove other keys. Returns false (and does nothing)
+        // if the key is certainly not in the filter
+        template <typename U = T>
+        inline bool erase(const U& key)
+        {
+            u64 _hash = bloom_detail::hash_key<Hasher>(key);
+
+            if (!_bits._test_hash(_hash))
+                return false;
+
+            auto& _blk = _counter_block(_hash);
+            auto& _bit_blk = _bits._block(_hash);
+
+            for (usize _word = 0; _word < 8; _word++)
+            {
+                auto [_index, _shift] = _position(static_cast<u32>(_hash), _word);
+                u64 _counter = (_blk.nibbles[_index] >> _shift) & 0xf;
+
+                if (_counter == bloom_detail::counter_max)
+                    continue;
+
+                _blk.nibbles[_index] -= 1ull << _shift;
+
+                if (_counter == 1)
+                {
+                    _bit_blk.words[_word] &=
+                        ~(1ull << bloom_detail::bit_index(static_cast<u32>(_hash), _word));
+                }
+            }
+
+            _bits._size--;
+            return true;
+        }
+
+        template <typename U = T>
+        inline bool contains(const U& key) const
+        {
+            return _bits.contains(key);
+        }
+
+        // The plain filter with the same bits, to ship the lookup
+        // side only (it is 5 times smaller than the counting one)
+        inline const bits_type& bits() const
+        {
+            return _bits;
+        }
+
+        inline void clear()
+        {
+            _bits.clear();
+            memset(_counters, 0, _bits._count * sizeof(counters_type));
+        }
+
+        inline usize size() const
+        {
+            return _bits.size();
+        }
+
+        inline usize block_count() const
+        {
+            return _bits.block_count();
+        }
+
+        inline usize serialized_size() const
+        {
+            return bloom_detail::header_size +
+                _bits._count * (sizeof(bloom_detail::block) + sizeof(counters_type));
+        }
+
+        inline auto serialize(uchar* buf, usize size) const
+            -> Result< usize, bloom_detail::bad_buffer >
+        {
+            if (size < serialized_size())
+                return bloom_detail::bad_buffer{"Buffer too small for the filter"};
+
+            usize _bits_size = _bits._count * sizeof(bloom_detail::block);
+            bloom_detail::write_header(
+                buf, bloom_detail::filter_kind::counting, _bits._count, _bits._size
+            );
+
+            memcpy(buf + bloom_detail::header_size, _bits._blocks, _bits_size);
+            memcpy(
+                buf + bloom_detail::header_size + _bits_size, _counters,
+                _bits._count * sizeof(counters_type)
+            );
+
+            return serialized_size();
+        }
+
+        inline vector<uchar> serialize() const
+        {
+            vector<uchar> _buf(serialized_size());
+            serialize(_buf.data(), _buf.size()).unwrap();
+            return _buf;
+        }
+
+        template < typename... Alloc >
+        static inline auto deserialize(const uchar* buf, usize size, const Alloc&... alloc)
+            -> Result< counting_bloom_filter, bloom_detail::bad_buffer >
+        {
+            auto _header = bloom_detail::read_header(
+                buf, size, bloom_detail::filter_kind::counting,
+                sizeof(bloom_detail::block) + sizeof(counters_type)
+            );
+
+            if (!_header)
+                return _header.unwrap_err();
+
+            auto [_block_count, _item_count] = _header.unwrap();
+            counting_bloom_filter _filter{1, 0.5, alloc...};
+
+            if (_block_count != _filter._bits._count)
+            {
+                _filter._release();
+                _filter._bits._release();
+                _filter._bits._allocate(_block_count);
+                _filter._allocate();
+            }
+
+            usize _bits_size = _block_count * sizeof(bloom_detail::block);
+            memcpy(_filter._bits._blocks, buf + bloom_detail::header_size, _bits_size);
+            memcpy(
+                _filter._counters, buf + bloom_detail::header_size + _bits_size,
+                _block_count * sizeof(counters_type)
+            );
+
+            _filter._bits._size = _item_count;
+            return _filter;
+        }
+    };
+} // namespace hsd
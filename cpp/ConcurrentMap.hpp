@@ -0,0 +1,416 @@
+#pragma once
+
+#include "UnorderedMap.hpp"
+#include "Atomic.hpp"
+
+namespace hsd
+{
+    namespace cmap_detail
+    {
+        static inline void cpu_relax()
+        {
+            #if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+            #elif defined(__aarch64__)
+            asm volatile("yield");
+            #endif
+        }
+
+        // Writer preferring reader-writer spinlock: the lowest bit
+        // is the writer flag and every reader adds 2, once a writer
+        // has set its flag no new readers get in and it only waits
+        // for the ones already inside to leave
+        class rw_spinlock
+        {
+        private:
+            static constexpr u32 _writer = 1;
+            static constexpr u32 _reader = 2;
+
+            atomic_u32 _state = {0};
+
+        public:
+            inline void lock_shared()
+            {
+                while (true)
+                {
+                    u32 _current = _state.load(memory_order_relaxed);
+
+                    if ((_current & _writer) == 0 && _state.compare_exchange_weak(
+                        _current, _current + _reader,
+                        memory_order_acquire, memory_order_relaxed))
+                    {
+                        return;
+                    }
+
+                    cpu_relax();
+                }
+            }
+
+            inline void unlock_shared()
+            {
+                _state.fetch_sub(_reader, memory_order_release);
+            }
+
+            inline void lock()
+            {
+                while (true)
+                {
+                    u32 _current = _state.load(memory_order_relaxed);
+
+                    if ((_current & _writer) == 0 && _state.compare_exchange_weak(
+                        _current, _current | _writer,
+                        memory_order_acquire, memory_order_relaxed))
+                    {
+                        break;
+                    }
+
+                    cpu_relax();
+                }
+
+                while (_state.load(memory_order_acquire) != _writer)
+                    cpu_relax();
+            }
+
+            inline void unlock()
+            {
+                _state.store(0, memory_order_release);
+            }
+        };
+
+        class shared_guard
+        {
+        private:
+            rw_spinlock& _lock;
+
+        public:
+            inline shared_guard(rw_spinlock& lock)
+                : _lock{lock}
+            {
+                _lock.lock_shared();
+            }
+
+            inline ~shared_guard()
+            {
+                _lock.unlock_shared();
+            }
+        };
+
+        class unique_guard
+        {
+        private:
+            rw_spinlock& _lock;
+
+        public:
+            inline unique_guard(rw_spinlock& lock)
+                : _lock{lock}
+            {
+                _lock.lock();
+            }
+
+            inline ~unique_guard()
+            {
+                _lock.unlock();
+            }
+        };
+
+        // Each shard gets its own cache lines, so a writer on
+        // one shard doesn't invalidate the lock of its neighbours
+        template < typename Map >
+        struct alignas(64) shard
+        {
+            mutable rw_spinlock lock;
+            Map map;
+        };
+    } // namespace cmap_detail
+
+    // Hash map that can be shared between threads, the keys are spread
+    // over `Shards` independent unordered_maps, each one guarded by
+    // its own reader-writer spinlock. Values are handed out by copy
+    // (`find`) or through a callback that runs under the lock (`visit`,
+    // `update`), references never outlive the lock of their shard
+    template < typename Key, typename T, typename Hasher = hash<usize, Key>,
+        usize Shards = 32, template <typename> typename Allocator = allocator >
+    class concurrent_umap
+    {
+    private:
+        static_assert(
+            Shards != 0 && (Shards & (Shards - 1)) == 0,
+            "The number of shards must be a power of two"
+        );
+
+        using map_type = unordered_map<Key, T, Hasher, Allocator>;
+        using shard_type = cmap_detail::shard<map_type>;
+
+        shard_type _shards[Shards];
+
+        // The maps inside use the low bits of a Fibonacci mix of
+        // the same hash, so the shard is taken from a different mix
+        template <typename U>
+        static inline usize _shard_index(const U& key)
+        {
+            if constexpr (umap_detail::DirectLookup<Hasher, Key, U>)
+            {
+                return static_cast<usize>(hash_detail::int_hash(
+                    static_cast<u64>(Hasher::get_hash(key))
+                ) >> 32) & (Shards - 1);
+            }
+            else
+            {
+                return _shard_index(Key(key));
+            }
+        }
+
+        template <typename U>
+        inline shard_type& _shard_for(const U& key)
+        {
+            return _shards[_shard_index(key)];
+        }
+
+        template <typename U>
+        inline const shard_type& _shard_for(const U& key) const
+        {
+            return _shards[_shard_index(key)];
+        }
+
+    public:
+        inline concurrent_umap() = default;
+        concurrent_umap(const concurrent_umap&) = delete;
+        concurrent_umap& operator=(const concurrent_umap&) = delete;
+
+        // Returns a copy of the value, the map may change right after
+        template <typename U = Key>
+        inline auto find(const U& key) const
+            -> Result< T, umap_detail::bad_key >
+        {
+            auto& _shard = _shard_for(key);
+            cmap_detail::shared_guard _guard{_shard.lock};
+            auto _iter = _shard.map.find(key);
+
+            if (_iter == _shard.map.end())
+                return umap_detail::bad_key{};
+
+            return T{_iter->second};
+        }
+
+        template <typename U = Key>
+        inline bool contains(const U& key) const
+        {
+            auto& _shard = _shard_for(key);
+            cmap_detail::shared_guard _guard{_shard.lock};
+            return _shard.map.contains(key);
+        }
+
+        // Calls `func(const T&)` under a shared lock, returns false if
+        // there is no such key. `func` must not touch the map itself
+        template < typename U, typename Func >
+        inline bool visit(const U& key, Func&& func) const
+        {
+            auto& _shard = _shard_for(key);
+            cmap_detail::shared_guard _guard{_shard.lock};
+            auto _iter = _shard.map.find(key);
+
+            if (_iter == _shard.map.end())
+                return false;
+
+            func(static_cast<const T&>(_iter->second));
+            return true;
+        }
+
+        // Calls `func(T&)` under an exclusive lock, returns false if
+        // there is no such key. `func` must not touch the map itself
+        template < typename U, typename Func >
+        inline bool update(const U& key, Func&& func)
+        {
+            auto& _shard = _shard_for(key);
+            cmap_detail::unique_guard _guard{_shard.lock};
+            auto _iter = _shard.map.find(key);
+
+            if (_iter == _shard.map.end())
+                return false;
+
+            func(_iter->second);
+            return true;
+        }
+
+        // Returns true if the key was inserted, false if it was assigned
+        template < typename NewKey, typename Value >
+        inline bool insert_or_assign(NewKey&& key, Value&& value)
+        {
+            auto& _shard = _shard_for(key);
+            cmap_detail::unique_guard _guard{_shard.lock};
+            return _insert_or_assign(
+                _shard.map, forward<NewKey>(key), forward<Value>(value)
+            );
+        }
+
+        template < typename NewKey, typename... Args >
+        inline bool try_emplace(NewKey&& key, Args&&... args)
+        {
+            auto& _shard = _shard_for(key);
+            cmap_detail::unique_guard _guard{_shard.lock};
+            return _shard.map.try_emplace(
+                forward<NewKey>(key), forward<Args>(args)...
+            ).second;
+        }
+
+        template <typename U = Key>
+        inline bool erase(const U& key)
+        {
+            auto& _shard = _shard_for(key);
+            cmap_detail::unique_guard _guard{_shard.lock};
+            auto _iter = _shard.map.find(key);
+
+            if (_iter == _shard.map.end())
+                return false;
+
+            _shard.map.erase(_iter).unwrap();
+            return true;
+        }
+
+        // Erases every element for which `pred(const Key&, T&)` is
+        // true, one shard at a time, and returns how many were erased
+        template < typename Pred >
+        inline usize erase_if(Pred&& pred)
+        {
+            usize _count = 0;
+
+            for (auto& _shard : _shards)
+            {
+                cmap_detail::unique_guard _guard{_shard.lock};
+
+                for (auto _iter = _shard.map.begin(); _iter != _shard.map.end();)
+                {
+                    if (pred(static_cast<const Key&>(_iter->first), _iter->second))
+                    {
+                        _iter = _shard.map.erase(_iter).unwrap();
+                        _count++;
+                    }
+                    else
+                    {
+                        _iter++;
+                    }
+                }
+            }
+
+            return _count;
+        }
+
+        // Inserts or assigns every pair in [first, last), the pairs
+        // are grouped by shard first so each lock is taken only once
+        template < typename Iter >
+        inline void insert_or_assign_batch(Iter first, Iter last)
+        {
+            usize _offsets[Shards + 1] = {};
+            vector<usize> _shard_ids;
+            vector<Iter> _order;
+
+            for (Iter _iter = first; _iter != last; _iter++)
+            {
+                usize _index = _shard_index((*_iter).first);
+                _shard_ids.push_back(_index);
+                _offsets[_index + 1]++;
+            }
+
+            for (usize _index = 0; _index < Shards; _index++)
+                _offsets[_index + 1] += _offsets[_index];
+
+            _order.resize(_shard_ids.size());
+            usize _pos = 0;
+
+            // Stable counting sort, the last pair of a key still wins
+            for (Iter _iter = first; _iter != last; _iter++, _pos++)
+                _order[_offsets[_shard_ids[_pos]]++] = _iter;
+
+            usize _begin = 0;
+
+            for (usize _index = 0; _index < Shards; _index++)
+            {
+                // `_offsets[_index]` now marks the end of the shard
+                usize _end = _offsets[_index];
+
+                if (_begin == _end)
+                    continue;
+
+                auto& _shard = _shards[_index];
+                cmap_detail::unique_guard _guard{_shard.lock};
+
+                for (; _begin != _end; _begin++)
+                {
+                    _insert_or_assign(
+                        _shard.map, (*_order[_begin]).first,
+                        (*_order[_begin]).second
+                    );
+                }
+            }
+        }
+
+        // Calls `func(const Key&, const T&)` for every element,
+        // each shard is consistent but the map as a whole isn't
+        template < typename Func >
+        inline void for_each(Func&& func) const
+        {
+            for (auto& _shard : _shards)
+            {
+                cmap_detail::shared_guard _guard{_shard.lock};
+
+                for (auto& [_key, _value] : _shard.map)
+                    func(_key, _value);
+            }
+        }
+
+        inline void reserve(usize count)
+        {
+            for (auto& _shard : _shards)
+            {
+                cmap_detail::unique_guard _guard{_shard.lock};
+                _shard.map.reserve(count / Shards + 1);
+            }
+        }
+
+        inline void clear()
+        {
+            for (auto& _shard : _shards)
+            {
+                cmap_detail::unique_guard _guard{_shard.lock};
+                _shard.map.clear();
+            }
+        }
+
+        inline usize size() const
+        {
+            usize _size = 0;
+
+            for (auto& _shard : _shards)
+            {
+                cmap_detail::shared_guard _guard{_shard.lock};
+                _size += _shard.map.size();
+            }
+
+            return _size;
+        }
+
+        inline bool empty() const
+        {
+            return size() == 0;
+        }
+
+        static constexpr usize shard_count()
+        {
+            return Shards;
+        }
+
+    private:
+        template < typename NewKey, typename Value >
+        static inline bool _insert_or_assign(map_type& map, NewKey&& key, Value&& value)
+        {
+            auto [_iter, _inserted] = map.try_emplace(
+                forward<NewKey>(key), forward<Value>(value)
+            );
+
+            if (!_inserted)
+                _iter->second = forward<Value>(value);
+
+            return _inserted;
+        }
+    };
+} // namespace hsd
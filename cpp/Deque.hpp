@@ -0,0 +1,621 @@
+#pragma once
+
+#include "Result.hpp"
+#include "Reference.hpp"
+#include "Allocator.hpp"
+
+namespace hsd
+{
+    namespace deque_detail
+    {
+        struct bad_access
+        {
+            const char* operator()() const
+            {
+                return "Tried to access an element out of bounds";
+            }
+        };
+
+        // Blocks are sized in bytes like the btree nodes, the element
+        // count is rounded down to a power of two so that finding the
+        // block of an index is a shift and a mask (with a floor of 4)
+        static constexpr usize default_block_size = 4096;
+
+        template < typename T, usize BlockSize >
+        static constexpr usize block_elements()
+        {
+            usize _count = 4;
+
+            while (_count * 2 * sizeof(T) <= BlockSize)
+                _count *= 2;
+
+            return _count;
+        }
+
+        template < typename T, usize BlockElems >
+        class iterator
+        {
+        private:
+            using block_type = remove_cv_t<T>*;
+
+            block_type const* _blocks = nullptr;
+            usize _pos = 0;
+
+            template < typename, usize >
+            friend class iterator;
+
+        public:
+            using value_type = remove_cv_t<T>;
+
+            inline iterator() = default;
+
+            inline iterator(block_type const* blocks, usize pos)
+                : _blocks{blocks}, _pos{pos}
+            {}
+
+            template <typename U>
+            requires (IsSame<const U, T>)
+            inline iterator(const iterator<U, BlockElems>& other)
+                : _blocks{other._blocks}, _pos{other._pos}
+            {}
+
+            inline bool operator==(const iterator& rhs) const
+            {
+                return _pos == rhs._pos;
+            }
+
+            inline bool operator!=(const iterator& rhs) const
+            {
+                return _pos != rhs._pos;
+            }
+
+            inline bool operator<(const iterator& rhs) const
+            {
+                return _pos < rhs._pos;
+            }
+
+            inline iterator& operator++()
+            {
+                _pos++;
+                return *this;
+            }
+
+            inline iterator operator++(i32)
+            {
+                iterator _tmp = *this;
+                _pos++;
+                return _tmp;
+            }
+
+            inline iterator& operator--()
+            {
+                _pos--;
+                return *this;
+            }
+
+            inline iterator operator--(i32)
+            {
+                iterator _tmp = *this;
+                _pos--;
+                return _tmp;
+            }
+
+            inline iterator& operator+=(isize offset)
+            {
+                _pos += static_cast<usize>(offset);
+                return *this;
+            }
+
+            inline iterator& operator-=(isize offset)
+            {
+                _pos -= static_cast<usize>(offset);
+                return *this;
+            }
+
+            inline iterator operator+(isize offset) const
+            {
+                return {_blocks, _pos + static_cast<usize>(offset)};
+            }
+
+            inline iterator operator-(isize offset) const
+            {
+                return {_blocks, _pos - static_cast<usize>(offset)};
+            }
+
+            inline isize operator-(const iterator& rhs) const
+            {
+                return static_cast<isize>(_pos - rhs._pos);
+            }
+
+            inline T& operator*() const
+            {
+                return _blocks[_pos / BlockElems][_pos % BlockElems];
+            }
+
+            inline T* operator->() const
+            {
+                return &operator*();
+            }
+
+            inline T& operator[](isize offset) const
+            {
+                return *(*this + offset);
+            }
+        };
+    } // namespace deque_detail
+
+    // Double ended queue made of fixed size blocks, pushing and popping
+    // at both ends is O(1) and never moves the other elements, so the
+    // references to them stay valid (the iterators don't, the table
+    // of blocks may be reallocated). `BlockSize` is in bytes
+    template < typename T, template <typename> typename Allocator = allocator,
+        usize BlockSize = deque_detail::default_block_size >
+    class deque
+    {
+    private:
+        static constexpr usize _block_size = deque_detail::block_elements<T, BlockSize>();
+
+        using alloc_type = Allocator<T>;
+        using map_alloc_type = Allocator<T*>;
+
+        alloc_type _alloc;
+        T** _map = nullptr;
+        usize _map_capacity = 0;
+        usize _map_first = 0;
+        usize _map_used = 0;
+        usize _head = 0;
+        usize _size = 0;
+        // One emptied block is kept around, so that popping and pushing
+        // right at a block boundary doesn't allocate every time
+        T* _spare = nullptr;
+
+        inline T& _slot(usize index) const
+        {
+            usize _pos = _head + index;
+            return _map[_map_first + _pos / _block_size][_pos % _block_size];
+        }
+
+        inline T* _new_block()
+        {
+            if (_spare != nullptr)
+                return exchange(_spare, nullptr);
+
+            return _alloc.allocate(_block_size).unwrap();
+        }
+
+        inline void _drop_block(T* block)
+        {
+            if (_spare == nullptr)
+                _spare = block;
+            else
+                _alloc.deallocate(block, _block_size).unwrap();
+        }
+
+        // Makes room in the table for one more block at the front or
+        // at the back, by centering the used part or by growing it
+        inline void _reserve_map(bool at_front)
+        {
+            if (at_front ? _map_first != 0 : _map_first + _map_used != _map_capacity)
+                return;
+
+            if (_map_used * 2 < _map_capacity)
+            {
+                usize _new_first = (_map_capacity - _map_used) / 2;
+
+                if (at_front && _new_first == 0)
+                    _new_first = 1;
+
+                memmove(_map + _new_first, _map + _map_first, _map_used * sizeof(T*));
+                _map_first = _new_first;
+            }
+            else
+            {
+                map_alloc_type _map_alloc{_alloc};
+                usize _new_capacity = _map_capacity ? _map_capacity * 2 : 8;
+                T** _new_map = _map_alloc.allocate(_new_capacity).unwrap();
+                usize _new_first = (_new_capacity - _map_used) / 2;
+
+                if (_map_used != 0)
+                    memcpy(_new_map + _new_first, _map + _map_first, _map_used * sizeof(T*));
+
+                if (_map != nullptr)
+                    _map_alloc.deallocate(_map, _map_capacity).unwrap();
+
+                _map = _new_map;
+                _map_capacity = _new_capacity;
+                _map_first = _new_first;
+            }
+        }
+
+        inline void _free_all()
+        {
+            clear();
+
+            if (_spare != nullptr)
+                _alloc.deallocate(exchange(_spare, nullptr), _block_size).unwrap();
+
+            if (_map != nullptr)
+            {
+                map_alloc_type _map_alloc{_alloc};
+                _map_alloc.deallocate(exchange(_map, nullptr), _map_capacity).unwrap();
+            }
+
+            _map_capacity = 0;
+            _map_first = 0;
+        }
+
+        inline void _steal(deque& other)
+        {
+            _map = exchange(other._map, nullptr);
+            _map_capacity = exchange(other._map_capacity, 0u);
+            _map_first = exchange(other._map_first, 0u);
+            _map_used = exchange(other._map_used, 0u);
+            _head = exchange(other._head, 0u);
+            _size = exchange(other._size, 0u);
+            _spare = exchange(other._spare, nullptr);
+        }
+
+    public:
+        using value_type = T;
+        using iterator = deque_detail::iterator<T, _block_size>;
+        using const_iterator = deque_detail::iterator<const T, _block_size>;
+
+        inline ~deque()
+        {
+            _free_all();
+        }
+
+        inline deque()
+            requires (std::is_default_constructible_v<alloc_type>)
+        {}
+
+        template <typename Alloc = alloc_type>
+        inline deque(const Alloc& alloc)
+        requires (std::is_constructible_v<alloc_type, Alloc>)
+            : _alloc(alloc)
+        {}
+
+        inline deque(const deque& other)
+            : _alloc(other._alloc)
+        {
+            for (usize _index = 0; _index < other._size; _index++)
+                emplace_back(other._slot(_index));
+        }
+
+        inline deque(deque&& other)
+            : _alloc(other._alloc)
+        {
+            _steal(other);
+        }
+
+        template <usize N>
+        inline deque(const T (&arr)[N])
+        {
+            for (usize _index = 0; _index < N; _index++)
+                emplace_back(arr[_index]);
+        }
+
+        template <usize N>
+        inline deque(T (&&arr)[N])
+        {
+            for (usize _index = 0; _index < N; _index++)
+                emplace_back(move(arr[_index]));
+        }
+
+        inline deque& operator=(const deque& rhs)
+        {
+            if (this != &rhs)
+            {
+                clear();
+
+                for (usize _index = 0; _index < rhs._size; _index++)
+                    emplace_back(rhs._slot(_index));
+            }
+
+            return *this;
+        }
+
+        inline deque& operator=(deque&& rhs)
+        {
+            if (this != &rhs)
+            {
+                _free_all();
+                _alloc = rhs._alloc;
+                _steal(rhs);
+            }
+
+            return *this;
+        }
+
+        inline auto& operator[](usize index)
+        {
+            return _slot(index);
+        }
+
+        inline auto& operator[](usize index) const
+        {
+            return static_cast<const T&>(_slot(index));
+        }
+
+        inline auto at(usize index)
+            -> Result<reference<T>, deque_detail::bad_access>
+        {
+            if (index >= _size)
+                return deque_detail::bad_access{};
+
+            return {_slot(index)};
+        }
+
+        inline auto at(usize index) const
+            -> Result< const reference<T>, deque_detail::bad_access >
+        {
+            if (index >= _size)
+                return deque_detail::bad_access{};
+
+            return {_slot(index)};
+        }
+
+        inline auto& at_unchecked(usize index)
+        {
+            return _slot(index);
+        }
+
+        inline const auto& at_unchecked(usize index) const
+        {
+            return _slot(index);
+        }
+
+        inline auto& front()
+        {
+            return _slot(0);
+        }
+
+        inline auto& front() const
+        {
+            return static_cast<const T&>(_slot(0));
+        }
+
+        inline auto& back()
+        {
+            return _slot(_size - 1);
+        }
+
+        inline auto& back() const
+        {
+            return static_cast<const T&>(_slot(_size - 1));
+        }
+
+        inline void push_back(const T& value)
+        {
+            emplace_back(value);
+        }
+
+        inline void push_back(T&& value)
+        {
+            emplace_back(move(value));
+        }
+
+        inline void push_front(const T& value)
+        {
+            emplace_front(value);
+        }
+
+        inline void push_front(T&& value)
+        {
+            emplace_front(move(value));
+        }
+
+        template <typename... Args>
+        inline T& emplace_back(Args&&... args)
+        {
+            if (_head + _size == _map_used * _block_size)
+            {
+                _reserve_map(false);
+                _map[_map_first + _map_used] = _new_block();
+                _map_used++;
+            }
+
+            T* _ptr = &_slot(_size);
+            _alloc.construct_at(_ptr, forward<Args>(args)...);
+            _size++;
+            return *_ptr;
+        }
+
+        template <typename... Args>
+        inline T& emplace_front(Args&&... args)
+        {
+            if (_head == 0)
+            {
+                _reserve_map(true);
+                _map_first--;
+                _map[_map_first] = _new_block();
+                _map_used++;
+                _head = _block_size;
+            }
+
+            T* _ptr = &_map[_map_first][_head - 1];
+            _alloc.construct_at(_ptr, forward<Args>(args)...);
+            _head--;
+            _size++;
+            return *_ptr;
+        }
+
+        inline void pop_back() noexcept
+        {
+            if (_size == 0)
+                return;
+
+            _slot(_size - 1).~T();
+            _size--;
+
+            if (_head + _size <= (_map_used - 1) * _block_size)
+            {
+                _map_used--;
+                _drop_block(_map[_map_first + _map_used]);
+            }
+
+            if (_size == 0)
+                _reset_empty();
+        }
+
+        inline void pop_front() noexcept
+        {
+            if (_size == 0)
+                return;
+
+            _slot(0).~T();
+            _head++;
+            _size--;
+
+            if (_head == _block_size)
+            {
+                _drop_block(_map[_map_first]);
+                _map_first++;
+                _map_used--;
+                _head = 0;
+            }
+
+            if (_size == 0)
+                _reset_empty();
+        }
+
+        inline void clear()
+        {
+            for (usize _index = _size; _index > 0; _index--)
+                _slot(_index - 1).~T();
+
+            for (usize _index = 0; _index < _map_used; _index++)
+                _drop_block(_map[_map_first + _index]);
+
+            _size = 0;
+            _map_used = 0;
+            _reset_empty();
+        }
+
+        // Returns the spare block and shrinks the table of blocks
+        inline void shrink_to_fit()
+        {
+            if (_spare != nullptr)
+                _alloc.deallocate(exchange(_spare, nullptr), _block_size).unwrap();
+
+            if (_map != nullptr && _map_used * 4 < _map_capacity)
+            {
+                map_alloc_type _map_alloc{_alloc};
+
+                if (_map_used == 0)
+                {
+                    _map_alloc.deallocate(exchange(_map, nullptr), _map_capacity).unwrap();
+                    _map_capacity = 0;
+                    _map_first = 0;
+                }
+                else
+                {
+                    usize _new_capacity = _map_used + 2;
+                    T** _new_map = _map_alloc.allocate(_new_capacity).unwrap();
+                    memcpy(_new_map + 1, _map + _map_first, _map_used * sizeof(T*));
+                    _map_alloc.deallocate(_map, _map_capacity).unwrap();
+                    _map = _new_map;
+                    _map_capacity = _new_capacity;
+                    _map_first = 1;
+                }
+            }
+        }
+
+        inline usize size() const
+        {
+            return _size;
+        }
+
+        inline bool empty() const
+        {
+            return _size == 0;
+        }
+
+        static constexpr usize block_size()
+        {
+            return _block_size;
+        }
+
+        inline iterator begin()
+        {
+            return {_map + _map_first, _head};
+        }
+
+        inline iterator end()
+        {
+            return {_map + _map_first, _head + _size};
+        }
+
+        inline const_iterator begin() const
+        {
+            return cbegin();
+        }
+
+        inline const_iterator end() const
+        {
+            return cend();
+        }
+
+        inline const_iterator cbegin() const
+        {
+            return {_map + _map_first, _head};
+        }
+
+        inline const_iterator cend() const
+        {
+            return {_map + _map_first, _head + _size};
+        }
+
+    private:
+        // With no elements left the next push may go either way,
+        // so the remaining table space is split between the ends
+        inline void _reset_empty()
+        {
+            _head = 0;
+
+            if (_map_used == 0)
+                _map_first = _map_capacity / 2;
+        }
+    };
+
+    // Vector whose elements never move: it grows by adding blocks,
+    // so pointers and references stay valid for as long as their
+    // element is there. Only the back can grow or shrink
+    template < typename T, template <typename> typename Allocator = allocator,
+        usize BlockSize = deque_detail::default_block_size >
+    class stable_vector
+        : private deque<T, Allocator, BlockSize>
+    {
+    private:
+        using base_type = deque<T, Allocator, BlockSize>;
+
+    public:
+        using typename base_type::value_type;
+        using typename base_type::iterator;
+        using typename base_type::const_iterator;
+
+        using base_type::base_type;
+        using base_type::operator[];
+        using base_type::at;
+        using base_type::at_unchecked;
+        using base_type::front;
+        using base_type::back;
+        using base_type::push_back;
+        using base_type::emplace_back;
+        using base_type::pop_back;
+        using base_type::clear;
+        using base_type::shrink_to_fit;
+        using base_type::size;
+        using base_type::empty;
+        using base_type::block_size;
+        using base_type::begin;
+        using base_type::end;
+        using base_type::cbegin;
+        using base_type::cend;
+    };
+
+    template < typename T, usize N > deque(const T (&)[N]) -> deque<T>;
+    template < typename T, usize N > deque(T (&&)[N]) -> deque<T>;
+    template < typename T > using buffered_deque = deque< T, buffered_allocator >;
+    template < typename T > using buffered_stable_vector = stable_vector< T, buffered_allocator >;
+} // namespace hsd
@@ -0,0 +1,727 @@
+#pragma once
+
+#include "Result.hpp"
+#include "Pair.hpp"
+#include "Hash.hpp"
+#include "Allocator.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace hsd
+{
+    template < typename Key, typename T, typename Hasher,
+        template <typename> typename Allocator >
+    class flat_map;
+
+    namespace fmap_detail
+    {
+        // Every slot has a control byte: the high bit is set for
+        // empty/deleted slots and clear for full ones, in which case
+        // the remaining 7 bits hold a fragment of the hash (H2)
+        using ctrl_type = schar;
+
+        static constexpr ctrl_type empty = -128;
+        static constexpr ctrl_type deleted = -2;
+        static constexpr usize group_width = 16;
+
+        struct bad_key
+        {
+            const char* operator()() const
+            {
+                return "Tried to use an invalid key";
+            }
+        };
+
+        struct bad_access
+        {
+            const char* operator()() const
+            {
+                return "Tried to access an element out of bounds";
+            }
+        };
+
+        static constexpr bool is_full(ctrl_type ctrl)
+        {
+            return ctrl >= 0;
+        }
+
+        // Spreads the entropy of the hash over all the bits, so
+        // identity-like hashes (e.g. integers) still probe well
+        static constexpr u64 mix(u64 hash)
+        {
+            hash *= 0x9e37'79b9'7f4a'7c15ull;
+            return hash ^ (hash >> 32);
+        }
+
+        // Loads 16 control bytes and matches them all at once,
+        // each function returns a mask with 1 bit per matching slot
+        class group
+        {
+        private:
+            #if defined(__SSE2__)
+            __m128i _ctrl;
+            #else
+            const ctrl_type* _ctrl;
+            #endif
+
+        public:
+            inline explicit group(const ctrl_type* pos)
+            #if defined(__SSE2__)
+                : _ctrl{_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))}
+            #else
+                : _ctrl{pos}
+            #endif
+            {}
+
+            inline u32 match(ctrl_type hash) const
+            {
+                #if defined(__SSE2__)
+                return static_cast<u32>(_mm_movemask_epi8(
+                    _mm_cmpeq_epi8(_mm_set1_epi8(hash), _ctrl)
+                ));
+                #else
+                u32 _mask = 0;
+
+                for (usize _index = 0; _index < group_width; _index++)
+                {
+                    if (_ctrl[_index] == hash)
+                        _mask |= (1u << _index);
+                }
+
+                return _mask;
+                #endif
+            }
+
+            inline u32 match_empty() const
+            {
+                return match(empty);
+            }
+
+            inline u32 match_empty_or_deleted() const
+            {
+                #if defined(__SSE2__)
+                return static_cast<u32>(_mm_movemask_epi8(
+                    _mm_cmpgt_epi8(_mm_set1_epi8(-1), _ctrl)
+                ));
+                #else
+                u32 _mask = 0;
+
+                for (usize _index = 0; _index < group_width; _index++)
+                {
+                    if (_ctrl[_index] < -1)
+                        _mask |= (1u << _index);
+                }
+
+                return _mask;
+                #endif
+            }
+        };
+
+        template <typename T>
+        class iterator
+        {
+        private:
+            const ctrl_type* _ctrl = nullptr;
+            T* _slot = nullptr;
+            const ctrl_type* _end = nullptr;
+
+            template < typename Key, typename U, typename Hasher,
+                template <typename> typename Allocator >
+            friend class hsd::flat_map;
+
+            template <typename U>
+            friend class iterator;
+
+            inline void _skip_empty()
+            {
+                while (_ctrl != _end && !is_full(*_ctrl))
+                {
+                    _ctrl++;
+                    _slot++;
+                }
+            }
+
+        public:
+            inline iterator() = default;
+
+            inline iterator(const ctrl_type* ctrl, T* slot, const ctrl_type* end)
+                : _ctrl{ctrl}, _slot{slot}, _end{end}
+            {
+                _skip_empty();
+            }
+
+            template <typename U>
+            requires (IsSame<const U, T>)
+            inline iterator(const iterator<U>& other)
+                : _ctrl{other._ctrl}, _slot{other._slot}, _end{other._end}
+            {}
+
+            inline friend bool operator==(const iterator& lhs, const iterator& rhs)
+            {
+                return lhs._slot == rhs._slot;
+            }
+
+            inline friend bool operator!=(const iterator& lhs, const iterator& rhs)
+            {
+                return lhs._slot != rhs._slot;
+            }
+
+            inline auto& operator++()
+            {
+                _ctrl++;
+                _slot++;
+                _skip_empty();
+                return *this;
+            }
+
+            inline iterator operator++(i32)
+            {
+                iterator tmp = *this;
+                operator++();
+                return tmp;
+            }
+
+            inline T& operator*() const
+            {
+                return *_slot;
+            }
+
+            inline T* operator->() const
+            {
+                return _slot;
+            }
+        };
+    } // namespace fmap_detail
+
+    // Open addressing hash map (a.k.a. "Swiss table"), the elements
+    // live directly inside one slot array, and lookups scan the
+    // control bytes a group at a time before touching any element
+    template < typename Key, typename T, typename Hasher = hash<usize, Key>,
+        template <typename> typename Allocator = allocator >
+    class flat_map
+    {
+    public:
+        using value_type = pair<Key, T>;
+        using reference_type = T&;
+        using iterator = fmap_detail::iterator<value_type>;
+        using const_iterator = fmap_detail::iterator<const value_type>;
+
+    private:
+        using ctrl_type = fmap_detail::ctrl_type;
+        using group = fmap_detail::group;
+        using ctrl_alloc_type = Allocator<ctrl_type>;
+        using slot_alloc_type = Allocator<value_type>;
+
+        static constexpr usize _npos = static_cast<usize>(-1);
+
+        ctrl_alloc_type _ctrl_alloc;
+        slot_alloc_type _slot_alloc;
+        ctrl_type* _ctrl = nullptr;
+        value_type* _slots = nullptr;
+        usize _capacity = 0;
+        usize _size = 0;
+        usize _growth_left = 0;
+
+        // Max load factor of 7/8
+        static constexpr usize _max_load(usize capacity)
+        {
+            return capacity - capacity / 8;
+        }
+
+        template <typename U>
+        static inline u64 _hash_of(const U& key)
+        {
+            return fmap_detail::mix(
+                static_cast<u64>(Hasher::get_hash(key))
+            );
+        }
+
+        static inline ctrl_type _h2(u64 hash)
+        {
+            return static_cast<ctrl_type>(hash & 0x7f);
+        }
+
+        static inline usize _h1(u64 hash)
+        {
+            return static_cast<usize>(hash >> 7);
+        }
+
+        // The first group is mirrored after the end of the
+        // control bytes so a group can be loaded from any slot
+        inline void _set_ctrl(usize index, ctrl_type value)
+        {
+            _ctrl[index] = value;
+
+            if (index < fmap_detail::group_width)
+                _ctrl[_capacity + index] = value;
+        }
+
+        template <typename U>
+        inline usize _find(const U& key, u64 hash) const
+        {
+            if (_capacity == 0)
+                return _npos;
+
+            usize _mask = _capacity - 1;
+            usize _pos = _h1(hash) & _mask;
+            usize _step = 0;
+
+            while (true)
+            {
+                group _group{_ctrl + _pos};
+
+                for (u32 _match = _group.match(_h2(hash)); _match != 0; _match &= _match - 1)
+                {
+                    usize _index = (_pos + static_cast<usize>(__builtin_ctz(_match))) & _mask;
+
+                    if (_slots[_index].first == key)
+                        return _index;
+                }
+
+                if (_group.match_empty() != 0)
+                    return _npos;
+
+                _step += fmap_detail::group_width;
+                _pos = (_pos + _step) & _mask;
+            }
+        }
+
+        inline usize _find_first_non_full(u64 hash) const
+        {
+            usize _mask = _capacity - 1;
+            usize _pos = _h1(hash) & _mask;
+            usize _step = 0;
+
+            while (true)
+            {
+                u32 _match = group{_ctrl + _pos}.match_empty_or_deleted();
+
+                if (_match != 0)
+                    return (_pos + static_cast<usize>(__builtin_ctz(_match))) & _mask;
+
+                _step += fmap_detail::group_width;
+                _pos = (_pos + _step) & _mask;
+            }
+        }
+
+        inline void _resize(usize new_capacity)
+        {
+            ctrl_type* _old_ctrl = _ctrl;
+            value_type* _old_slots = _slots;
+            usize _old_capacity = _capacity;
+
+            _ctrl = _ctrl_alloc.allocate(
+                new_capacity + fmap_detail::group_width
+            ).unwrap();
+
+            _slots = _slot_alloc.allocate(new_capacity).unwrap();
+            _capacity = new_capacity;
+
+            for (usize _index = 0; _index < _capacity + fmap_detail::group_width; _index++)
+                _ctrl[_index] = fmap_detail::empty;
+
+            for (usize _index = 0; _index < _old_capacity; _index++)
+            {
+                if (fmap_detail::is_full(_old_ctrl[_index]))
+                {
+                    u64 _hash = _hash_of(_old_slots[_index].first);
+                    usize _new_index = _find_first_non_full(_hash);
+
+                    _set_ctrl(_new_index, _h2(_hash));
+                    _slot_alloc.construct_at(
+                        &_slots[_new_index], move(_old_slots[_index])
+                    );
+
+                    _old_slots[_index].~value_type();
+                }
+            }
+
+            _growth_left = _max_load(_capacity) - _size;
+
+            if (_old_capacity != 0)
+            {
+                _ctrl_alloc.deallocate(
+                    _old_ctrl, _old_capacity + fmap_detail::group_width
+                ).unwrap();
+
+                _slot_alloc.deallocate(_old_slots, _old_capacity).unwrap();
+            }
+        }
+
+        inline void _grow()
+        {
+            if (_capacity == 0)
+            {
+                _resize(fmap_detail::group_width);
+            }
+            else if (_size < _max_load(_capacity) / 2)
+            {
+                // Mostly tombstones, rehashing in place is enough
+                _resize(_capacity);
+            }
+            else
+            {
+                _resize(_capacity * 2);
+            }
+        }
+
+        // Reserves a slot for a new element with the given hash,
+        // the caller is responsible for constructing the element
+        inline usize _prepare_insert(u64 hash)
+        {
+            if (_capacity == 0)
+                _grow();
+
+            usize _index = _find_first_non_full(hash);
+
+            if (_growth_left == 0 && _ctrl[_index] != fmap_detail::deleted)
+            {
+                _grow();
+                _index = _find_first_non_full(hash);
+            }
+
+            if (_ctrl[_index] == fmap_detail::empty)
+                _growth_left--;
+
+            _size++;
+            _set_ctrl(_index, _h2(hash));
+            return _index;
+        }
+
+        inline void _erase_at(usize index)
+        {
+            usize _mask = _capacity - 1;
+            usize _before = (index - fmap_detail::group_width) & _mask;
+            u32 _empty_after = group{_ctrl + index}.match_empty();
+            u32 _empty_before = group{_ctrl + _before}.match_empty();
+
+            // If there was never a full group around this slot, no probe
+            // sequence went past it, so it can be marked empty directly
+            bool _was_never_full = _empty_before != 0 && _empty_after != 0 &&
+                static_cast<usize>(
+                    __builtin_ctz(_empty_after) + __builtin_clz(_empty_before) - 16
+                ) < fmap_detail::group_width;
+
+            _slots[index].~value_type();
+            _set_ctrl(index, _was_never_full ? fmap_detail::empty : fmap_detail::deleted);
+            _growth_left += _was_never_full;
+            _size--;
+        }
+
+        inline void _destroy()
+        {
+            if (_capacity != 0)
+            {
+                for (usize _index = 0; _index < _capacity; _index++)
+                {
+                    if (fmap_detail::is_full(_ctrl[_index]))
+                        _slots[_index].~value_type();
+                }
+
+                _ctrl_alloc.deallocate(
+                    _ctrl, _capacity + fmap_detail::group_width
+                ).unwrap();
+
+                _slot_alloc.deallocate(_slots, _capacity).unwrap();
+            }
+
+            _ctrl = nullptr;
+            _slots = nullptr;
+            _capacity = 0;
+            _size = 0;
+            _growth_left = 0;
+        }
+
+        inline void _copy_from(const flat_map& other)
+        {
+            if (other._capacity != 0)
+            {
+                _ctrl = _ctrl_alloc.allocate(
+                    other._capacity + fmap_detail::group_width
+                ).unwrap();
+
+                _slots = _slot_alloc.allocate(other._capacity).unwrap();
+                _capacity = other._capacity;
+                _size = other._size;
+                _growth_left = other._growth_left;
+
+                for (usize _index = 0; _index < _capacity + fmap_detail::group_width; _index++)
+                    _ctrl[_index] = other._ctrl[_index];
+
+                for (usize _index = 0; _index < _capacity; _index++)
+                {
+                    if (fmap_detail::is_full(_ctrl[_index]))
+                        _slot_alloc.construct_at(&_slots[_index], other._slots[_index]);
+                }
+            }
+        }
+
+    public:
+        inline ~flat_map()
+        {
+            _destroy();
+        }
+
+        inline flat_map()
+        requires (std::is_default_constructible_v<ctrl_alloc_type> &&
+            std::is_default_constructible_v<slot_alloc_type>) = default;
+
+        template <typename Alloc>
+        inline flat_map(const Alloc& alloc)
+        requires (std::is_constructible_v<ctrl_alloc_type, Alloc> &&
+            std::is_constructible_v<slot_alloc_type, Alloc>)
+            : _ctrl_alloc(alloc), _slot_alloc(alloc)
+        {}
+
+        inline flat_map(const flat_map& other)
+            : _ctrl_alloc(other._ctrl_alloc), _slot_alloc(other._slot_alloc)
+        {
+            _copy_from(other);
+        }
+
+        inline flat_map(flat_map&& other)
+            : _ctrl_alloc(other._ctrl_alloc), _slot_alloc(other._slot_alloc)
+        {
+            _ctrl = exchange(other._ctrl, nullptr);
+            _slots = exchange(other._slots, nullptr);
+            _capacity = exchange(other._capacity, 0u);
+            _size = exchange(other._size, 0u);
+            _growth_left = exchange(other._growth_left, 0u);
+        }
+
+        template <usize N>
+        inline flat_map(pair<Key, T> (&&other)[N])
+        requires (std::is_default_constructible_v<ctrl_alloc_type> &&
+            std::is_default_constructible_v<slot_alloc_type>)
+        {
+            reserve(N);
+
+            for (usize _index = 0; _index < N; _index++)
+            {
+                emplace(
+                    move(other[_index].first),
+                    move(other[_index].second)
+                );
+            }
+        }
+
+        inline flat_map& operator=(const flat_map& rhs)
+        {
+            if (this != &rhs)
+            {
+                _destroy();
+                _copy_from(rhs);
+            }
+
+            return *this;
+        }
+
+        inline flat_map& operator=(flat_map&& rhs)
+        {
+            if (this != &rhs)
+            {
+                _destroy();
+
+                // The buffers are freed by the allocators they came from
+                _ctrl_alloc = rhs._ctrl_alloc;
+                _slot_alloc = rhs._slot_alloc;
+                _ctrl = exchange(rhs._ctrl, nullptr);
+                _slots = exchange(rhs._slots, nullptr);
+                _capacity = exchange(rhs._capacity, 0u);
+                _size = exchange(rhs._size, 0u);
+                _growth_left = exchange(rhs._growth_left, 0u);
+            }
+
+            return *this;
+        }
+
+        inline auto& operator[](const Key& key)
+        {
+            return emplace(key).first->second;
+        }
+
+        inline const auto& operator[](const Key& key) const
+        {
+            return at(key).unwrap();
+        }
+
+        inline auto at(const Key& key)
+            -> Result< reference<T>, fmap_detail::bad_key >
+        {
+            usize _index = _find(key, _hash_of(key));
+
+            if (_index == _npos)
+                return fmap_detail::bad_key{};
+
+            return {_slots[_index].second};
+        }
+
+        inline auto at(const Key& key) const
+            -> Result< reference<const T>, fmap_detail::bad_key >
+        {
+            usize _index = _find(key, _hash_of(key));
+
+            if (_index == _npos)
+                return fmap_detail::bad_key{};
+
+            return {_slots[_index].second};
+        }
+
+        inline iterator find(const Key& key)
+        {
+            usize _index = _find(key, _hash_of(key));
+
+            if (_index == _npos)
+                return end();
+
+            return {_ctrl + _index, _slots + _index, _ctrl + _capacity};
+        }
+
+        inline const_iterator find(const Key& key) const
+        {
+            usize _index = _find(key, _hash_of(key));
+
+            if (_index == _npos)
+                return end();
+
+            return {_ctrl + _index, _slots + _index, _ctrl + _capacity};
+        }
+
+        inline bool contains(const Key& key) const
+        {
+            return _find(key, _hash_of(key)) != _npos;
+        }
+
+        template < typename NewKey, typename... Args >
+        inline pair<iterator, bool> emplace(NewKey&& key, Args&&... args)
+        {
+            u64 _hash = _hash_of(key);
+            usize _index = _find(key, _hash);
+
+            if (_index != _npos)
+                return {{_ctrl + _index, _slots + _index, _ctrl + _capacity}, false};
+
+            _index = _prepare_insert(_hash);
+
+            _slot_alloc.construct_at(
+                &_slots[_index], Key(forward<NewKey>(key)),
+                T{forward<Args>(args)...}
+            );
+
+            return {{_ctrl + _index, _slots + _index, _ctrl + _capacity}, true};
+        }
+
+        inline auto erase(const_iterator pos)
+            -> Result<iterator, fmap_detail::bad_access>
+        {
+            if (pos._slot < _slots || pos._slot >= _slots + _capacity ||
+                !fmap_detail::is_full(*pos._ctrl))
+            {
+                return fmap_detail::bad_access{};
+            }
+
+            usize _index = static_cast<usize>(pos._slot - _slots);
+            _erase_at(_index);
+
+            return iterator{
+                _ctrl + _index + 1, _slots + _index + 1, _ctrl + _capacity
+            };
+        }
+
+        inline bool erase(const Key& key)
+        {
+            usize _index = _find(key, _hash_of(key));
+
+            if (_index == _npos)
+                return false;
+
+            _erase_at(_index);
+            return true;
+        }
+
+        inline void reserve(usize size)
+        {
+            usize _new_capacity = fmap_detail::group_width;
+
+            while (_max_load(_new_capacity) < size)
+                _new_capacity *= 2;
+
+            if (_new_capacity > _capacity)
+                _resize(_new_capacity);
+        }
+
+        inline void clear()
+        {
+            if (_capacity == 0)
+                return;
+
+            for (usize _index = 0; _index < _capacity; _index++)
+            {
+                if (fmap_detail::is_full(_ctrl[_index]))
+                    _slots[_index].~value_type();
+            }
+
+            for (usize _index = 0; _index < _capacity + fmap_detail::group_width; _index++)
+                _ctrl[_index] = fmap_detail::empty;
+
+            _size = 0;
+            _growth_left = _max_load(_capacity);
+        }
+
+        inline usize size() const
+        {
+            return _size;
+        }
+
+        inline usize capacity() const
+        {
+            return _capacity;
+        }
+
+        inline bool empty() const
+        {
+            return _size == 0;
+        }
+
+        inline iterator begin()
+        {
+            return {_ctrl, _slots, _ctrl + _capacity};
+        }
+
+        inline const_iterator begin() const
+        {
+            return cbegin();
+        }
+
+        inline iterator end()
+        {
+            return {_ctrl + _capacity, _slots + _capacity, _ctrl + _capacity};
+        }
+
+        inline const_iterator end() const
+        {
+            return cend();
+        }
+
+        inline const_iterator cbegin() const
+        {
+            return {_ctrl, _slots, _ctrl + _capacity};
+        }
+
+        inline const_iterator cend() const
+        {
+            return {_ctrl + _capacity, _slots + _capacity, _ctrl + _capacity};
+        }
+    };
+
+    template< typename Key, typename T, usize N >
+    flat_map(pair<Key, T> (&&other)[N])
+        -> flat_map<Key, T, hash<usize, Key>>;
+
+    template< typename Key, typename T >
+    using buffered_flat_map = flat_map<
+        Key, T, hash<usize, Key>, buffered_allocator
+    >;
+} // namespace hsd
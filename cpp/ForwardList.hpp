@@ -8,7 +8,7 @@
 
 namespace hsd
 {
-    template <typename T> class forward_list;
+    template < typename T, template <typename> typename Allocator > class forward_list;
 
     namespace forward_list_detail
     {
@@ -21,31 +21,33 @@ namespace hsd
         };
 
         template <typename T>
-        class iterator
+        struct forward_list_node
         {
-        private:
-            struct forward_list_impl
-            {
-                T _value;
-                forward_list_impl* _next = nullptr;
+            T _value;
+            forward_list_node* _next = nullptr;
 
-                inline forward_list_impl() = default;
+            template <typename... Args>
+            inline forward_list_node(Args&&... args)
+                : _value{forward<Args>(args)...}
+            {}
+        };
 
-                inline forward_list_impl(const T& val)
-                    : _value{val}
-                {}
+        template <typename T>
+        class iterator
+        {
+        private:
+            forward_list_node<T>* _iterator = nullptr;
 
-                inline forward_list_impl(T&& val)
-                    : _value{move(val)}
-                {}
-            };
-            
-            forward_list_impl *_iterator = nullptr;
-            friend class forward_list<T>;
+            template < typename U, template <typename> typename Allocator >
+            friend class hsd::forward_list;
 
             inline iterator() = default;
             inline iterator(hsd::NullType) {}
 
+            inline iterator(forward_list_node<T>* node)
+                : _iterator{node}
+            {}
+
             inline T* get()
             {
                 return &_iterator->_value;
@@ -56,156 +58,400 @@ namespace hsd
                 return &_iterator->_value;
             }
 
-            inline void push_back(const T& value)
+        public:
+            inline iterator(const iterator& other)
             {
-                _iterator->_next = mallocator::allocate_single<
-                    forward_list_impl>(value).unwrap();
-                
-                _iterator = _iterator->_next;
+                _iterator = other._iterator;
             }
 
-            inline void push_back(T&& value)
+            inline iterator& operator=(const iterator& rhs)
             {
-                _iterator->_next = mallocator::allocate_single<
-                    forward_list_impl>(move(value)).unwrap();
-                
-                _iterator = _iterator->_next;
+                _iterator = rhs._iterator;
+                return *this;
             }
 
-            template <typename... Args>
-            inline void emplace_back(Args&&... args)
+            inline friend bool operator==(const iterator& lhs, const iterator& rhs)
+            {
+                return lhs._iterator == rhs._iterator;
+            }
+
+            inline friend bool operator!=(const iterator& lhs, const iterator& rhs)
             {
-                _iterator->_next = mallocator::allocate_single<
-                    forward_list_impl>().unwrap();
+                return lhs._iterator != rhs._iterator;
+            }
 
-                _iterator->_next->_value.~T();
-                mallocator::construct_at(
-                    &_iterator->_next->_value, forward<Args>(args)...
-                );
+            inline auto& operator++()
+            {
                 _iterator = _iterator->_next;
+                return *this;
             }
 
-            inline void push_front(const T& value)
+            inline iterator operator++(i32)
             {
-                forward_list_impl* _element = mallocator::allocate_single<
-                    forward_list_impl>(value).unwrap();
-                
-                _element->_next = _iterator;
-                _iterator = _element;
+                iterator tmp = *this;
+                operator++();
+                return tmp;
             }
 
-            inline void push_front(T&& value)
+            inline auto& operator*()
             {
-                forward_list_impl* _element = mallocator::allocate_single<
-                    forward_list_impl>(move(value)).unwrap();
-                
-                _element->_next = _iterator;
-                _iterator = _element;
+                return _iterator->_value;
             }
 
-            template <typename... Args>
-            inline void emplace_front(Args&&... args)
+            inline const auto& operator*() const
             {
-                forward_list_impl* _element = mallocator::allocate_single<
-                    forward_list_impl>().unwrap();
-                _element->_next = _iterator;
-                
-                _element->_value.~T();
-                mallocator::construct_at(
-                    &_element->_value, forward<Args>(args)...
-                );
-                _iterator = _element;
+                return _iterator->_value;
             }
 
-            inline void pop_front()
+            inline auto* operator->()
             {
-                forward_list_impl* _element = _iterator;
-                _iterator = _iterator->_next;
-                mallocator::deallocate(_element);
+                return get();
             }
-        public:
 
-            inline iterator(const iterator& other)
+            inline const auto* operator->() const
             {
-                _iterator = other._iterator;
+                return get();
             }
+        };
 
-            inline iterator& operator=(const iterator& rhs)
+        template <typename T, typename Tag>
+        class intrusive_forward_list;
+
+        template <typename T, typename Tag, bool Const>
+        class intrusive_iterator;
+
+        // Link of an element of an `intrusive_forward_list`, use a
+        // different `Tag` for every list the element can be a part of
+        template <typename Tag = void>
+        class forward_list_hook
+        {
+        private:
+            forward_list_hook* _next = nullptr;
+
+            template <typename T, typename U>
+            friend class intrusive_forward_list;
+
+            template <typename T, typename U, bool Const>
+            friend class intrusive_iterator;
+
+        public:
+            inline forward_list_hook() = default;
+
+            // The link belongs to the list, not to the value
+            inline forward_list_hook(const forward_list_hook&)
+            {}
+
+            inline forward_list_hook& operator=(const forward_list_hook&)
             {
-                _iterator = rhs._iterator;
                 return *this;
             }
+        };
 
-            inline friend bool operator==(const iterator& lhs, const iterator& rhs)
+        template <typename T, typename Tag, bool Const>
+        class intrusive_iterator
+        {
+        private:
+            using hook_type = conditional_t<Const, const forward_list_hook<Tag>, forward_list_hook<Tag>>;
+            using value_type = conditional_t<Const, const T, T>;
+
+            hook_type* _hook = nullptr;
+
+            template <typename U, typename V>
+            friend class intrusive_forward_list;
+
+        public:
+            inline intrusive_iterator(hook_type* hook)
+                : _hook{hook}
+            {}
+
+            inline bool operator==(const intrusive_iterator& rhs) const
             {
-                return lhs._iterator == rhs._iterator;
+                return _hook == rhs._hook;
             }
-        
-            inline friend bool operator!=(const iterator& lhs, const iterator& rhs)
+
+            inline bool operator!=(const intrusive_iterator& rhs) const
             {
-                return lhs._iterator != rhs._iterator;
+                return _hook != rhs._hook;
             }
 
-            inline auto& operator++()
+            inline intrusive_iterator& operator++()
             {
-                _iterator = _iterator->_next;
+                _hook = _hook->_next;
                 return *this;
             }
 
-            inline iterator operator++(i32)
+            inline intrusive_iterator operator++(i32)
             {
-                iterator tmp = *this;
+                intrusive_iterator _tmp = *this;
                 operator++();
-                return tmp;
+                return _tmp;
             }
 
-            inline auto& operator*() 
+            inline value_type& operator*() const
             {
-                return _iterator->_value;
+                return static_cast<value_type&>(*_hook);
             }
 
-            inline const auto& operator*() const
+            inline value_type* operator->() const
             {
-                return _iterator->_value;
+                return &operator*();
             }
+        };
+
+        // Singly linked list over elements that inherit
+        // `forward_list_hook<Tag>`. It never allocates and never owns
+        // the elements, they have to outlive their time in the list.
+        // Removal is O(1) after a known position, `erase` of an
+        // arbitrary element has to walk to its predecessor
+        template <typename T, typename Tag = void>
+        class intrusive_forward_list
+        {
+        private:
+            using hook_type = forward_list_hook<Tag>;
 
-            inline auto* operator->() 
+            // `_root` stands before the first element, so that
+            // `before_begin()` can be used with `insert_after`
+            hook_type _root;
+            hook_type* _tail = &_root;
+            usize _size = 0;
+
+            static inline hook_type* _hook_of(T& value)
             {
-                return get();
+                return static_cast<hook_type*>(&value);
             }
 
-            inline const auto* operator->() const
+            inline void _link_after(hook_type* pos, hook_type* hook)
             {
-                return get();
+                hook->_next = pos->_next;
+                pos->_next = hook;
+
+                if (pos == _tail)
+                    _tail = hook;
+
+                _size++;
+            }
+
+            inline hook_type* _unlink_after(hook_type* pos)
+            {
+                hook_type* _hook = pos->_next;
+                pos->_next = _hook->_next;
+
+                if (_hook == _tail)
+                    _tail = pos;
+
+                _hook->_next = nullptr;
+                _size--;
+                return pos->_next;
+            }
+
+        public:
+            using iterator = intrusive_iterator<T, Tag, false>;
+            using const_iterator = intrusive_iterator<T, Tag, true>;
+
+            inline intrusive_forward_list() = default;
+
+            inline intrusive_forward_list(const intrusive_forward_list&) = delete;
+            inline intrusive_forward_list& operator=(const intrusive_forward_list&) = delete;
+
+            inline intrusive_forward_list(intrusive_forward_list&& other)
+            {
+                *this = move(other);
+            }
+
+            inline intrusive_forward_list& operator=(intrusive_forward_list&& rhs)
+            {
+                if (this != &rhs)
+                {
+                    clear();
+
+                    if (!rhs.empty())
+                    {
+                        _root._next = exchange(rhs._root._next, nullptr);
+                        _tail = exchange(rhs._tail, &rhs._root);
+                        _size = exchange(rhs._size, 0u);
+                    }
+                }
+
+                return *this;
+            }
+
+            inline ~intrusive_forward_list()
+            {
+                clear();
+            }
+
+            inline void push_front(T& value)
+            {
+                _link_after(&_root, _hook_of(value));
+            }
+
+            inline void push_back(T& value)
+            {
+                _link_after(_tail, _hook_of(value));
+            }
+
+            inline void pop_front()
+            {
+                if (!empty())
+                    _unlink_after(&_root);
+            }
+
+            // Links `value` after `pos`
+            inline iterator insert_after(iterator pos, T& value)
+            {
+                _link_after(pos._hook, _hook_of(value));
+                return {_hook_of(value)};
+            }
+
+            // Unlinks the element after `pos` and returns the one after it
+            inline iterator erase_after(iterator pos)
+            {
+                return {_unlink_after(pos._hook)};
+            }
+
+            // Unlinks `value`, walking the list to find the one before
+            inline auto erase(T& value)
+                -> Result<void, runtime_error>
+            {
+                hook_type* _hook = _hook_of(value);
+
+                for (hook_type* _pos = &_root; _pos->_next != nullptr; _pos = _pos->_next)
+                {
+                    if (_pos->_next == _hook)
+                    {
+                        _unlink_after(_pos);
+                        return {};
+                    }
+                }
+
+                return runtime_error{"Element is not in the list"};
+            }
+
+            // Unlinks every element, it does not touch the elements otherwise
+            inline void clear()
+            {
+                hook_type* _hook = _root._next;
+
+                while (_hook != nullptr)
+                    _hook = exchange(_hook->_next, nullptr);
+
+                _root._next = nullptr;
+                _tail = &_root;
+                _size = 0;
+            }
+
+            inline usize size() const
+            {
+                return _size;
+            }
+
+            inline bool empty() const
+            {
+                return _size == 0;
+            }
+
+            inline T& front()
+            {
+                return static_cast<T&>(*_root._next);
+            }
+
+            inline T& back()
+            {
+                return static_cast<T&>(*_tail);
+            }
+
+            inline iterator before_begin()
+            {
+                return {&_root};
+            }
+
+            inline iterator begin()
+            {
+                return {_root._next};
+            }
+
+            inline iterator end()
+            {
+                return {nullptr};
+            }
+
+            inline const_iterator begin() const
+            {
+                return {_root._next};
+            }
+
+            inline const_iterator end() const
+            {
+                return {nullptr};
             }
         };
     } // namespace forward_list_detail
 
-    template <typename T>
+    template < typename Tag = void >
+    using forward_list_hook = forward_list_detail::forward_list_hook<Tag>;
+
+    template < typename T, typename Tag = void >
+    using intrusive_forward_list = forward_list_detail::intrusive_forward_list<T, Tag>;
+
+    // Nodes come from `Allocator`, by default every list keeps a pool
+    // of its own and reuses the nodes it frees
+    template < typename T, template <typename> typename Allocator = node_pool_allocator >
     class forward_list
     {
     private:
+        using node_type = forward_list_detail::forward_list_node<T>;
+
+        Allocator<node_type> _alloc;
         forward_list_detail::iterator<T> _head;
         forward_list_detail::iterator<T> _tail;
         usize _size = 0;
-        
+
+        template <typename... Args>
+        inline node_type* _make_node(Args&&... args)
+        {
+            node_type* _node = _alloc.allocate(1).unwrap();
+            _alloc.construct_at(_node, forward<Args>(args)...);
+            return _node;
+        }
+
+        inline void _free_node(node_type* node)
+        {
+            node->~node_type();
+            _alloc.deallocate(node, 1).unwrap();
+        }
+
+        inline void _steal(forward_list& other)
+        {
+            _head = exchange(other._head, nullptr);
+            _tail = exchange(other._tail, nullptr);
+            _size = exchange(other._size, 0u);
+        }
+
     public:
         using iterator = forward_list_detail::iterator<T>;
         using const_iterator = const iterator;
-        inline forward_list() = default;
+
+        inline forward_list()
+            requires (std::is_default_constructible_v<Allocator<node_type>>)
+        {}
+
+        template <typename Alloc>
+        inline forward_list(const Alloc& alloc)
+        requires (std::is_constructible_v<Allocator<node_type>, Alloc>)
+            : _alloc(alloc)
+        {}
 
         inline forward_list(const forward_list& other)
+            : _alloc(other._alloc)
         {
             for (const auto& _element : other)
                 push_back(_element);
         }
 
         inline forward_list(forward_list&& other)
+            : _alloc(move(other._alloc))
         {
-            _head = other._head;
-            _tail = other._tail;
-            other._head = nullptr;
-            other._tail = nullptr;
+            _steal(other);
         }
 
         template <usize N>
@@ -229,21 +475,26 @@ namespace hsd
 
         inline forward_list& operator=(const forward_list& rhs)
         {
-            clear();
-            
-            for (const auto& _element : rhs)
-                push_back(_element);
-            
+            if (this != &rhs)
+            {
+                clear();
+
+                for (const auto& _element : rhs)
+                    push_back(_element);
+            }
+
             return *this;
         }
 
         inline forward_list& operator=(forward_list&& rhs)
         {
-            _head = rhs._head;
-            _tail = rhs._tail;
-            rhs._head = nullptr;
-            rhs._tail = nullptr;
-            
+            if (this != &rhs)
+            {
+                clear();
+                _alloc = move(rhs._alloc);
+                _steal(rhs);
+            }
+
             return *this;
         }
 
@@ -251,12 +502,8 @@ namespace hsd
         inline forward_list& operator=(const T (&arr)[N])
         {
             clear();
-            usize _index = 0;
-
-            for (auto _it = begin(); _it != end() && _index < N; _it++, _index++)
-                *_it = arr[_index];
 
-            for (; _index < N; _index++)
+            for (usize _index = 0; _index < N; _index++)
                 push_back(arr[_index]);
 
             return *this;
@@ -266,12 +513,8 @@ namespace hsd
         inline forward_list& operator=(T (&&arr)[N])
         {
             clear();
-            usize _index = 0;
-
-            for (auto _it = begin(); _it != end() && _index < N; _it++, _index++)
-                *_it = move(arr[_index]);
 
-            for (; _index < N; _index++)
+            for (usize _index = 0; _index < N; _index++)
                 push_back(move(arr[_index]));
 
             return *this;
@@ -288,11 +531,6 @@ namespace hsd
                 // if it belongs to this list or not
                 return runtime_error{"Accessed an null element"};
             }
-            else if (_size == 1)
-            {
-                pop_front();
-                return end();
-            }
             else if (pos == begin())
             {
                 pop_front();
@@ -300,132 +538,71 @@ namespace hsd
             }
             else
             {
-                iterator _next_iter, _back_iter;
-                _next_iter._iterator = pos._iterator->_next;
-                auto _check_iter = [&]{
-                    return _back_iter._iterator->_next != 
-                        pos._iterator && _back_iter != end();
-                };
-                
-                for (_back_iter = begin(); _check_iter(); _back_iter++) {}
+                node_type* _back = _head._iterator;
 
-                if (_back_iter == end())
-                {
+                while (_back != nullptr && _back->_next != pos._iterator)
+                    _back = _back->_next;
+
+                if (_back == nullptr)
                     return runtime_error{"Undefined Behaviour"};
-                }
-                else
-                {
-                    _back_iter._iterator->_next = 
-                        _next_iter._iterator;
 
-                    _size--;
-                    delete pos._iterator;
-                    return _next_iter;
-                }
-            }
+                node_type* _node = pos._iterator;
+                _back->_next = _node->_next;
 
-            return runtime_error{"Undefined Behaviour"};
+                if (_node == _tail._iterator)
+                    _tail._iterator = _back;
+
+                _size--;
+                _free_node(_node);
+                return iterator{_back->_next};
+            }
         }
 
         inline void push_back(const T& value)
         {
-            if (empty())
-            {
-                _head._iterator = mallocator::allocate_single<
-                    typename iterator::forward_list_impl>(value).unwrap();
-
-                _tail = _head;
-            }
-            else
-                _tail.push_back(value);
-
-            _size++;
+            emplace_back(value);
         }
 
         inline void push_back(T&& value)
         {
-            if (empty())
-            {
-                _head._iterator = mallocator::allocate_single<
-                    typename iterator::forward_list_impl>(move(value)).unwrap();
-
-                _tail = _head;
-            }
-            else
-                _tail.push_back(move(value));
-
-            _size++;
+            emplace_back(move(value));
         }
 
         template <typename... Args>
         inline void emplace_back(Args&&... args)
         {
-            if (empty())
-            {
-                _head._iterator = mallocator::allocate_single<
-                    typename iterator::forward_list_impl>().unwrap();
+            node_type* _node = _make_node(forward<Args>(args)...);
 
-                _head._iterator->_value.~T();
-                mallocator::construct_at(
-                    &_head._iterator->_value, forward<Args>(args)...
-                );
-
-                _tail = _head;
-            }
+            if (empty())
+                _head._iterator = _node;
             else
-                _tail.emplace_back(forward<Args>(args)...);
+                _tail._iterator->_next = _node;
 
+            _tail._iterator = _node;
             _size++;
         }
 
         inline void push_front(const T& value)
         {
-            if (empty())
-            {
-                _head._iterator = mallocator::allocate_single<
-                    typename iterator::forward_list_impl>(value).unwrap();
-
-                _tail = _head;
-            }
-            else
-                _head.push_front(value);
-
-            _size++;
+            emplace_front(value);
         }
 
         inline void push_front(T&& value)
         {
-            if (empty())
-            {
-                _head._iterator = mallocator::allocate_single<
-                    typename iterator::forward_list_impl>(move(value));
-
-                _tail = _head;
-            }
-            else
-                _head.push_front(move(value));
-
-            _size++;
+            emplace_front(move(value));
         }
 
         template <typename... Args>
         inline void emplace_front(Args&&... args)
         {
-            if (empty())
-            {
-                _head._iterator = mallocator::allocate_single<
-                    typename iterator::forward_list_impl>().unwrap();
-
-                _head._iterator->_value.~T();
-                mallocator::construct_at(
-                    &_head._iterator->_value, forward<Args>(args)...
-                );
+            node_type* _node = _make_node(forward<Args>(args)...);
 
-                _tail = _head;
-            }
+            if (empty())
+                _tail._iterator = _node;
             else
-                _head.emplace_front(forward<Args>(args)...);
+                _node->_next = _head._iterator;
 
+            _head._iterator = _node;
             _size++;
         }
 
@@ -433,23 +610,29 @@ namespace hsd
         {
             if (!empty())
             {
-                _head.pop_front();
+                node_type* _node = _head._iterator;
+                _head._iterator = _node->_next;
+
+                if (_head._iterator == nullptr)
+                    _tail._iterator = nullptr;
+
+                _free_node(_node);
+                _size--;
             }
-            else
-                _tail = _head;
-                
-            _size--;
         }
 
         inline void clear()
         {
-            for (; !empty(); pop_front())
-                ;
-            
-            pop_front();
+            while (!empty())
+                pop_front();
         }
 
-        inline bool empty()
+        inline usize size() const
+        {
+            return _size;
+        }
+
+        inline bool empty() const
         {
             return _size == 0;
         }
@@ -494,4 +677,7 @@ namespace hsd
             return {nullptr};
         }
     };
-} // namespace hsd
\ No newline at end of file
+
+    template <typename T>
+    using buffered_forward_list = forward_list<T, buffered_allocator>;
+} // namespace hsd
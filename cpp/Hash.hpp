@@ -86,4 +86,207 @@ namespace hsd
             return static_cast<HashType>(number);
         }
     };
+
+    namespace hash_detail
+    {
+        // Constants and mixing steps of wyhash (final version 4)
+        // by Wang Yi, which is released into the public domain
+        static constexpr u64 secret[4] = {
+            0x2d35'8dcc'aa6c'78a5ull, 0x8bb8'4b93'962e'acc9ull,
+            0x4b33'a62e'd433'd4a3ull, 0x4d5a'2da5'1de1'aa47ull
+        };
+
+        static constexpr void mum(u64& lhs, u64& rhs)
+        {
+            #if defined(HSD_COMPILER_GCC)
+            u128 _result = static_cast<u128>(lhs) * rhs;
+            lhs = static_cast<u64>(_result);
+            rhs = static_cast<u64>(_result >> 64);
+            #else
+            u64 _lhs_hi = lhs >> 32, _lhs_lo = static_cast<u32>(lhs);
+            u64 _rhs_hi = rhs >> 32, _rhs_lo = static_cast<u32>(rhs);
+            u64 _hi_hi = _lhs_hi * _rhs_hi, _hi_lo = _lhs_hi * _rhs_lo;
+            u64 _lo_hi = _lhs_lo * _rhs_hi, _lo_lo = _lhs_lo * _rhs_lo;
+            u64 _mid = _hi_lo + _lo_hi;
+            u64 _low = _lo_lo + (_mid << 32);
+            u64 _carry = (static_cast<u64>(_mid < _hi_lo) << 32) + (_low < _lo_lo);
+            lhs = _low;
+            rhs = _hi_hi + (_mid >> 32) + _carry;
+            #endif
+        }
+
+        static constexpr u64 mix(u64 lhs, u64 rhs)
+        {
+            mum(lhs, rhs);
+            return lhs ^ rhs;
+        }
+
+        // Reads `Count` bytes (little-endian) starting from the
+        // byte `offset` of a sequence of integral characters
+        template <usize Count, typename CharT>
+        static constexpr u64 read(const CharT* data, usize offset)
+        {
+            u64 _result = 0;
+
+            if (std::is_constant_evaluated())
+            {
+                for (usize _index = 0; _index < Count; _index++)
+                {
+                    usize _byte = offset + _index;
+                    
+                    u64 _value = static_cast<u64>(
+                        data[_byte / sizeof(CharT)]
+                    ) >> (8 * (_byte % sizeof(CharT)));
+
+                    _result |= (_value & 0xff) << (8 * _index);
+                }
+            }
+            else
+            {
+                __builtin_memcpy(
+                    &_result, reinterpret_cast<const uchar*>(data) + offset, Count
+                );
+            }
+
+            return _result;
+        }
+
+        template <typename CharT>
+        static constexpr u64 read_small(const CharT* data, usize size)
+        {
+            return (read<1>(data, 0) << 16) | 
+                (read<1>(data, size >> 1) << 8) | read<1>(data, size - 1);
+        }
+
+        // Hashes `size` bytes, consuming 16 (or 48 for
+        // long inputs) bytes at a time
+        template <typename CharT>
+        static constexpr u64 bytes_hash(const CharT* data, usize size, u64 seed = 0)
+        {
+            usize _offset = 0;
+            u64 _lhs = 0, _rhs = 0;
+            seed ^= mix(seed ^ secret[0], secret[1]);
+
+            if (size <= 16)
+            {
+                if (size >= 4)
+                {
+                    usize _quarter = (size >> 3) << 2;
+                    _lhs = (read<4>(data, 0) << 32) | read<4>(data, _quarter);
+                    _rhs = (read<4>(data, size - 4) << 32) | 
+                        read<4>(data, size - 4 - _quarter);
+                }
+                else if (size > 0)
+                {
+                    _lhs = read_small(data, size);
+                }
+            }
+            else
+            {
+                usize _left = size;
+
+                if (_left > 48)
+                {
+                    u64 _seed1 = seed, _seed2 = seed;
+
+                    do
+                    {
+                        seed = mix(
+                            read<8>(data, _offset) ^ secret[1], 
+                            read<8>(data, _offset + 8) ^ seed
+                        );
+                        _seed1 = mix(
+                            read<8>(data, _offset + 16) ^ secret[2], 
+                            read<8>(data, _offset + 24) ^ _seed1
+                        );
+                        _seed2 = mix(
+                            read<8>(data, _offset + 32) ^ secret[3], 
+                            read<8>(data, _offset + 40) ^ _seed2
+                        );
+
+                        _offset += 48;
+                        _left -= 48;
+                    } while (_left > 48);
+
+                    seed ^= _seed1 ^ _seed2;
+                }
+
+                while (_left > 16)
+                {
+                    seed = mix(
+                        read<8>(data, _offset) ^ secret[1], 
+                        read<8>(data, _offset + 8) ^ seed
+                    );
+
+                    _offset += 16;
+                    _left -= 16;
+                }
+
+                _lhs = read<8>(data, _offset + _left - 16);
+                _rhs = read<8>(data, _offset + _left - 8);
+            }
+
+            _lhs ^= secret[1];
+            _rhs ^= seed;
+            mum(_lhs, _rhs);
+            return mix(_lhs ^ secret[0] ^ size, _rhs ^ secret[1]);
+        }
+
+        // Finalizer of splitmix64, every input bit
+        // affects every output bit
+        static constexpr u64 int_hash(u64 value)
+        {
+            value ^= value >> 30;
+            value *= 0xbf58'476d'1ce4'e5b9ull;
+            value ^= value >> 27;
+            value *= 0x94d0'49bb'1331'11ebull;
+            return value ^ (value >> 31);
+        }
+    } // namespace hash_detail
+
+    // Faster, better distributed alternative to `hash`, it is 
+    // meant to be passed as the `Hasher` of the hash containers
+    template < typename HashType, typename T = void >
+    struct fast_hash
+    {
+        using ResultType = HashType;
+    };
+
+    template < typename HashType, typename T >
+    requires (is_pointer<T>::value && std::is_integral_v<remove_pointer_t<T>>)
+    struct fast_hash<HashType, T>
+    {
+        using ResultType = HashType;
+
+        static constexpr ResultType get_hash(T begin)
+        {
+            usize _size = 0;
+
+            while (begin[_size] != '\0')
+                _size++;
+
+            return get_hash(begin, begin + _size);
+        }
+
+        static constexpr ResultType get_hash(T begin, T end)
+        {
+            return static_cast<ResultType>(hash_detail::bytes_hash(
+                begin, static_cast<usize>(end - begin) * sizeof(*begin)
+            ));
+        }
+    };
+
+    template < typename HashType, typename T >
+    requires (is_integral<T>::value)
+    struct fast_hash<HashType, T>
+    {
+        using ResultType = HashType;
+
+        static constexpr ResultType get_hash(T number)
+        {
+            return static_cast<ResultType>(
+                hash_detail::int_hash(static_cast<u64>(number))
+            );
+        }
+    };
 } // namespace hsd
\ No newline at end of file
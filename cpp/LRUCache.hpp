@@ -0,0 +1,561 @@
+#pragma once
+
+#include "Result.hpp"
+#include "Reference.hpp"
+#include "Hash.hpp"
+#include "Atomic.hpp"
+#include "Functional.hpp"
+#include "Allocator.hpp"
+
+namespace hsd
+{
+    enum class cache_policy
+    {
+        // Exact recency order, every hit relinks the entry
+        lru,
+        // Second chance approximation, a hit only sets a bit
+        clock
+    };
+
+    namespace lru_detail
+    {
+        static constexpr u32 npos = static_cast<u32>(-1);
+
+        struct bad_key
+        {
+            const char* operator()() const
+            {
+                return "Tried to use an invalid key";
+            }
+        };
+
+        struct bad_capacity
+        {
+            const char* operator()() const
+            {
+                return "lru_cache capacity must be in [1, 2^32 - 1)";
+            }
+        };
+
+        template <typename Key, typename T>
+        struct entry
+        {
+            Key key;
+            T value;
+            usize hash;
+            // Next entry in the same bucket, or in the free list
+            u32 chain;
+            // Recency links (only used by the lru policy)
+            u32 prev;
+            u32 next;
+            // Set on every hit by the clock policy
+            mutable uchar referenced;
+        };
+
+        // Keys of another type are hashed as they are only if the
+        // hasher is transparent, otherwise they are converted first
+        template <typename Hasher, typename Key, typename U>
+        concept DirectLookup = IsSame<remove_cvref_t<U>, Key> ||
+            requires { typename Hasher::is_transparent; };
+
+        static constexpr usize bucket_count(usize capacity)
+        {
+            usize _result = 1;
+
+            while (_result < capacity)
+                _result <<= 1;
+
+            return _result;
+        }
+    } // namespace lru_detail
+
+    // Fixed capacity cache, all the entries are allocated once on
+    // construction and both the hash chains and the recency list are
+    // indices stored inside the entries, so a hit or a replacement
+    // never allocates. With the clock policy a hit only marks the
+    // entry (relaxed atomic store), so `get() const` can be called by
+    // several readers at once as long as nobody inserts concurrently
+    template < typename Key, typename T, typename Hasher = hash<usize, Key>,
+        cache_policy Policy = cache_policy::lru,
+        template <typename> typename Allocator = allocator >
+    class lru_cache
+    {
+    private:
+        using entry_type = lru_detail::entry<Key, T>;
+
+        Allocator<entry_type> _entry_alloc;
+        Allocator<u32> _bucket_alloc;
+        entry_type* _entries = nullptr;
+        u32* _buckets = nullptr;
+        usize _capacity = 0;
+        usize _bucket_mask = 0;
+        usize _size = 0;
+        // Slots that were never used start at `_used`,
+        // erased ones are pushed on the `_free` list
+        u32 _used = 0;
+        u32 _free = lru_detail::npos;
+        // Most and least recently used entries (lru)
+        u32 _head = lru_detail::npos;
+        u32 _tail = lru_detail::npos;
+        // Clock hand (clock)
+        u32 _hand = 0;
+        mutable usize _hits = 0;
+        mutable usize _misses = 0;
+        function<void(const Key&, T&)> _on_evict;
+
+        inline auto _init(usize capacity)
+            -> Result< void, lru_detail::bad_capacity >
+        {
+            if (capacity == 0 || capacity >= lru_detail::npos)
+                return lru_detail::bad_capacity{};
+
+            _capacity = capacity;
+            usize _bucket_count = lru_detail::bucket_count(capacity);
+            _bucket_mask = _bucket_count - 1;
+            _entries = _entry_alloc.allocate(capacity).unwrap();
+            _buckets = _bucket_alloc.allocate(_bucket_count).unwrap();
+
+            for (usize _index = 0; _index < _bucket_count; _index++)
+                _buckets[_index] = lru_detail::npos;
+
+            return {};
+        }
+
+        inline void _count(usize& counter) const
+        {
+            if constexpr (Policy == cache_policy::clock)
+                atomic_ref<usize>{counter}.fetch_add(1, memory_order_relaxed);
+            else
+                counter++;
+        }
+
+        // A moved-from cache has no storage left to insert into
+        inline auto _check_storage() const
+            -> Result< void, lru_detail::bad_capacity >
+        {
+            if (_buckets == nullptr)
+                return lru_detail::bad_capacity{};
+
+            return {};
+        }
+
+        template <typename U>
+        inline u32 _find(const U& key, usize key_hash) const
+        {
+            // Nothing is found in a moved-from cache
+            if (_buckets == nullptr)
+                return lru_detail::npos;
+
+            u32 _index = _buckets[key_hash & _bucket_mask];
+
+            while (_index != lru_detail::npos)
+            {
+                auto& _entry = _entries[_index];
+
+                if (_entry.hash == key_hash && _entry.key == key)
+                    return _index;
+
+                _index = _entry.chain;
+            }
+
+            return lru_detail::npos;
+        }
+
+        template <typename U>
+        inline u32 _lookup(const U& key) const
+        {
+            if constexpr (lru_detail::DirectLookup<Hasher, Key, U>)
+            {
+                return _find(key, Hasher::get_hash(key));
+            }
+            else
+            {
+                Key _key = Key(key);
+                return _find(_key, Hasher::get_hash(_key));
+            }
+        }
+
+        inline void _unlink_list(u32 index)
+        {
+            auto& _entry = _entries[index];
+
+            if (_entry.prev != lru_detail::npos)
+                _entries[_entry.prev].next = _entry.next;
+            else
+                _head = _entry.next;
+
+            if (_entry.next != lru_detail::npos)
+                _entries[_entry.next].prev = _entry.prev;
+            else
+                _tail = _entry.prev;
+        }
+
+        inline void _push_front(u32 index)
+        {
+            auto& _entry = _entries[index];
+            _entry.prev = lru_detail::npos;
+            _entry.next = _head;
+
+            if (_head != lru_detail::npos)
+                _entries[_head].prev = index;
+            else
+                _tail = index;
+
+            _head = index;
+        }
+
+        inline void _touch(u32 index) const
+        {
+            if constexpr (Policy == cache_policy::clock)
+            {
+                // Skip the store if the bit is already set, so readers
+                // don't keep bouncing the cache line between cores
+                atomic_ref<uchar> _bit{_entries[index].referenced};
+
+                if (_bit.load(memory_order_relaxed) == 0)
+                    _bit.store(1, memory_order_relaxed);
+            }
+        }
+
+        inline void _promote(u32 index)
+        {
+            if constexpr (Policy == cache_policy::lru)
+            {
+                if (_head != index)
+                {
+                    _unlink_list(index);
+                    _push_front(index);
+                }
+            }
+            else
+            {
+                _touch(index);
+            }
+        }
+
+        inline void _unlink_chain(u32 index)
+        {
+            u32* _link = &_buckets[_entries[index].hash & _bucket_mask];
+
+            while (*_link != index)
+                _link = &_entries[*_link].chain;
+
+            *_link = _entries[index].chain;
+        }
+
+        // Destroys the entry and puts its slot on the free list
+        inline void _remove(u32 index)
+        {
+            _unlink_chain(index);
+
+            if constexpr (Policy == cache_policy::lru)
+                _unlink_list(index);
+
+            _entries[index].~entry_type();
+            _entries[index].chain = _free;
+            _free = index;
+            _size--;
+        }
+
+        inline u32 _victim()
+        {
+            if constexpr (Policy == cache_policy::lru)
+            {
+                return _tail;
+            }
+            else
+            {
+                // Every slot is in use when the cache is full
+                while (true)
+                {
+                    auto& _entry = _entries[_hand];
+                    u32 _index = _hand;
+                    _hand = (_hand + 1 == _capacity) ? 0 : _hand + 1;
+
+                    if (_entry.referenced == 0)
+                        return _index;
+
+                    _entry.referenced = 0;
+                }
+            }
+        }
+
+        inline u32 _acquire_slot()
+        {
+            if (_size == _capacity)
+            {
+                u32 _index = _victim();
+                auto& _entry = _entries[_index];
+                static_cast<void>(_on_evict(_entry.key, _entry.value));
+                _remove(_index);
+            }
+
+            if (_free != lru_detail::npos)
+            {
+                u32 _index = _free;
+                _free = _entries[_index].chain;
+                return _index;
+            }
+
+            return _used++;
+        }
+
+        template < typename NewKey, typename... Args >
+        inline T& _insert(usize key_hash, NewKey&& key, Args&&... args)
+        {
+            _check_storage().unwrap();
+            u32 _index = _acquire_slot();
+            auto& _bucket = _buckets[key_hash & _bucket_mask];
+
+            new (&_entries[_index]) entry_type{
+                Key(forward<NewKey>(key)), T{forward<Args>(args)...},
+                key_hash, _bucket, lru_detail::npos, lru_detail::npos, 0
+            };
+
+            _bucket = _index;
+            _size++;
+
+            if constexpr (Policy == cache_policy::lru)
+                _push_front(_index);
+
+            return _entries[_index].value;
+        }
+
+        inline void _destroy()
+        {
+            clear();
+
+            if (_entries != nullptr)
+            {
+                _entry_alloc.deallocate(_entries, _capacity).unwrap();
+                _bucket_alloc.deallocate(_buckets, _bucket_mask + 1).unwrap();
+                _entries = nullptr;
+                _buckets = nullptr;
+            }
+        }
+
+    public:
+        inline lru_cache(usize capacity)
+        requires (std::is_default_constructible_v<Allocator<entry_type>>)
+        {
+            _init(capacity).unwrap();
+        }
+
+        template <typename Alloc>
+        inline lru_cache(usize capacity, const Alloc& alloc)
+            : _entry_alloc(alloc), _bucket_alloc(alloc)
+        {
+            _init(capacity).unwrap();
+        }
+
+        lru_cache(const lru_cache&) = delete;
+        lru_cache& operator=(const lru_cache&) = delete;
+
+        inline lru_cache(lru_cache&& other)
+            : _entry_alloc(move(other._entry_alloc)),
+            _bucket_alloc(move(other._bucket_alloc)),
+            _entries{exchange(other._entries, nullptr)},
+            _buckets{exchange(other._buckets, nullptr)},
+            _capacity{exchange(other._capacity, 0u)},
+            _bucket_mask{exchange(other._bucket_mask, 0u)},
+            _size{exchange(other._size, 0u)},
+            _used{exchange(other._used, 0u)},
+            _free{exchange(other._free, lru_detail::npos)},
+            _head{exchange(other._head, lru_detail::npos)},
+            _tail{exchange(other._tail, lru_detail::npos)},
+            _hand{exchange(other._hand, 0u)},
+            _hits{other._hits}, _misses{other._misses},
+            _on_evict{move(other._on_evict)}
+        {}
+
+        inline ~lru_cache()
+        {
+            _destroy();
+        }
+
+        // Called with every entry that gets evicted to make room
+        // (not with the ones removed by `erase` or `clear`)
+        template <typename Func>
+        inline void on_evict(Func&& func)
+        {
+            _on_evict = forward<Func>(func);
+        }
+
+        // Counts as a use of the entry
+        template <typename U = Key>
+        inline auto get(const U& key)
+            -> Result< reference<T>, lru_detail::bad_key >
+        {
+            u32 _index = _lookup(key);
+
+            if (_index == lru_detail::npos)
+            {
+                _count(_misses);
+                return lru_detail::bad_key{};
+            }
+
+            _count(_hits);
+            _promote(_index);
+            return {_entries[_index].value};
+        }
+
+        // Safe for concurrent readers, only with the clock policy
+        template <typename U = Key>
+        inline auto get(const U& key) const
+            -> Result< reference<const T>, lru_detail::bad_key >
+        requires (Policy == cache_policy::clock)
+        {
+            u32 _index = _lookup(key);
+
+            if (_index == lru_detail::npos)
+            {
+                _count(_misses);
+                return lru_detail::bad_key{};
+            }
+
+            _count(_hits);
+            _touch(_index);
+            return {_entries[_index].value};
+        }
+
+        // Doesn't count as a use, nor as a hit or a miss
+        template <typename U = Key>
+        inline auto peek(const U& key) const
+            -> Result< reference<const T>, lru_detail::bad_key >
+        {
+            u32 _index = _lookup(key);
+
+            if (_index == lru_detail::npos)
+                return lru_detail::bad_key{};
+
+            return {_entries[_index].value};
+        }
+
+        template <typename U = Key>
+        inline bool contains(const U& key) const
+        {
+            return _lookup(key) != lru_detail::npos;
+        }
+
+        // Inserts or replaces the value, evicting an entry if full
+        // (a moved-from cache can't insert, it fails with `bad_capacity`)
+        template < typename NewKey, typename Value >
+        inline T& put(NewKey&& key, Value&& value)
+        {
+            if constexpr (!lru_detail::DirectLookup<Hasher, Key, NewKey>)
+            {
+                return put(Key(forward<NewKey>(key)), forward<Value>(value));
+            }
+            else
+            {
+                auto _key_hash = Hasher::get_hash(key);
+                u32 _index = _find(key, _key_hash);
+
+                if (_index != lru_detail::npos)
+                {
+                    _promote(_index);
+                    _entries[_index].value = forward<Value>(value);
+                    return _entries[_index].value;
+                }
+
+                return _insert(_key_hash, forward<NewKey>(key), forward<Value>(value));
+            }
+        }
+
+        // Returns the cached value, or builds it from `args` if absent
+        // (a moved-from cache can't insert, it fails with `bad_capacity`)
+        template < typename NewKey, typename... Args >
+        inline T& try_emplace(NewKey&& key, Args&&... args)
+        {
+            if constexpr (!lru_detail::DirectLookup<Hasher, Key, NewKey>)
+            {
+                return try_emplace(Key(forward<NewKey>(key)), forward<Args>(args)...);
+            }
+            else
+            {
+                auto _key_hash = Hasher::get_hash(key);
+                u32 _index = _find(key, _key_hash);
+
+                if (_index != lru_detail::npos)
+                {
+                    _promote(_index);
+                    return _entries[_index].value;
+                }
+
+                return _insert(_key_hash, forward<NewKey>(key), forward<Args>(args)...);
+            }
+        }
+
+        template <typename U = Key>
+        inline bool erase(const U& key)
+        {
+            u32 _index = _lookup(key);
+
+            if (_index == lru_detail::npos)
+                return false;
+
+            _remove(_index);
+            return true;
+        }
+
+        inline void clear()
+        {
+            // Only the live entries are reachable from the buckets
+            for (usize _bucket = 0; _bucket <= _bucket_mask && _size != 0; _bucket++)
+            {
+                u32 _index = _buckets[_bucket];
+
+                while (_index != lru_detail::npos)
+                {
+                    u32 _next = _entries[_index].chain;
+                    _entries[_index].~entry_type();
+                    _index = _next;
+                    _size--;
+                }
+
+                _buckets[_bucket] = lru_detail::npos;
+            }
+
+            _used = 0;
+            _free = _head = _tail = lru_detail::npos;
+            _hand = 0;
+        }
+
+        inline usize size() const
+        {
+            return _size;
+        }
+
+        inline usize capacity() const
+        {
+            return _capacity;
+        }
+
+        inline bool empty() const
+        {
+            return _size == 0;
+        }
+
+        inline usize hits() const
+        {
+            return _hits;
+        }
+
+        inline usize misses() const
+        {
+            return _misses;
+        }
+
+        inline f32 hit_ratio() const
+        {
+            usize _total = _hits + _misses;
+            return _total == 0 ? 0.f :
+                static_cast<f32>(_hits) / static_cast<f32>(_total);
+        }
+
+        inline void reset_stats()
+        {
+            _hits = _misses = 0;
+        }
+    };
+} // namespace hsd
@@ -8,7 +8,7 @@
 
 namespace hsd
 {
-    template <typename T> class list;
+    template < typename T, template <typename> typename Allocator > class list;
 
     namespace list_detail
     {
@@ -21,28 +21,26 @@ namespace hsd
         };
 
         template <typename T>
-        class iterator
+        struct list_node
         {
-        private:
-            struct list_impl
-            {
-                T _value;
-                list_impl* _next = nullptr;
-                list_impl* _back = nullptr;
-
-                inline list_impl() = default;
+            T _value;
+            list_node* _next = nullptr;
+            list_node* _back = nullptr;
 
-                inline list_impl(const T& val)
-                    : _value{val}
-                {}
+            template <typename... Args>
+            inline list_node(Args&&... args)
+                : _value{forward<Args>(args)...}
+            {}
+        };
 
-                inline list_impl(T&& val)
-                {
-                    _value = hsd::move(val);
-                }
-            }*_iterator = nullptr;
+        template <typename T>
+        class iterator
+        {
+        private:
+            list_node<T>* _iterator = nullptr;
 
-            friend class list<T>;
+            template < typename U, template <typename> typename Allocator >
+            friend class hsd::list;
 
             inline T* get()
             {
@@ -54,103 +52,19 @@ namespace hsd
                 return &_iterator->_value;
             }
 
-            inline void push_back(const T& value)
-            {
-                _iterator->_next = mallocator::allocate_single<
-                    list_impl>(value).unwrap();
-
-                _iterator->_next->_back = _iterator;
-                _iterator = _iterator->_next;
-            }
-
-            inline void push_back(T&& value)
-            {
-                _iterator->_next = mallocator::allocate_single<
-                    list_impl>(move(value)).unwrap();
-
-                _iterator->_next->_back = _iterator;
-                _iterator = _iterator->_next;
-            }
-
-            template <typename... Args>
-            inline void emplace_back(Args&&... args)
-            {
-                _iterator->_next = mallocator::allocate_single<
-                    list_impl>().unwrap();
-                
-                _iterator->_next->_value.~T();
-                mallocator::construct_at(
-                    &_iterator->_next->_value, forward<Args>(args)...
-                );
-                
-                _iterator->_next->_back = _iterator;
-                _iterator = _iterator->_next;
-            }
-
-            inline void pop_back()
-            {
-                list_impl* _element = _iterator;
-                _iterator = _iterator->_back;
-                
-                if (_iterator != nullptr)
-                    _iterator->_next = nullptr;
-                
-                mallocator::deallocate(_element);
-            }
-
-            inline void push_front(const T& value)
-            {
-                _iterator->_back = mallocator::allocate_single<
-                    list_impl>(value).unwrap();
-
-                _iterator->_back->_next = _iterator;
-                _iterator = _iterator->_back;
-            }
-
-            inline void push_front(T&& value)
-            {
-                _iterator->_back = mallocator::allocate_single<
-                    list_impl>(move(value)).unwrap();
-
-                _iterator->_back->_next = _iterator;
-                _iterator = _iterator->_back;
-            }
-
-            template <typename... Args>
-            inline void emplace_front(Args&&... args)
-            {
-                _iterator->_back = mallocator::allocate_single<
-                    list_impl>().unwrap();
-
-                _iterator->_back->_value.~T();
-                mallocator::construct_at(
-                    &_iterator->_back->_value, forward<Args>(args)...
-                );
-
-                _iterator->_back->_next = _iterator;
-                _iterator = _iterator->_back;
-            }
-
-            inline void pop_front()
-            {
-                list_impl* _element = _iterator;
-                _iterator = _iterator->_next;
-                
-                if (_iterator != nullptr)
-                    _iterator->_back = nullptr;
-                
-                mallocator::deallocate(_element);
-            }
-
         public:
             inline iterator() {}
             inline iterator(hsd::NullType) {}
 
+            inline iterator(list_node<T>* node)
+                : _iterator{node}
+            {}
+
             inline iterator(const iterator& other)
             {
                 _iterator = other._iterator;
             }
-        
+
             inline iterator& operator=(const iterator& rhs)
             {
                 _iterator = rhs._iterator;
@@ -213,33 +127,367 @@ namespace hsd
                 return get();
             }
         };
+
+        template <typename T, typename Tag>
+        class intrusive_list;
+
+        template <typename T, typename Tag, bool Const>
+        class intrusive_iterator;
+
+        // Links of an element of an `intrusive_list`, use a different
+        // `Tag` for every list the same element can be a part of
+        template <typename Tag = void>
+        class list_hook
+        {
+        private:
+            list_hook* _next = nullptr;
+            list_hook* _back = nullptr;
+
+            template <typename T, typename U>
+            friend class intrusive_list;
+
+            template <typename T, typename U, bool Const>
+            friend class intrusive_iterator;
+
+        public:
+            inline list_hook() = default;
+
+            // The links belong to the list, not to the value
+            inline list_hook(const list_hook&)
+            {}
+
+            inline list_hook& operator=(const list_hook&)
+            {
+                return *this;
+            }
+
+            inline bool is_linked() const
+            {
+                return _next != nullptr;
+            }
+        };
+
+        template <typename T, typename Tag, bool Const>
+        class intrusive_iterator
+        {
+        private:
+            using hook_type = conditional_t<Const, const list_hook<Tag>, list_hook<Tag>>;
+            using value_type = conditional_t<Const, const T, T>;
+
+            hook_type* _hook = nullptr;
+
+            template <typename U, typename V>
+            friend class intrusive_list;
+
+        public:
+            inline intrusive_iterator(hook_type* hook)
+                : _hook{hook}
+            {}
+
+            inline bool operator==(const intrusive_iterator& rhs) const
+            {
+                return _hook == rhs._hook;
+            }
+
+            inline bool operator!=(const intrusive_iterator& rhs) const
+            {
+                return _hook != rhs._hook;
+            }
+
+            inline intrusive_iterator& operator++()
+            {
+                _hook = _hook->_next;
+                return *this;
+            }
+
+            inline intrusive_iterator& operator--()
+            {
+                _hook = _hook->_back;
+                return *this;
+            }
+
+            inline intrusive_iterator operator++(i32)
+            {
+                intrusive_iterator _tmp = *this;
+                operator++();
+                return _tmp;
+            }
+
+            inline intrusive_iterator operator--(i32)
+            {
+                intrusive_iterator _tmp = *this;
+                operator--();
+                return _tmp;
+            }
+
+            inline value_type& operator*() const
+            {
+                return static_cast<value_type&>(*_hook);
+            }
+
+            inline value_type* operator->() const
+            {
+                return &operator*();
+            }
+        };
+
+        // Doubly linked list over elements that inherit `list_hook<Tag>`.
+        // It never allocates and never owns the elements, they have to
+        // outlive their time in the list. Any element can be removed in
+        // O(1) through a reference to it
+        template <typename T, typename Tag = void>
+        class intrusive_list
+        {
+        private:
+            using hook_type = list_hook<Tag>;
+
+            // Circular, `_root` stands before the first and after the last
+            hook_type _root;
+            usize _size = 0;
+
+            inline void _reset()
+            {
+                _root._next = &_root;
+                _root._back = &_root;
+                _size = 0;
+            }
+
+            static inline hook_type* _hook_of(T& value)
+            {
+                return static_cast<hook_type*>(&value);
+            }
+
+            inline void _link_before(hook_type* pos, hook_type* hook)
+            {
+                hook->_next = pos;
+                hook->_back = pos->_back;
+                pos->_back->_next = hook;
+                pos->_back = hook;
+                _size++;
+            }
+
+            inline hook_type* _unlink(hook_type* hook)
+            {
+                hook_type* _next = hook->_next;
+                hook->_back->_next = _next;
+                _next->_back = hook->_back;
+                hook->_next = nullptr;
+                hook->_back = nullptr;
+                _size--;
+                return _next;
+            }
+
+        public:
+            using iterator = intrusive_iterator<T, Tag, false>;
+            using const_iterator = intrusive_iterator<T, Tag, true>;
+
+            inline intrusive_list()
+            {
+                _reset();
+            }
+
+            inline intrusive_list(const intrusive_list&) = delete;
+            inline intrusive_list& operator=(const intrusive_list&) = delete;
+
+            inline intrusive_list(intrusive_list&& other)
+            {
+                _reset();
+                *this = move(other);
+            }
+
+            inline intrusive_list& operator=(intrusive_list&& rhs)
+            {
+                if (this != &rhs)
+                {
+                    clear();
+
+                    if (!rhs.empty())
+                    {
+                        _root._next = rhs._root._next;
+                        _root._back = rhs._root._back;
+                        _root._next->_back = &_root;
+                        _root._back->_next = &_root;
+                        _size = rhs._size;
+                        rhs._reset();
+                    }
+                }
+
+                return *this;
+            }
+
+            inline ~intrusive_list()
+            {
+                clear();
+            }
+
+            inline void push_back(T& value)
+            {
+                _link_before(&_root, _hook_of(value));
+            }
+
+            inline void push_front(T& value)
+            {
+                _link_before(_root._next, _hook_of(value));
+            }
+
+            // Links `value` before `pos`
+            inline iterator insert(iterator pos, T& value)
+            {
+                _link_before(pos._hook, _hook_of(value));
+                return {_hook_of(value)};
+            }
+
+            inline void pop_back()
+            {
+                if (!empty())
+                    _unlink(_root._back);
+            }
+
+            inline void pop_front()
+            {
+                if (!empty())
+                    _unlink(_root._next);
+            }
+
+            inline iterator erase(iterator pos)
+            {
+                return {_unlink(pos._hook)};
+            }
+
+            // Unlinks `value`, which has to be in this list
+            inline void erase(T& value)
+            {
+                _unlink(_hook_of(value));
+            }
+
+            inline iterator iterator_to(T& value)
+            {
+                return {_hook_of(value)};
+            }
+
+            // Unlinks every element, it does not touch the elements otherwise
+            inline void clear()
+            {
+                hook_type* _hook = _root._next;
+
+                while (_hook != &_root)
+                {
+                    hook_type* _next = _hook->_next;
+                    _hook->_next = nullptr;
+                    _hook->_back = nullptr;
+                    _hook = _next;
+                }
+
+                _reset();
+            }
+
+            inline usize size() const
+            {
+                return _size;
+            }
+
+            inline bool empty() const
+            {
+                return _size == 0;
+            }
+
+            inline T& front()
+            {
+                return static_cast<T&>(*_root._next);
+            }
+
+            inline T& back()
+            {
+                return static_cast<T&>(*_root._back);
+            }
+
+            inline iterator begin()
+            {
+                return {_root._next};
+            }
+
+            inline iterator end()
+            {
+                return {&_root};
+            }
+
+            inline const_iterator begin() const
+            {
+                return {_root._next};
+            }
+
+            inline const_iterator end() const
+            {
+                return {&_root};
+            }
+        };
     } // namespace list_detail
 
-    template <typename T>
+    template < typename Tag = void >
+    using list_hook = list_detail::list_hook<Tag>;
+
+    template < typename T, typename Tag = void >
+    using intrusive_list = list_detail::intrusive_list<T, Tag>;
+
+    // Nodes come from `Allocator`, by default every list keeps a pool
+    // of its own and reuses the nodes it frees
+    template < typename T, template <typename> typename Allocator = node_pool_allocator >
     class list
     {
     private:
+        using node_type = list_detail::list_node<T>;
+
+        Allocator<node_type> _alloc;
         list_detail::iterator<T> _head;
         list_detail::iterator<T> _tail;
         usize _size = 0;
 
+        template <typename... Args>
+        inline node_type* _make_node(Args&&... args)
+        {
+            node_type* _node = _alloc.allocate(1).unwrap();
+            _alloc.construct_at(_node, forward<Args>(args)...);
+            return _node;
+        }
+
+        inline void _free_node(node_type* node)
+        {
+            node->~node_type();
+            _alloc.deallocate(node, 1).unwrap();
+        }
+
+        inline void _steal(list& other)
+        {
+            _head = exchange(other._head, nullptr);
+            _tail = exchange(other._tail, nullptr);
+            _size = exchange(other._size, 0u);
+        }
+
     public:
         using iterator = list_detail::iterator<T>;
         using const_iterator = const iterator;
-        inline list() {}
+
+        inline list()
+            requires (std::is_default_constructible_v<Allocator<node_type>>)
+        {}
+
+        template <typename Alloc>
+        inline list(const Alloc& alloc)
+        requires (std::is_constructible_v<Allocator<node_type>, Alloc>)
+            : _alloc(alloc)
+        {}
 
         inline list(const list& other)
+            : _alloc(other._alloc)
         {
             for(const auto& _element : other)
                 push_back(_element);
         }
 
         inline list(list&& other)
+            : _alloc(move(other._alloc))
         {
-            _head = other._head;
-            _tail = other._tail;
-            other._head = nullptr;
-            other._tail = nullptr;
+            _steal(other);
         }
 
         template <usize N>
@@ -263,21 +511,26 @@ namespace hsd
 
         inline list& operator=(const list& rhs)
         {
-            clear();
-            
-            for (const auto& _element : rhs)
-                push_back(_element);
-            
+            if (this != &rhs)
+            {
+                clear();
+
+                for (const auto& _element : rhs)
+                    push_back(_element);
+            }
+
             return *this;
         }
 
         inline list& operator=(list&& rhs)
         {
-            _head = rhs._head;
-            _tail = rhs._tail;
-            rhs._head = nullptr;
-            rhs._tail = nullptr;
-            
+            if (this != &rhs)
+            {
+                clear();
+                _alloc = move(rhs._alloc);
+                _steal(rhs);
+            }
+
             return *this;
         }
 
@@ -285,12 +538,8 @@ namespace hsd
         inline list& operator=(const T (&arr)[N])
         {
             clear();
-            usize _index = 0;
 
-            for (auto _it = begin(); _it != end() && _index < N; _it++, _index++)
-                *_it = arr[_index];
-
-            for (; _index < N; _index++)
+            for (usize _index = 0; _index < N; _index++)
                 push_back(arr[_index]);
 
             return *this;
@@ -300,12 +549,8 @@ namespace hsd
         inline list& operator=(T (&&arr)[N])
         {
             clear();
-            usize _index = 0;
 
-            for (auto _it = begin(); _it != end() && _index < N; _it++, _index++)
-                *_it = move(arr[_index]);
-
-            for (; _index < N; _index++)
+            for (usize _index = 0; _index < N; _index++)
                 push_back(move(arr[_index]));
 
             return *this;
@@ -334,18 +579,15 @@ namespace hsd
             }
             else
             {
-                iterator _next_iter, _back_iter;
-                _next_iter._iterator = pos._iterator->_next;
-                _back_iter._iterator = pos._iterator->_back;
-                _next_iter._iterator->_back = _back_iter._iterator;
-                _back_iter._iterator->_next = _next_iter._iterator;
+                node_type* _node = pos._iterator;
+                iterator _next_iter = _node->_next;
+                _node->_next->_back = _node->_back;
+                _node->_back->_next = _node->_next;
 
                 _size--;
-                delete pos._iterator;
+                _free_node(_node);
                 return _next_iter;
             }
-
-            return runtime_error{"Undefined Behaviour"};
         }
 
         inline void push_back(const T& value)
@@ -361,21 +603,19 @@ namespace hsd
         template <typename... Args>
         inline void emplace_back(Args&&... args)
         {
+            node_type* _node = _make_node(forward<Args>(args)...);
+
             if (empty())
             {
-                _head._iterator = mallocator::allocate_single<
-                    typename iterator::list_impl>().unwrap();
-
-                _head._iterator->_value.~T();
-                mallocator::construct_at(
-                    &_head._iterator->_value, forward<Args>(args)...
-                );
-
-                _tail = _head;
+                _head._iterator = _node;
             }
             else
-                _tail.emplace_back(forward<Args>(args)...);
+            {
+                _node->_back = _tail._iterator;
+                _tail._iterator->_next = _node;
+            }
 
+            _tail._iterator = _node;
             _size++;
         }
 
@@ -383,12 +623,17 @@ namespace hsd
         {
             if (!empty())
             {
-                _tail.pop_back();
-            }
-            else
-                _head = _tail;
+                node_type* _node = _tail._iterator;
+                _tail._iterator = _node->_back;
 
-            _size--;
+                if (_tail._iterator != nullptr)
+                    _tail._iterator->_next = nullptr;
+                else
+                    _head._iterator = nullptr;
+
+                _free_node(_node);
+                _size--;
+            }
         }
 
         inline void push_front(const T& value)
@@ -404,21 +649,19 @@ namespace hsd
         template <typename... Args>
         inline void emplace_front(Args&&... args)
         {
+            node_type* _node = _make_node(forward<Args>(args)...);
+
             if (empty())
             {
-                _head._iterator = mallocator::allocate_single<
-                    typename iterator::list_impl>().unwrap();
-
-                _head._iterator->_value.~T();
-                mallocator::construct_at(
-                    &_head._iterator->_value, forward<Args>(args)...
-                );
-
-                _tail = _head;
+                _tail._iterator = _node;
             }
             else
-                _head.emplace_front(forward<Args>(args)...);
+            {
+                _node->_next = _head._iterator;
+                _head._iterator->_back = _node;
+            }
 
+            _head._iterator = _node;
             _size++;
         }
 
@@ -426,20 +669,23 @@ namespace hsd
         {
             if (!empty())
             {
-                _head.pop_front();
-            }
-            else
-                _tail = _head;
+                node_type* _node = _head._iterator;
+                _head._iterator = _node->_next;
 
-            _size--;
+                if (_head._iterator != nullptr)
+                    _head._iterator->_back = nullptr;
+                else
+                    _tail._iterator = nullptr;
+
+                _free_node(_node);
+                _size--;
+            }
         }
 
         inline void clear()
         {
-            for (; !empty(); pop_front())
-                ;
-                
-            pop_front();
+            while (!empty())
+                pop_front();
         }
 
         inline usize size() const
@@ -447,7 +693,7 @@ namespace hsd
             return _size;
         }
 
-        inline bool empty()
+        inline bool empty() const
         {
             return size() == 0;
         }
@@ -522,4 +768,7 @@ namespace hsd
             return rend();
         }
     };
-} // namespace hsd
\ No newline at end of file
+
+    template <typename T>
+    using buffered_list = list<T, buffered_allocator>;
+} // namespace hsd
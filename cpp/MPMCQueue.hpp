@@ -16,14 +16,11 @@ namespace hsd
         template <typename T>
         struct slot
         {
-            void destroy()
+            // Drops what a pop left behind, the member itself is only
+            // destroyed once, with the slot
+            void release()
             {
-                storage.~T();
-            }
-
-            ~slot()
-            {
-                destroy();
+                storage = T{};
             }
 
             slot() requires (std::is_default_constructible_v<T>)
@@ -132,7 +129,7 @@ namespace hsd
                     if (_tail.compare_exchange_strong(tail, tail + 1))
                     {
                         value = move(slot.storage);
-                        slot.destroy();
+                        slot.release();
                         slot.ticket.store(turn(tail) * 2 + 2, hsd::memory_order_release);
                         return true;
                     }
@@ -171,7 +168,7 @@ namespace hsd
                 ;
 
             value = move(slot.storage);
-            slot.destroy();
+            slot.release();
             slot.ticket.store(turn(tail) * 2 + 2, hsd::memory_order_release);
         }
 
@@ -0,0 +1,556 @@
+#pragma once
+
+#include "Allocator.hpp"
+#include "Atomic.hpp"
+
+namespace hsd
+{
+    namespace pool_detail
+    {
+        static constexpr usize default_block_count = 64;
+
+        // Slab `n` holds `BlockCount << n` slots, the table of slabs
+        // never moves and an index maps to its slot in O(1)
+        static constexpr usize max_slabs = 32;
+
+        // The links of the lock-free stack are 32 bit, so are the indices
+        static constexpr u64 max_slots = 0xFFFFFFFFull;
+
+        // A free slot holds the link of the free list
+        static constexpr usize slot_align(usize align)
+        {
+            return align < alignof(void*) ? alignof(void*) : align;
+        }
+
+        static constexpr usize slot_size(usize size, usize align)
+        {
+            usize _size = size < sizeof(void*) ? sizeof(void*) : size;
+            return (_size + slot_align(align) - 1) / slot_align(align) * slot_align(align);
+        }
+
+        static inline usize slab_of(u64 index, usize block_count)
+        {
+            return static_cast<usize>(63 - __builtin_clzll(index / block_count + 1));
+        }
+
+        static constexpr u64 slab_start(usize slab, usize block_count)
+        {
+            return block_count * ((1ull << slab) - 1);
+        }
+
+        static constexpr usize slab_bytes(usize slab, usize block_count, usize size)
+        {
+            return (block_count << slab) * size;
+        }
+
+        static inline void*& next_of(void* slot)
+        {
+            return *static_cast<void**>(slot);
+        }
+
+        // Process wide pool of `Size` byte slots. Fresh slots are carved
+        // in runs of `BlockCount` from slabs that are kept for the whole
+        // program. The free slots are a Treiber stack whose head packs a
+        // tag in the upper 32 bits and the index of the top slot plus one
+        // in the lower 32 bits, every change bumps the tag so a stale
+        // head never compares equal (ABA). Slots are named by index and
+        // not by address so the head fits a plain 64 bit compare and
+        // swap. A popped slot can still be read by a thread that lost
+        // the race, which is fine since the slabs are never given back
+        template <usize Size, usize BlockCount>
+        class atomic_pool
+        {
+        private:
+            atomic<uchar*> _slabs[max_slabs] = {};
+            atomic_u64 _head = 0;
+            atomic_u64 _next = 0;
+
+            static inline u64 _pack(u64 tag, u64 link)
+            {
+                return (tag << 32) | link;
+            }
+
+            static inline atomic_ref<u32> _link(void* slot)
+            {
+                return atomic_ref<u32>{*static_cast<u32*>(slot)};
+            }
+
+            // The slab has to exist, the index came from the stack or
+            // from a run that allocated it
+            inline uchar* _slot(u64 index)
+            {
+                usize _slab = slab_of(index, BlockCount);
+                return _slabs[_slab].load(memory_order_acquire) +
+                    (index - slab_start(_slab, BlockCount)) * Size;
+            }
+
+            // Newest slabs are the biggest, so they are searched first
+            inline u64 _index_of(void* ptr)
+            {
+                auto* _ptr = static_cast<uchar*>(ptr);
+                u64 _carved = _next.load(memory_order_relaxed);
+                usize _slab = slab_of(_carved < max_slots ? _carved : max_slots - 1, BlockCount) + 1;
+
+                while (_slab-- > 0)
+                {
+                    uchar* _begin = _slabs[_slab].load(memory_order_acquire);
+
+                    if (_begin != nullptr && _ptr >= _begin &&
+                        _ptr < _begin + slab_bytes(_slab, BlockCount, Size))
+                    {
+                        return slab_start(_slab, BlockCount) +
+                            static_cast<u64>(_ptr - _begin) / Size;
+                    }
+                }
+
+                return max_slots;
+            }
+
+            // Racing threads can both allocate the slab, the loser frees its own
+            inline uchar* _acquire_slab(usize slab)
+            {
+                uchar* _current = _slabs[slab].load(memory_order_acquire);
+
+                if (_current != nullptr)
+                    return _current;
+
+                auto* _fresh = static_cast<uchar*>(malloc(slab_bytes(slab, BlockCount, Size)));
+
+                if (_fresh == nullptr)
+                    return nullptr;
+
+                if (!_slabs[slab].compare_exchange_strong(
+                    _current, _fresh, memory_order_acq_rel, memory_order_acquire))
+                {
+                    free(_fresh);
+                    return _current;
+                }
+
+                return _fresh;
+            }
+
+            // Puts the slots `first` to `last`, already linked to each
+            // other, on top of the stack
+            inline void _push_chain(u64 first, void* last)
+            {
+                u64 _old = _head.load(memory_order_relaxed);
+
+                do
+                {
+                    _link(last).store(static_cast<u32>(_old), memory_order_relaxed);
+                } while (!_head.compare_exchange_weak(
+                    _old, _pack((_old >> 32) + 1, first + 1),
+                    memory_order_release, memory_order_relaxed));
+            }
+
+        public:
+            constexpr atomic_pool() = default;
+
+            // `BlockCount` fresh slots in a row, runs never cross a slab
+            inline auto carve_run()
+                -> Result< void*, allocator_detail::allocator_error >
+            {
+                u64 _index = _next.fetch_add(BlockCount, memory_order_relaxed);
+
+                if (_index + BlockCount > max_slots)
+                    return {allocator_detail::allocator_error{"The pool is exhausted"}, err_value{}};
+
+                usize _slab = slab_of(_index, BlockCount);
+                uchar* _begin = _acquire_slab(_slab);
+
+                if (_begin == nullptr)
+                    return {allocator_detail::allocator_error{"No space left in RAM"}, err_value{}};
+
+                return {_begin + (_index - slab_start(_slab, BlockCount)) * Size, ok_value{}};
+            }
+
+            inline auto allocate()
+                -> Result< void*, allocator_detail::allocator_error >
+            {
+                u64 _old = _head.load(memory_order_acquire);
+
+                while ((_old & max_slots) != 0)
+                {
+                    uchar* _top = _slot((_old & max_slots) - 1);
+                    u64 _next_link = _link(_top).load(memory_order_relaxed);
+
+                    if (_head.compare_exchange_weak(
+                        _old, _pack((_old >> 32) + 1, _next_link),
+                        memory_order_acquire, memory_order_acquire))
+                    {
+                        return {_top, ok_value{}};
+                    }
+                }
+
+                auto _run = carve_run();
+
+                if (!_run)
+                    return _run;
+
+                // The first slot is the result, the rest go on the stack
+                auto* _begin = static_cast<uchar*>(_run.unwrap());
+
+                if constexpr (BlockCount > 1)
+                {
+                    u64 _first = _index_of(_begin);
+
+                    for (usize _pos = 1; _pos + 1 < BlockCount; _pos++)
+                        _link(_begin + _pos * Size).store(static_cast<u32>(_first + _pos + 2), memory_order_relaxed);
+
+                    _push_chain(_first + 1, _begin + (BlockCount - 1) * Size);
+                }
+
+                return {_begin, ok_value{}};
+            }
+
+            inline void deallocate(void* ptr)
+            {
+                _push_chain(_index_of(ptr), ptr);
+            }
+
+            // Takes the whole stack at once and links it by pointer
+            // instead, returns the first slot and sets `count`
+            inline void* take_all(usize& count)
+            {
+                u64 _old = _head.load(memory_order_acquire);
+
+                count = 0;
+
+                do
+                {
+                    if ((_old & max_slots) == 0)
+                        return nullptr;
+                } while (!_head.compare_exchange_weak(
+                    _old, _pack((_old >> 32) + 1, 0),
+                    memory_order_acquire, memory_order_acquire));
+
+                uchar* _first = _slot((_old & max_slots) - 1);
+
+                for (uchar* _current = _first; _current != nullptr; count++)
+                {
+                    u64 _next_link = _link(_current).load(memory_order_relaxed);
+                    uchar* _next_slot = _next_link != 0 ? _slot(_next_link - 1) : nullptr;
+                    next_of(_current) = _next_slot;
+                    _current = _next_slot;
+                }
+
+                return _first;
+            }
+
+            // Gives back slots linked by pointer, with one swap of the head
+            inline void give_back(void* first)
+            {
+                u64 _first = _index_of(first);
+                void* _current = first;
+                void* _next_slot = next_of(_current);
+
+                while (_next_slot != nullptr)
+                {
+                    void* _after = next_of(_next_slot);
+                    _link(_current).store(static_cast<u32>(_index_of(_next_slot) + 1), memory_order_relaxed);
+                    _current = exchange(_next_slot, _after);
+                }
+
+                _push_chain(_first, _current);
+            }
+        };
+
+        // One pool per slot layout, types of the same size share it
+        template <usize Size, usize BlockCount>
+        inline constinit atomic_pool<Size, BlockCount> shared_pool{};
+
+        // Link of the pools a thread has used, whatever their layout
+        struct flushable
+        {
+            void (*flush)(flushable*);
+            flushable* next;
+        };
+
+        // Its destructor flushes every pool the thread has used. It is
+        // not a template, a thread_local variable template with a
+        // destructor is not destroyed at thread exit by every compiler
+        struct thread_flusher
+        {
+            flushable* armed = nullptr;
+
+            inline ~thread_flusher();
+        };
+
+        inline thread_local constinit bool flushed = false;
+        inline thread_local thread_flusher flusher{};
+
+        inline thread_flusher::~thread_flusher()
+        {
+            flushed = true;
+
+            while (armed != nullptr)
+            {
+                flushable* _pool = exchange(armed, armed->next);
+                _pool->flush(_pool);
+            }
+        }
+
+        // Free list of one thread in front of the shared pool. It is
+        // trivially destructible so it can still be reached after the
+        // thread has been flushed, from then on it forwards everything
+        template <usize Size, usize BlockCount>
+        class thread_pool
+            : private flushable
+        {
+        private:
+            void* _free = nullptr;
+            usize _count = 0;
+            uchar* _bump = nullptr;
+            uchar* _bump_end = nullptr;
+            bool _armed = false;
+            bool _closed = false;
+
+            static inline auto& _shared()
+            {
+                return shared_pool<Size, BlockCount>;
+            }
+
+            // Splits off the first `count` free slots
+            inline void* _detach(usize count)
+            {
+                void* _first = _free;
+                void* _last = _free;
+
+                for (usize _pos = 1; _pos < count; _pos++)
+                    _last = next_of(_last);
+
+                _free = exchange(next_of(_last), nullptr);
+                _count -= count;
+                return _first;
+            }
+
+            inline auto _refill()
+                -> Result< void*, allocator_detail::allocator_error >;
+
+            static inline void _flush(flushable* pool)
+            {
+                static_cast<thread_pool*>(pool)->flush();
+            }
+
+        public:
+            constexpr thread_pool()
+                : flushable{&_flush, nullptr}
+            {}
+
+            inline auto allocate()
+                -> Result< void*, allocator_detail::allocator_error >
+            {
+                if (_free != nullptr)
+                {
+                    _count--;
+                    return {exchange(_free, next_of(_free)), ok_value{}};
+                }
+
+                if (_bump != _bump_end)
+                {
+                    void* _result = _bump;
+                    _bump += Size;
+                    return {_result, ok_value{}};
+                }
+
+                return _refill();
+            }
+
+            // Past twice a run of free slots, a run goes back to the
+            // shared pool, so a thread that only frees does not hoard
+            inline void deallocate(void* ptr)
+            {
+                if (_closed)
+                    return _shared().deallocate(ptr);
+
+                next_of(ptr) = _free;
+                _free = ptr;
+
+                if (++_count > 2 * BlockCount)
+                    _shared().give_back(_detach(BlockCount));
+            }
+
+            // Run at the exit of the thread
+            inline void flush()
+            {
+                for (; _bump != _bump_end; _bump += Size)
+                    deallocate(_bump);
+
+                if (_free != nullptr)
+                    _shared().give_back(_detach(_count));
+
+                _closed = true;
+            }
+        };
+
+        template <usize Size, usize BlockCount>
+        inline thread_local constinit thread_pool<Size, BlockCount> local_pool{};
+
+        template <usize Size, usize BlockCount>
+        inline auto thread_pool<Size, BlockCount>::_refill()
+            -> Result< void*, allocator_detail::allocator_error >
+        {
+            // A pool first used while the thread exits is never cached
+            if (!_armed && flushed)
+                _closed = true;
+
+            if (_closed)
+                return _shared().allocate();
+
+            if (!_armed)
+            {
+                next = exchange(flusher.armed, static_cast<flushable*>(this));
+                _armed = true;
+            }
+
+            _free = _shared().take_all(_count);
+
+            if (_free != nullptr)
+                return allocate();
+
+            auto _run = _shared().carve_run();
+
+            if (!_run)
+                return _run;
+
+            _bump = static_cast<uchar*>(_run.unwrap());
+            _bump_end = _bump + BlockCount * Size;
+            return allocate();
+        }
+
+        // Slabs come from malloc, so stricter alignments are not pooled
+        template <typename T>
+        static constexpr bool is_poolable = alignof(T) <= alignof(max_align_t);
+    } // namespace pool_detail
+
+    // Fixed size object pool for single objects, like the counters of
+    // `shared_ptr` or the nodes of a list. Every allocator for the same
+    // object size shares one pool of slabs, each thread keeps its own
+    // intrusive free list in front of it, so allocating and freeing are
+    // a pop and a push with no synchronization. An object can be freed
+    // by any thread, the free slots of a thread go back to the shared
+    // pool when it exits. Anything but a single element goes straight
+    // to `allocator`
+    template < typename T, usize BlockCount = pool_detail::default_block_count >
+    class pool_allocator
+    {
+    private:
+        static constexpr usize _size = pool_detail::slot_size(sizeof(T), alignof(T));
+
+        static inline auto& _pool()
+        {
+            return pool_detail::local_pool<_size, BlockCount>;
+        }
+
+    public:
+        using pointer_type = T*;
+        using value_type = T;
+
+        inline pool_allocator() = default;
+
+        template <typename U>
+        inline pool_allocator(const pool_allocator<U, BlockCount>&)
+        {}
+
+        template <typename U>
+        inline pool_allocator& operator=(const pool_allocator<U, BlockCount>&)
+        {
+            return *this;
+        }
+
+        [[nodiscard]] inline auto allocate(usize size)
+            -> Result< T*, allocator_detail::allocator_error >
+        {
+            if (size != 1 || !pool_detail::is_poolable<T>)
+                return allocator<T>{}.allocate(size);
+
+            auto _result = _pool().allocate();
+
+            if (!_result)
+                return {_result.unwrap_err(), err_value{}};
+
+            return {static_cast<T*>(_result.unwrap()), ok_value{}};
+        }
+
+        inline auto deallocate(pointer_type ptr, usize size)
+            -> Result< void, allocator_detail::allocator_error >
+        {
+            if (size != 1 || !pool_detail::is_poolable<T>)
+                return allocator<T>{}.deallocate(ptr, size);
+
+            if (ptr != nullptr)
+                _pool().deallocate(ptr);
+
+            return {};
+        }
+
+        template <typename... Args>
+        static inline void construct_at(T* ptr, Args&&... args)
+        {
+            new (ptr) T{forward<Args>(args)...};
+        }
+    };
+
+    // Goes to the shared lock-free pool on every call, with no state
+    // per thread. Slower than `pool_allocator` on the same thread, but
+    // nothing is cached, for threads that allocate few objects
+    template < typename T, usize BlockCount = pool_detail::default_block_count >
+    class atomic_pool_allocator
+    {
+    private:
+        static constexpr usize _size = pool_detail::slot_size(sizeof(T), alignof(T));
+
+        static inline auto& _pool()
+        {
+            return pool_detail::shared_pool<_size, BlockCount>;
+        }
+
+    public:
+        using pointer_type = T*;
+        using value_type = T;
+
+        inline atomic_pool_allocator() = default;
+
+        template <typename U>
+        inline atomic_pool_allocator(const atomic_pool_allocator<U, BlockCount>&)
+        {}
+
+        template <typename U>
+        inline atomic_pool_allocator& operator=(const atomic_pool_allocator<U, BlockCount>&)
+        {
+            return *this;
+        }
+
+        [[nodiscard]] inline auto allocate(usize size)
+            -> Result< T*, allocator_detail::allocator_error >
+        {
+            if (size != 1 || !pool_detail::is_poolable<T>)
+                return allocator<T>{}.allocate(size);
+
+            auto _result = _pool().allocate();
+
+            if (!_result)
+                return {_result.unwrap_err(), err_value{}};
+
+            return {static_cast<T*>(_result.unwrap()), ok_value{}};
+        }
+
+        inline auto deallocate(pointer_type ptr, usize size)
+            -> Result< void, allocator_detail::allocator_error >
+        {
+            if (size != 1 || !pool_detail::is_poolable<T>)
+                return allocator<T>{}.deallocate(ptr, size);
+
+            if (ptr != nullptr)
+                _pool().deallocate(ptr);
+
+            return {};
+        }
+
+        template <typename... Args>
+        static inline void construct_at(T* ptr, Args&&... args)
+        {
+            new (ptr) T{forward<Args>(args)...};
+        }
+    };
+} // namespace hsd
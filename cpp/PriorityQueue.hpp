@@ -0,0 +1,434 @@
+#pragma once
+
+#include "Vector.hpp"
+
+namespace hsd
+{
+    namespace pq_detail
+    {
+        // Four children per node: the heap is half as deep as a binary
+        // one and the children of a node share a cache line or two
+        static constexpr usize arity = 4;
+        static constexpr usize npos = static_cast<usize>(-1);
+
+        struct bad_access
+        {
+            const char* operator()() const
+            {
+                return "Tried to access an empty priority queue";
+            }
+        };
+
+        struct bad_handle
+        {
+            const char* operator()() const
+            {
+                return "Tried to use a handle that is not in the queue";
+            }
+        };
+
+        // Both sifts carry the element in a hole instead of swapping,
+        // `moved(pos)` is called for every slot that gets a new element
+        template < typename T, typename Before, typename Moved >
+        inline usize sift_up(T* data, usize pos, Before& before, Moved&& moved)
+        {
+            T _value = move(data[pos]);
+
+            while (pos > 0)
+            {
+                usize _parent = (pos - 1) / arity;
+
+                if (!before(_value, data[_parent]))
+                    break;
+
+                data[pos] = move(data[_parent]);
+                moved(pos);
+                pos = _parent;
+            }
+
+            data[pos] = move(_value);
+            moved(pos);
+            return pos;
+        }
+
+        template < typename T, typename Before, typename Moved >
+        inline usize sift_down(T* data, usize size, usize pos, Before& before, Moved&& moved)
+        {
+            T _value = move(data[pos]);
+
+            while (true)
+            {
+                usize _first = pos * arity + 1;
+
+                if (_first >= size)
+                    break;
+
+                usize _last = _first + arity < size ? _first + arity : size;
+                usize _best = _first;
+
+                for (usize _child = _first + 1; _child < _last; _child++)
+                {
+                    if (before(data[_child], data[_best]))
+                        _best = _child;
+                }
+
+                if (!before(data[_best], _value))
+                    break;
+
+                data[pos] = move(data[_best]);
+                moved(pos);
+                pos = _best;
+            }
+
+            data[pos] = move(_value);
+            moved(pos);
+            return pos;
+        }
+
+        struct no_tracking
+        {
+            constexpr void operator()(usize) const {}
+        };
+    } // namespace pq_detail
+
+    // 4-ary heap over a vector. `Compare(a, b)` returning true means
+    // that `a` comes out before `b`, so with the default `less` the
+    // smallest element is on top (use `greater` for the largest)
+    template < typename T, typename Compare = less<T>,
+        template <typename> typename Allocator = allocator >
+    class priority_queue
+    {
+    private:
+        vector<T, Allocator> _heap;
+        Compare _comp;
+
+    public:
+        using value_type = T;
+        using const_iterator = typename vector<T, Allocator>::const_iterator;
+
+        inline priority_queue()
+            requires (std::is_default_constructible_v<Allocator<T>>)
+        {}
+
+        inline priority_queue(const Compare& comp)
+            requires (std::is_default_constructible_v<Allocator<T>>)
+            : _comp{comp}
+        {}
+
+        template <typename Alloc>
+        inline priority_queue(const Alloc& alloc, const Compare& comp = Compare{})
+        requires (std::is_constructible_v<Allocator<T>, Alloc>)
+            : _heap{alloc}, _comp{comp}
+        {}
+
+        // Builds the heap bottom up in O(n)
+        template <typename Iter>
+        inline void assign(Iter first, Iter last)
+        {
+            _heap.assign(first, last);
+
+            if (_heap.size() < 2)
+                return;
+
+            for (usize _index = (_heap.size() - 2) / pq_detail::arity + 1; _index > 0; _index--)
+            {
+                pq_detail::sift_down(
+                    _heap.data(), _heap.size(), _index - 1,
+                    _comp, pq_detail::no_tracking{}
+                );
+            }
+        }
+
+        inline const T& top() const
+        {
+            return _heap[0];
+        }
+
+        inline void push(const T& value)
+        {
+            emplace(value);
+        }
+
+        inline void push(T&& value)
+        {
+            emplace(move(value));
+        }
+
+        template <typename... Args>
+        inline void emplace(Args&&... args)
+        {
+            _heap.emplace_back(forward<Args>(args)...);
+            pq_detail::sift_up(_heap.data(), _heap.size() - 1, _comp, pq_detail::no_tracking{});
+        }
+
+        inline void pop()
+        {
+            if (_heap.size() == 0)
+                return;
+
+            if (_heap.size() > 1)
+                _heap[0] = move(_heap.back());
+
+            _heap.pop_back();
+
+            if (_heap.size() > 1)
+                pq_detail::sift_down(_heap.data(), _heap.size(), 0, _comp, pq_detail::no_tracking{});
+        }
+
+        // Removes the top element and hands it over
+        inline auto take()
+            -> Result<T, pq_detail::bad_access>
+        {
+            if (_heap.size() == 0)
+                return pq_detail::bad_access{};
+
+            T _value = move(_heap[0]);
+            pop();
+            return _value;
+        }
+
+        inline void reserve(usize count)
+        {
+            _heap.reserve(count);
+        }
+
+        inline void clear()
+        {
+            _heap.clear();
+        }
+
+        inline usize size() const
+        {
+            return _heap.size();
+        }
+
+        inline bool empty() const
+        {
+            return _heap.size() == 0;
+        }
+
+        // The elements in heap order, not sorted
+        inline const_iterator begin() const
+        {
+            return _heap.begin();
+        }
+
+        inline const_iterator end() const
+        {
+            return _heap.end();
+        }
+    };
+
+    // Priority queue whose elements can be changed or removed after
+    // the push through the handle it returns, both in O(log n).
+    // Handles of removed elements are reused by later pushes
+    template < typename T, typename Compare = less<T>,
+        template <typename> typename Allocator = allocator >
+    class indexed_priority_queue
+    {
+    private:
+        struct entry
+        {
+            T value;
+            usize handle;
+        };
+
+        struct entry_compare
+        {
+            Compare comp;
+
+            inline bool operator()(const entry& lhs, const entry& rhs)
+            {
+                return comp(lhs.value, rhs.value);
+            }
+        };
+
+        vector<entry, Allocator> _heap;
+        vector<usize, Allocator> _positions;
+        vector<usize, Allocator> _free_handles;
+        entry_compare _comp;
+
+        inline auto _tracker()
+        {
+            return [this](usize pos) {
+                _positions[_heap[pos].handle] = pos;
+            };
+        }
+
+        inline void _remove_at(usize pos)
+        {
+            _positions[_heap[pos].handle] = pq_detail::npos;
+            _free_handles.push_back(_heap[pos].handle);
+
+            if (pos + 1 != _heap.size())
+            {
+                _heap[pos] = move(_heap.back());
+                _heap.pop_back();
+                _fix(pos);
+            }
+            else
+            {
+                _heap.pop_back();
+            }
+        }
+
+        // Moves the element at `pos` up or down to where it belongs
+        inline void _fix(usize pos)
+        {
+            if (pos > 0 && _comp(_heap[pos], _heap[(pos - 1) / pq_detail::arity]))
+                pq_detail::sift_up(_heap.data(), pos, _comp, _tracker());
+            else
+                pq_detail::sift_down(_heap.data(), _heap.size(), pos, _comp, _tracker());
+        }
+
+    public:
+        using value_type = T;
+        using handle = usize;
+
+        inline indexed_priority_queue()
+            requires (std::is_default_constructible_v<Allocator<T>>)
+        {}
+
+        inline indexed_priority_queue(const Compare& comp)
+            requires (std::is_default_constructible_v<Allocator<T>>)
+            : _comp{comp}
+        {}
+
+        template <typename Alloc>
+        inline indexed_priority_queue(const Alloc& alloc, const Compare& comp = Compare{})
+        requires (std::is_constructible_v<Allocator<T>, Alloc>)
+            : _heap{alloc}, _positions{alloc}, _free_handles{alloc}, _comp{comp}
+        {}
+
+        inline const T& top() const
+        {
+            return _heap[0].value;
+        }
+
+        inline handle top_handle() const
+        {
+            return _heap[0].handle;
+        }
+
+        template <typename... Args>
+        inline handle emplace(Args&&... args)
+        {
+            handle _handle = _positions.size();
+
+            if (_free_handles.size() != 0)
+            {
+                _handle = _free_handles.back();
+                _free_handles.pop_back();
+            }
+            else
+            {
+                _positions.push_back(pq_detail::npos);
+            }
+
+            _heap.emplace_back(T{forward<Args>(args)...}, _handle);
+            pq_detail::sift_up(_heap.data(), _heap.size() - 1, _comp, _tracker());
+            return _handle;
+        }
+
+        inline handle push(const T& value)
+        {
+            return emplace(value);
+        }
+
+        inline handle push(T&& value)
+        {
+            return emplace(move(value));
+        }
+
+        inline void pop()
+        {
+            if (_heap.size() != 0)
+                _remove_at(0);
+        }
+
+        inline auto take()
+            -> Result<T, pq_detail::bad_access>
+        {
+            if (_heap.size() == 0)
+                return pq_detail::bad_access{};
+
+            T _value = move(_heap[0].value);
+            _remove_at(0);
+            return _value;
+        }
+
+        inline bool contains(handle id) const
+        {
+            return id < _positions.size() && _positions[id] != pq_detail::npos;
+        }
+
+        inline auto get(handle id) const
+            -> Result< reference<const T>, pq_detail::bad_handle >
+        {
+            if (!contains(id))
+                return pq_detail::bad_handle{};
+
+            return {_heap[_positions[id]].value};
+        }
+
+        // For a value that comes out no later than the current one
+        // (e.g. a shorter distance with `less`), it only moves up
+        inline auto decrease_key(handle id, T value)
+            -> Result<void, pq_detail::bad_handle>
+        {
+            if (!contains(id))
+                return pq_detail::bad_handle{};
+
+            usize _pos = _positions[id];
+            _heap[_pos].value = move(value);
+            pq_detail::sift_up(_heap.data(), _pos, _comp, _tracker());
+            return {};
+        }
+
+        // Changes the value to anything, moving it either way
+        inline auto update(handle id, T value)
+            -> Result<void, pq_detail::bad_handle>
+        {
+            if (!contains(id))
+                return pq_detail::bad_handle{};
+
+            usize _pos = _positions[id];
+            _heap[_pos].value = move(value);
+            _fix(_pos);
+            return {};
+        }
+
+        inline auto erase(handle id)
+            -> Result<void, pq_detail::bad_handle>
+        {
+            if (!contains(id))
+                return pq_detail::bad_handle{};
+
+            _remove_at(_positions[id]);
+            return {};
+        }
+
+        inline void reserve(usize count)
+        {
+            _heap.reserve(count);
+            _positions.reserve(count);
+        }
+
+        inline void clear()
+        {
+            _heap.clear();
+            _positions.clear();
+            _free_handles.clear();
+        }
+
+        inline usize size() const
+        {
+            return _heap.size();
+        }
+
+        inline bool empty() const
+        {
+            return _heap.size() == 0;
+        }
+    };
+} // namespace hsd
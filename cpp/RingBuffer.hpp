@@ -0,0 +1,619 @@
+#pragma once
+
+#include "Result.hpp"
+#include "Reference.hpp"
+#include "Pair.hpp"
+#include "Span.hpp"
+#include "Allocator.hpp"
+
+namespace hsd
+{
+    enum class ring_policy
+    {
+        // Pushing into a full buffer fails and leaves it as it was
+        reject,
+        // Pushing into a full buffer drops the element at the other end
+        overwrite
+    };
+
+    namespace ring_detail
+    {
+        // The capacity of a ring_buffer that is sized at runtime
+        static constexpr usize dynamic_capacity = 0;
+
+        struct bad_access
+        {
+            const char* operator()() const
+            {
+                return "Tried to access an element out of bounds";
+            }
+        };
+
+        static constexpr usize round_capacity(usize capacity)
+        {
+            usize _result = 1;
+
+            while (_result < capacity)
+                _result *= 2;
+
+            return _result;
+        }
+
+        template < typename T, usize N, template <typename> typename Allocator >
+        class storage
+        {
+        private:
+            alignas(T) uchar _buf[N * sizeof(T)];
+
+        public:
+            // The elements are copied by the ring buffer itself
+            inline storage() = default;
+
+            inline storage(const storage&)
+            {}
+
+            inline storage& operator=(const storage&)
+            {
+                return *this;
+            }
+
+            inline T* data()
+            {
+                return bit_cast<T*>(&_buf[0]);
+            }
+
+            inline const T* data() const
+            {
+                return bit_cast<const T*>(&_buf[0]);
+            }
+
+            static constexpr usize capacity()
+            {
+                return N;
+            }
+        };
+
+        template < typename T, template <typename> typename Allocator >
+        class storage<T, dynamic_capacity, Allocator>
+        {
+        private:
+            Allocator<T> _alloc;
+            T* _data = nullptr;
+            usize _capacity = 0;
+
+        public:
+            inline storage() = default;
+
+            template < typename... Alloc >
+            inline storage(usize capacity, const Alloc&... alloc)
+                : _alloc(alloc...), _capacity{capacity}
+            {
+                _data = _alloc.allocate(capacity).unwrap();
+            }
+
+            inline storage(const storage& other)
+                : storage(other._capacity, other._alloc)
+            {}
+
+            inline storage(storage&& other)
+                : _alloc(other._alloc)
+            {
+                _data = exchange(other._data, nullptr);
+                _capacity = exchange(other._capacity, 0u);
+            }
+
+            inline storage& operator=(storage&& rhs)
+            {
+                if (_data != nullptr)
+                    _alloc.deallocate(_data, _capacity).unwrap();
+
+                _alloc = rhs._alloc;
+                _data = exchange(rhs._data, nullptr);
+                _capacity = exchange(rhs._capacity, 0u);
+                return *this;
+            }
+
+            inline ~storage()
+            {
+                if (_data != nullptr)
+                    _alloc.deallocate(_data, _capacity).unwrap();
+            }
+
+            inline T* data()
+            {
+                return _data;
+            }
+
+            inline const T* data() const
+            {
+                return _data;
+            }
+
+            inline usize capacity() const
+            {
+                return _capacity;
+            }
+        };
+
+        template <typename T>
+        class iterator
+        {
+        private:
+            T* _data = nullptr;
+            usize _mask = 0;
+            usize _pos = 0;
+
+            template <typename>
+            friend class iterator;
+
+        public:
+            inline iterator() = default;
+
+            inline iterator(T* data, usize mask, usize pos)
+                : _data{data}, _mask{mask}, _pos{pos}
+            {}
+
+            template <typename U>
+            requires (IsSame<const U, T>)
+            inline iterator(const iterator<U>& other)
+                : _data{other._data}, _mask{other._mask}, _pos{other._pos}
+            {}
+
+            inline bool operator==(const iterator& rhs) const
+            {
+                return _pos == rhs._pos;
+            }
+
+            inline bool operator!=(const iterator& rhs) const
+            {
+                return _pos != rhs._pos;
+            }
+
+            inline iterator& operator++()
+            {
+                _pos++;
+                return *this;
+            }
+
+            inline iterator operator++(i32)
+            {
+                iterator _tmp = *this;
+                _pos++;
+                return _tmp;
+            }
+
+            inline iterator& operator--()
+            {
+                _pos--;
+                return *this;
+            }
+
+            inline iterator operator--(i32)
+            {
+                iterator _tmp = *this;
+                _pos--;
+                return _tmp;
+            }
+
+            inline T& operator*() const
+            {
+                return _data[_pos & _mask];
+            }
+
+            inline T* operator->() const
+            {
+                return &operator*();
+            }
+        };
+    } // namespace ring_detail
+
+    // Circular buffer with a power of two capacity, so wrapping an
+    // index around is a mask. `N` rounded up is the capacity, leaving
+    // it out gives a buffer that is sized (and allocated) at runtime.
+    // The positions of both ends are free running counters, the
+    // element at position `pos` lives in slot `pos & (capacity - 1)`
+    template < typename T, usize N = ring_detail::dynamic_capacity,
+        ring_policy Policy = ring_policy::reject,
+        template <typename> typename Allocator = allocator >
+    class ring_buffer
+    {
+    private:
+        static constexpr bool _is_dynamic = N == ring_detail::dynamic_capacity;
+        static constexpr usize _static_capacity = ring_detail::round_capacity(N);
+
+        using storage_type = ring_detail::storage<
+            T, _is_dynamic ? ring_detail::dynamic_capacity : _static_capacity, Allocator
+        >;
+
+        storage_type _storage;
+        usize _head = 0;
+        usize _tail = 0;
+
+        inline usize _mask() const
+        {
+            return _storage.capacity() - 1;
+        }
+
+        inline T& _slot(usize pos)
+        {
+            return _storage.data()[pos & _mask()];
+        }
+
+        inline const T& _slot(usize pos) const
+        {
+            return _storage.data()[pos & _mask()];
+        }
+
+        inline void _copy_from(const ring_buffer& other)
+        {
+            for (usize _pos = other._head; _pos != other._tail; _pos++)
+                construct_at(&_slot(_pos - other._head), other._slot(_pos));
+
+            _tail = other._tail - other._head;
+        }
+
+        inline void _move_from(ring_buffer& other)
+        {
+            for (usize _pos = other._head; _pos != other._tail; _pos++)
+            {
+                construct_at(&_slot(_pos - other._head), move(other._slot(_pos)));
+                other._slot(_pos).~T();
+            }
+
+            _tail = other._tail - other._head;
+            other._head = other._tail = 0;
+        }
+
+        template <typename... Args>
+        static inline void construct_at(T* ptr, Args&&... args)
+        {
+            new (ptr) T{forward<Args>(args)...};
+        }
+
+    public:
+        using value_type = T;
+        using iterator = ring_detail::iterator<T>;
+        using const_iterator = ring_detail::iterator<const T>;
+
+        inline ~ring_buffer()
+        {
+            clear();
+        }
+
+        inline ring_buffer()
+        requires (!_is_dynamic)
+        {}
+
+        // The capacity is rounded up to a power of two
+        template < typename... Alloc >
+        inline ring_buffer(usize capacity, const Alloc&... alloc)
+        requires (_is_dynamic && sizeof...(Alloc) <= 1)
+            : _storage{ring_detail::round_capacity(capacity), alloc...}
+        {}
+
+        inline ring_buffer(const ring_buffer& other)
+            : _storage{other._storage}
+        {
+            _copy_from(other);
+        }
+
+        inline ring_buffer(ring_buffer&& other)
+            : _storage{move(other._storage)}
+        {
+            if constexpr (_is_dynamic)
+            {
+                _head = exchange(other._head, 0u);
+                _tail = exchange(other._tail, 0u);
+            }
+            else
+            {
+                _move_from(other);
+            }
+        }
+
+        inline ring_buffer& operator=(const ring_buffer& rhs)
+        {
+            if (this != &rhs)
+            {
+                clear();
+
+                if constexpr (_is_dynamic)
+                {
+                    if (_storage.capacity() != rhs._storage.capacity())
+                        _storage = storage_type{rhs._storage};
+                }
+
+                _copy_from(rhs);
+            }
+
+            return *this;
+        }
+
+        inline ring_buffer& operator=(ring_buffer&& rhs)
+        {
+            if (this != &rhs)
+            {
+                clear();
+
+                if constexpr (_is_dynamic)
+                {
+                    _storage = move(rhs._storage);
+                    _head = exchange(rhs._head, 0u);
+                    _tail = exchange(rhs._tail, 0u);
+                }
+                else
+                {
+                    _move_from(rhs);
+                }
+            }
+
+            return *this;
+        }
+
+        // Index 0 is the front
+        inline auto& operator[](usize index)
+        {
+            return _slot(_head + index);
+        }
+
+        inline auto& operator[](usize index) const
+        {
+            return _slot(_head + index);
+        }
+
+        inline auto at(usize index)
+            -> Result<reference<T>, ring_detail::bad_access>
+        {
+            if (index >= size())
+                return ring_detail::bad_access{};
+
+            return {_slot(_head + index)};
+        }
+
+        inline auto at(usize index) const
+            -> Result< const reference<T>, ring_detail::bad_access >
+        {
+            if (index >= size())
+                return ring_detail::bad_access{};
+
+            return {_slot(_head + index)};
+        }
+
+        inline auto& front()
+        {
+            return _slot(_head);
+        }
+
+        inline auto& front() const
+        {
+            return _slot(_head);
+        }
+
+        inline auto& back()
+        {
+            return _slot(_tail - 1);
+        }
+
+        inline auto& back() const
+        {
+            return _slot(_tail - 1);
+        }
+
+        // Returns false if the buffer was full, with the reject policy
+        // nothing is pushed then, with the overwrite one the front
+        // element is replaced
+        template <typename... Args>
+        inline bool emplace_back(Args&&... args)
+        {
+            if (full())
+            {
+                if constexpr (Policy == ring_policy::reject)
+                {
+                    return false;
+                }
+                else
+                {
+                    // A moved-from buffer has no storage left to overwrite
+                    if (_storage.data() == nullptr)
+                        return false;
+
+                    // `args` may refer to the element that is dropped
+                    T _value{forward<Args>(args)...};
+                    _slot(_head).~T();
+                    _head++;
+                    construct_at(&_slot(_tail), move(_value));
+                    _tail++;
+                    return false;
+                }
+            }
+
+            construct_at(&_slot(_tail), forward<Args>(args)...);
+            _tail++;
+            return true;
+        }
+
+        // Same as emplace_back, but for the other end
+        template <typename... Args>
+        inline bool emplace_front(Args&&... args)
+        {
+            if (full())
+            {
+                if constexpr (Policy == ring_policy::reject)
+                {
+                    return false;
+                }
+                else
+                {
+                    // A moved-from buffer has no storage left to overwrite
+                    if (_storage.data() == nullptr)
+                        return false;
+
+                    T _value{forward<Args>(args)...};
+                    _tail--;
+                    _slot(_tail).~T();
+                    construct_at(&_slot(_head - 1), move(_value));
+                    _head--;
+                    return false;
+                }
+            }
+
+            construct_at(&_slot(_head - 1), forward<Args>(args)...);
+            _head--;
+            return true;
+        }
+
+        inline bool push_back(const T& value)
+        {
+            return emplace_back(value);
+        }
+
+        inline bool push_back(T&& value)
+        {
+            return emplace_back(move(value));
+        }
+
+        inline bool push_front(const T& value)
+        {
+            return emplace_front(value);
+        }
+
+        inline bool push_front(T&& value)
+        {
+            return emplace_front(move(value));
+        }
+
+        inline void pop_front() noexcept
+        {
+            if (!empty())
+            {
+                _slot(_head).~T();
+                _head++;
+            }
+        }
+
+        inline void pop_back() noexcept
+        {
+            if (!empty())
+            {
+                _tail--;
+                _slot(_tail).~T();
+            }
+        }
+
+        inline void clear()
+        {
+            for (; _head != _tail; _head++)
+                _slot(_head).~T();
+
+            _head = _tail = 0;
+        }
+
+        // The elements from front to back, as at most two contiguous
+        // runs (the second one is empty unless the elements wrap)
+        inline auto segments()
+            -> pair< span<T*>, span<T*> >
+        {
+            return _runs(_storage.data(), capacity(), _head, size());
+        }
+
+        inline auto segments() const
+            -> pair< span<const T*>, span<const T*> >
+        {
+            return _runs(_storage.data(), capacity(), _head, size());
+        }
+
+        // The unused slots after the back, meant to be written by
+        // bulk reads and then handed over to the buffer by commit_back
+        inline auto free_segments()
+            -> pair< span<T*>, span<T*> >
+        requires (std::is_trivially_default_constructible_v<T>)
+        {
+            return _runs(_storage.data(), capacity(), _tail, capacity() - size());
+        }
+
+        // Makes the first `count` slots of free_segments elements
+        inline void commit_back(usize count)
+        requires (std::is_trivially_default_constructible_v<T>)
+        {
+            _tail += count < capacity() - size() ? count : capacity() - size();
+        }
+
+        // Drops the first `count` elements, e.g. once they were sent
+        inline void consume_front(usize count)
+        {
+            for (; count != 0 && _head != _tail; count--)
+            {
+                _slot(_head).~T();
+                _head++;
+            }
+        }
+
+        inline usize size() const
+        {
+            return _tail - _head;
+        }
+
+        inline usize capacity() const
+        {
+            return _storage.capacity();
+        }
+
+        inline bool empty() const
+        {
+            return _head == _tail;
+        }
+
+        inline bool full() const
+        {
+            return size() == capacity();
+        }
+
+        inline iterator begin()
+        {
+            return {_storage.data(), _mask(), _head};
+        }
+
+        inline iterator end()
+        {
+            return {_storage.data(), _mask(), _tail};
+        }
+
+        inline const_iterator begin() const
+        {
+            return cbegin();
+        }
+
+        inline const_iterator end() const
+        {
+            return cend();
+        }
+
+        inline const_iterator cbegin() const
+        {
+            return {_storage.data(), _mask(), _head};
+        }
+
+        inline const_iterator cend() const
+        {
+            return {_storage.data(), _mask(), _tail};
+        }
+
+    private:
+        template <typename Ptr>
+        static inline auto _runs(Ptr data, usize capacity, usize pos, usize count)
+            -> pair< span<Ptr>, span<Ptr> >
+        {
+            usize _start = pos & (capacity - 1);
+            usize _first_count = capacity - _start < count ? capacity - _start : count;
+            usize _second_count = count - _first_count;
+
+            return {
+                span<Ptr>{data + _start, data + _start + _first_count, _first_count},
+                span<Ptr>{data, data + _second_count, _second_count}
+            };
+        }
+    };
+
+    template < typename T, ring_policy Policy = ring_policy::reject >
+    using buffered_ring_buffer = ring_buffer< T, ring_detail::dynamic_capacity, Policy, buffered_allocator >;
+} // namespace hsd
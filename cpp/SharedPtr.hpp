@@ -3,6 +3,7 @@
 #include "Utility.hpp"
 #include "_XUtility.hpp"
 #include "Allocator.hpp"
+#include "PoolAllocator.hpp"
 #include "Atomic.hpp"
 
 namespace hsd
@@ -168,11 +169,19 @@ namespace hsd
                 }
             };
 
+            // The counters of pointers on the default allocator come
+            // from the pool of the thread instead of a malloc each
+            template < template <typename> typename Allocator >
+            using counter_allocator = conditional_t<
+                is_same< Allocator<usize>, allocator<usize> >::value,
+                pool_allocator<usize>, Allocator<usize>
+            >;
+
             template < template <typename> typename Allocator >
             class counter
             {
             private:
-                using alloc_type = Allocator<usize>;
+                using alloc_type = counter_allocator<Allocator>;
                 using pointer_type = typename alloc_type::pointer_type;
                 using value_type = typename alloc_type::value_type;
 
@@ -190,14 +199,25 @@ namespace hsd
                     *_data = 1;
                 }
 
-                inline counter(const alloc_type& alloc)
-                requires (std::is_copy_constructible_v<alloc_type>)
+                template <typename Alloc>
+                inline counter(const Alloc& alloc)
+                requires (std::is_constructible_v<alloc_type, const Alloc&>)
                     : _alloc{alloc}
                 {
                     _data = _alloc.allocate(1).unwrap();
                     *_data = 1;
                 }
 
+                // The allocator of the value does not apply to a pooled counter
+                template <typename Alloc>
+                inline counter(const Alloc&)
+                requires (
+                    !std::is_constructible_v<alloc_type, const Alloc&> &&
+                    std::is_default_constructible_v<alloc_type>
+                )
+                    : counter{}
+                {}
+
                 inline counter(usize* ptr)
                 requires (std::is_default_constructible_v<alloc_type>)
                     : _data{ptr}
@@ -663,11 +683,19 @@ namespace hsd
                 }
             };
 
+            // The counters of pointers on the default allocator come
+            // from the pool of the thread instead of a malloc each
+            template < template <typename> typename Allocator >
+            using counter_allocator = conditional_t<
+                is_same< Allocator<atomic_usize>, allocator<atomic_usize> >::value,
+                pool_allocator<atomic_usize>, Allocator<atomic_usize>
+            >;
+
             template < template <typename> typename Allocator >
             class counter
             {
             private:
-                using alloc_type = Allocator<atomic_usize>;
+                using alloc_type = counter_allocator<Allocator>;
                 using pointer_type = typename alloc_type::pointer_type;
                 using value_type = typename alloc_type::value_type;
 
@@ -685,14 +713,25 @@ namespace hsd
                     *_data = 1;
                 }
 
-                inline counter(const alloc_type& alloc)
-                requires (std::is_copy_constructible_v<alloc_type>)
+                template <typename Alloc>
+                inline counter(const Alloc& alloc)
+                requires (std::is_constructible_v<alloc_type, const Alloc&>)
                     : _alloc{alloc}
                 {
                     _data = _alloc.allocate(1).unwrap();
                     *_data = 1;
                 }
 
+                // The allocator of the value does not apply to a pooled counter
+                template <typename Alloc>
+                inline counter(const Alloc&)
+                requires (
+                    !std::is_constructible_v<alloc_type, const Alloc&> &&
+                    std::is_default_constructible_v<alloc_type>
+                )
+                    : counter{}
+                {}
+
                 inline counter(atomic_usize* ptr)
                 requires (std::is_default_constructible_v<alloc_type>)
                     : _data{ptr}
@@ -776,9 +815,9 @@ namespace hsd
             {
                 if (_count.get_pointer() != nullptr)
                 {
-                    (*_count)--;
-
-                    if (*_count == 0)
+                    // The decrement and the check have to be one step, or
+                    // two threads releasing together could both free
+                    if (--(*_count) == 0)
                     {
                         if (get() != nullptr) 
                         {
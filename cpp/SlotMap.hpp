@@ -0,0 +1,272 @@
+#pragma once
+
+#include "Vector.hpp"
+#include "Reference.hpp"
+
+namespace hsd
+{
+    // Handle to an element of a `slot_map`. The generation tells apart
+    // the element the key was made for from any later one in the slot
+    struct slot_key
+    {
+        u32 index = static_cast<u32>(-1);
+        u32 generation = 0;
+
+        constexpr bool operator==(const slot_key& rhs) const
+        {
+            return index == rhs.index && generation == rhs.generation;
+        }
+
+        constexpr bool operator!=(const slot_key& rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+        // For storing the key where a plain integer is expected
+        constexpr u64 to_u64() const
+        {
+            return (static_cast<u64>(generation) << 32) | index;
+        }
+
+        static constexpr slot_key from_u64(u64 value)
+        {
+            return {static_cast<u32>(value), static_cast<u32>(value >> 32)};
+        }
+    };
+
+    namespace slot_map_detail
+    {
+        static constexpr u32 npos = static_cast<u32>(-1);
+
+        struct bad_key
+        {
+            const char* operator()() const
+            {
+                return "Tried to use a key that is stale or not from this map";
+            }
+        };
+
+        // An odd generation marks a slot in use, `index` is then the
+        // position of the value, otherwise it is the next free slot
+        struct slot
+        {
+            u32 index;
+            u32 generation;
+        };
+    } // namespace slot_map_detail
+
+    // Values are packed in a vector and iterate without gaps, the keys
+    // go through a table of slots, so insert, erase and lookup are all
+    // O(1) and a key of an erased element is detected as stale.
+    // Erasing moves the last value in the hole, so pointers and
+    // iterators to the values do not survive an erase, the keys do
+    template < typename T, template <typename> typename Allocator = allocator >
+    class slot_map
+    {
+    private:
+        vector<T, Allocator> _values;
+        vector<u32, Allocator> _value_slots;
+        vector<slot_map_detail::slot, Allocator> _slots;
+        u32 _free_head = slot_map_detail::npos;
+
+        inline bool _is_valid(slot_key key) const
+        {
+            return key.index < _slots.size() &&
+                _slots[key.index].generation == key.generation &&
+                (key.generation & 1) != 0;
+        }
+
+        // Gives a slot to the value that was just added at the back
+        inline slot_key _acquire_slot()
+        {
+            u32 _index = _free_head;
+
+            if (_index != slot_map_detail::npos)
+            {
+                _free_head = _slots[_index].index;
+            }
+            else
+            {
+                _index = static_cast<u32>(_slots.size());
+                _slots.push_back({0, 0});
+            }
+
+            auto& _slot = _slots[_index];
+            _slot.index = static_cast<u32>(_values.size() - 1);
+            _slot.generation++;
+            _value_slots.push_back(_index);
+
+            return {_index, _slot.generation};
+        }
+
+        inline void _release_slot(u32 index)
+        {
+            auto& _slot = _slots[index];
+            _slot.generation++;
+            _slot.index = _free_head;
+            _free_head = index;
+        }
+
+    public:
+        using value_type = T;
+        using key_type = slot_key;
+        using iterator = typename vector<T, Allocator>::iterator;
+        using const_iterator = typename vector<T, Allocator>::const_iterator;
+
+        inline slot_map()
+            requires (std::is_default_constructible_v<Allocator<T>>)
+        {}
+
+        template <typename Alloc>
+        inline slot_map(const Alloc& alloc)
+        requires (std::is_constructible_v<Allocator<T>, Alloc>)
+            : _values{alloc}, _value_slots{alloc}, _slots{alloc}
+        {}
+
+        template <typename... Args>
+        inline slot_key emplace(Args&&... args)
+        {
+            _values.emplace_back(forward<Args>(args)...);
+            return _acquire_slot();
+        }
+
+        inline slot_key insert(const T& value)
+        {
+            return emplace(value);
+        }
+
+        inline slot_key insert(T&& value)
+        {
+            return emplace(move(value));
+        }
+
+        inline auto erase(slot_key key)
+            -> Result<void, slot_map_detail::bad_key>
+        {
+            if (!_is_valid(key))
+                return slot_map_detail::bad_key{};
+
+            u32 _pos = _slots[key.index].index;
+            u32 _last = static_cast<u32>(_values.size() - 1);
+
+            if (_pos != _last)
+            {
+                _values[_pos] = move(_values[_last]);
+                _value_slots[_pos] = _value_slots[_last];
+                _slots[_value_slots[_pos]].index = _pos;
+            }
+
+            _values.pop_back();
+            _value_slots.pop_back();
+            _release_slot(key.index);
+            return {};
+        }
+
+        inline bool contains(slot_key key) const
+        {
+            return _is_valid(key);
+        }
+
+        inline auto get(slot_key key)
+            -> Result< reference<T>, slot_map_detail::bad_key >
+        {
+            if (!_is_valid(key))
+                return slot_map_detail::bad_key{};
+
+            return {_values[_slots[key.index].index]};
+        }
+
+        inline auto get(slot_key key) const
+            -> Result< reference<const T>, slot_map_detail::bad_key >
+        {
+            if (!_is_valid(key))
+                return slot_map_detail::bad_key{};
+
+            return {_values[_slots[key.index].index]};
+        }
+
+        // nullptr for a stale key
+        inline T* find(slot_key key)
+        {
+            return _is_valid(key) ? &_values[_slots[key.index].index] : nullptr;
+        }
+
+        inline const T* find(slot_key key) const
+        {
+            return _is_valid(key) ? &_values[_slots[key.index].index] : nullptr;
+        }
+
+        // Unchecked, the key has to be valid
+        inline T& operator[](slot_key key)
+        {
+            return _values[_slots[key.index].index];
+        }
+
+        inline const T& operator[](slot_key key) const
+        {
+            return _values[_slots[key.index].index];
+        }
+
+        // Key of the value at position `pos` of the packed values
+        inline slot_key key_at(usize pos) const
+        {
+            u32 _index = _value_slots[pos];
+            return {_index, _slots[_index].generation};
+        }
+
+        inline void reserve(usize count)
+        {
+            _values.reserve(count);
+            _value_slots.reserve(count);
+            _slots.reserve(count);
+        }
+
+        // Every key handed out so far becomes stale
+        inline void clear()
+        {
+            for (usize _pos = 0; _pos < _value_slots.size(); _pos++)
+                _release_slot(_value_slots[_pos]);
+
+            _values.clear();
+            _value_slots.clear();
+        }
+
+        inline usize size() const
+        {
+            return _values.size();
+        }
+
+        inline bool empty() const
+        {
+            return _values.size() == 0;
+        }
+
+        inline T* data()
+        {
+            return _values.data();
+        }
+
+        inline iterator begin()
+        {
+            return _values.begin();
+        }
+
+        inline iterator end()
+        {
+            return _values.end();
+        }
+
+        inline const_iterator begin() const
+        {
+            return _values.begin();
+        }
+
+        inline const_iterator end() const
+        {
+            return _values.end();
+        }
+    };
+
+    template <typename T>
+    using buffered_slot_map = slot_map<T, buffered_allocator>;
+} // namespace hsd
@@ -0,0 +1,479 @@
+#pragma once
+
+#include "Vector.hpp"
+#include "Tuple.hpp"
+
+namespace hsd
+{
+    namespace soa_detail
+    {
+        static constexpr usize column_alignment = 64;
+
+        // Unit of allocation, it makes the allocator hand out memory
+        // aligned to a cache line, and so every column starts on one
+        struct alignas(column_alignment) cache_line
+        {
+            uchar bytes[column_alignment];
+        };
+
+        struct bad_access
+        {
+            const char* operator()() const
+            {
+                return "Tried to access an element out of bounds";
+            }
+        };
+
+        template <typename T>
+        static constexpr usize column_lines(usize capacity)
+        {
+            return (capacity * sizeof(T) + column_alignment - 1) / column_alignment;
+        }
+    } // namespace soa_detail
+
+    // Vector of rows of `Ts...`, stored as one contiguous column per
+    // type so a loop over a single field only touches that field.
+    // All the columns share one allocation, each one starting on its
+    // own cache line. Rows are read through a proxy, `v[i].get<0>()`
+    template < template <typename> typename Allocator, typename... Ts >
+    class basic_soa_vector
+    {
+    private:
+        static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one column");
+
+        using alloc_type = Allocator<soa_detail::cache_line>;
+        using columns_type = tuple<Ts*...>;
+
+        alloc_type _alloc;
+        soa_detail::cache_line* _block = nullptr;
+        usize _block_lines = 0;
+        columns_type _columns = {static_cast<Ts*>(nullptr)...};
+        usize _size = 0;
+        usize _capacity = 0;
+
+        template <typename Func>
+        static inline void _for_columns(Func&& func)
+        {
+            [&]<usize... Is>(index_sequence<Is...>)
+            {
+                (func.template operator()<Is>(), ...);
+            }(index_sequence_for<Ts...>{});
+        }
+
+        template <usize I>
+        using column_type = remove_pointer_t<
+            remove_reference_t<decltype(declval<columns_type&>().template get<I>())>
+        >;
+
+        // Moves every column to a new block with room for `new_cap` rows
+        inline void _reallocate(usize new_cap)
+        {
+            usize _lines = (soa_detail::column_lines<Ts>(new_cap) + ...);
+            soa_detail::cache_line* _new_block = _alloc.allocate(_lines).unwrap();
+            soa_detail::cache_line* _line = _new_block;
+
+            _for_columns([&]<usize I>()
+            {
+                using type = column_type<I>;
+                type* _column = bit_cast<type*>(_line);
+                allocator<type> _relocator;
+
+                vector_detail::relocate(_relocator, _column, _columns.template get<I>(), _size);
+                _columns.template get<I>() = _column;
+                _line += soa_detail::column_lines<type>(new_cap);
+            });
+
+            if (_block != nullptr)
+                _alloc.deallocate(_block, _block_lines).unwrap();
+
+            _block = _new_block;
+            _block_lines = _lines;
+            _capacity = new_cap;
+        }
+
+        inline void _grow_for(usize count)
+        {
+            if (count > _capacity)
+            {
+                usize _new_capacity = _capacity ? _capacity : 1;
+
+                while (_new_capacity < count)
+                    _new_capacity += (_new_capacity + 1) / 2;
+
+                _reallocate(_new_capacity);
+            }
+        }
+
+        template <typename Owner, bool Const>
+        class row_ref
+        {
+        private:
+            Owner* _owner;
+            usize _index;
+
+        public:
+            inline row_ref(Owner* owner, usize index)
+                : _owner{owner}, _index{index}
+            {}
+
+            template <usize I>
+            inline auto& get() const
+            {
+                if constexpr (Const)
+                    return static_cast<const column_type<I>&>(_owner->template column_data<I>()[_index]);
+                else
+                    return _owner->template column_data<I>()[_index];
+            }
+
+            // Copies the row out
+            inline operator tuple<Ts...>() const
+            {
+                return [&]<usize... Is>(index_sequence<Is...>)
+                {
+                    return tuple<Ts...>{get<Is>()...};
+                }(index_sequence_for<Ts...>{});
+            }
+
+            inline const row_ref& operator=(const tuple<Ts...>& values) const
+            requires (!Const)
+            {
+                _for_columns([&]<usize I>()
+                {
+                    get<I>() = values.template get<I>();
+                });
+
+                return *this;
+            }
+        };
+
+        template <typename Owner, bool Const>
+        class row_iterator
+        {
+        private:
+            Owner* _owner;
+            usize _index;
+
+        public:
+            inline row_iterator(Owner* owner, usize index)
+                : _owner{owner}, _index{index}
+            {}
+
+            inline bool operator==(const row_iterator& rhs) const
+            {
+                return _index == rhs._index;
+            }
+
+            inline bool operator!=(const row_iterator& rhs) const
+            {
+                return _index != rhs._index;
+            }
+
+            inline row_iterator& operator++()
+            {
+                _index++;
+                return *this;
+            }
+
+            inline row_iterator operator++(i32)
+            {
+                row_iterator _tmp = *this;
+                _index++;
+                return _tmp;
+            }
+
+            inline row_ref<Owner, Const> operator*() const
+            {
+                return {_owner, _index};
+            }
+        };
+
+    public:
+        using value_type = tuple<Ts...>;
+        using reference = row_ref<basic_soa_vector, false>;
+        using const_reference = row_ref<const basic_soa_vector, true>;
+        using iterator = row_iterator<basic_soa_vector, false>;
+        using const_iterator = row_iterator<const basic_soa_vector, true>;
+
+        inline ~basic_soa_vector()
+        {
+            clear();
+
+            if (_block != nullptr)
+                _alloc.deallocate(_block, _block_lines).unwrap();
+        }
+
+        inline basic_soa_vector()
+            requires (std::is_default_constructible_v<alloc_type>) = default;
+
+        template <typename Alloc = alloc_type>
+        inline basic_soa_vector(const Alloc& alloc)
+        requires (std::is_constructible_v<alloc_type, Alloc>)
+            : _alloc(alloc)
+        {}
+
+        inline basic_soa_vector(const basic_soa_vector& other)
+            : _alloc(other._alloc)
+        {
+            reserve(other._size);
+
+            _for_columns([&]<usize I>()
+            {
+                for (usize _index = 0; _index < other._size; _index++)
+                {
+                    allocator<column_type<I>>::construct_at(
+                        &column_data<I>()[_index], other.template column_data<I>()[_index]
+                    );
+                }
+            });
+
+            _size = other._size;
+        }
+
+        inline basic_soa_vector(basic_soa_vector&& other)
+            : _alloc(other._alloc)
+        {
+            swap(_block, other._block);
+            swap(_block_lines, other._block_lines);
+            swap(_columns, other._columns);
+            swap(_size, other._size);
+            swap(_capacity, other._capacity);
+        }
+
+        inline basic_soa_vector& operator=(const basic_soa_vector& rhs)
+        {
+            if (this != &rhs)
+            {
+                basic_soa_vector _copy{rhs};
+                *this = move(_copy);
+            }
+
+            return *this;
+        }
+
+        inline basic_soa_vector& operator=(basic_soa_vector&& rhs)
+        {
+            if (this != &rhs)
+            {
+                // The block goes with the allocator that owns it
+                swap(_alloc, rhs._alloc);
+                swap(_block, rhs._block);
+                swap(_block_lines, rhs._block_lines);
+                swap(_columns, rhs._columns);
+                swap(_size, rhs._size);
+                swap(_capacity, rhs._capacity);
+            }
+
+            return *this;
+        }
+
+        inline reference operator[](usize index)
+        {
+            return {this, index};
+        }
+
+        inline const_reference operator[](usize index) const
+        {
+            return {this, index};
+        }
+
+        inline auto at(usize index)
+            -> Result<reference, soa_detail::bad_access>
+        {
+            if (index >= _size)
+                return soa_detail::bad_access{};
+
+            return reference{this, index};
+        }
+
+        inline auto at(usize index) const
+            -> Result<const_reference, soa_detail::bad_access>
+        {
+            if (index >= _size)
+                return soa_detail::bad_access{};
+
+            return const_reference{this, index};
+        }
+
+        template <usize I>
+        inline auto* column_data()
+        {
+            return _columns.template get<I>();
+        }
+
+        template <usize I>
+        inline const auto* column_data() const
+        {
+            return static_cast<const column_type<I>*>(_columns.template get<I>());
+        }
+
+        template <usize I>
+        inline auto column()
+        {
+            auto* _data = column_data<I>();
+            return span<column_type<I>*>{_data, _data + _size, _size};
+        }
+
+        template <usize I>
+        inline auto column() const
+        {
+            auto* _data = column_data<I>();
+            return span<const column_type<I>*>{_data, _data + _size, _size};
+        }
+
+        // Takes one value for every column
+        template <typename... Args>
+        requires (sizeof...(Args) == sizeof...(Ts))
+        inline reference emplace_back(Args&&... args)
+        {
+            _grow_for(_size + 1);
+
+            [&]<usize... Is>(index_sequence<Is...>)
+            {
+                (allocator<column_type<Is>>::construct_at(
+                    &column_data<Is>()[_size], forward<Args>(args)
+                ), ...);
+            }(index_sequence_for<Ts...>{});
+
+            return {this, _size++};
+        }
+
+        inline void push_back(const tuple<Ts...>& values)
+        {
+            _grow_for(_size + 1);
+
+            _for_columns([&]<usize I>()
+            {
+                allocator<column_type<I>>::construct_at(
+                    &column_data<I>()[_size], values.template get<I>()
+                );
+            });
+
+            _size++;
+        }
+
+        inline void pop_back()
+        {
+            if (_size > 0)
+            {
+                _size--;
+
+                _for_columns([&]<usize I>()
+                {
+                    using type = column_type<I>;
+                    column_data<I>()[_size].~type();
+                });
+            }
+        }
+
+        // Keeps the order of the rows after the erased one
+        inline auto erase(usize index)
+            -> Result<void, soa_detail::bad_access>
+        {
+            if (index >= _size)
+                return soa_detail::bad_access{};
+
+            _for_columns([&]<usize I>()
+            {
+                vector_detail::erase_range(column_data<I>(), _size, index, index + 1);
+            });
+
+            _size--;
+            return {};
+        }
+
+        // Moves the last row into the erased one, O(1) per column
+        inline auto swap_erase(usize index)
+            -> Result<void, soa_detail::bad_access>
+        {
+            if (index >= _size)
+                return soa_detail::bad_access{};
+
+            if (index + 1 != _size)
+            {
+                _for_columns([&]<usize I>()
+                {
+                    column_data<I>()[index] = move(column_data<I>()[_size - 1]);
+                });
+            }
+
+            pop_back();
+            return {};
+        }
+
+        inline void reserve(usize new_cap)
+        {
+            if (new_cap > _capacity)
+                _reallocate(new_cap);
+        }
+
+        inline void resize(usize new_size)
+        {
+            if (new_size > _size)
+            {
+                _grow_for(new_size);
+
+                _for_columns([&]<usize I>()
+                {
+                    for (usize _index = _size; _index < new_size; _index++)
+                        allocator<column_type<I>>::construct_at(&column_data<I>()[_index]);
+                });
+
+                _size = new_size;
+            }
+            else
+            {
+                while (_size > new_size)
+                    pop_back();
+            }
+        }
+
+        inline void clear()
+        {
+            while (_size > 0)
+                pop_back();
+        }
+
+        inline usize size() const
+        {
+            return _size;
+        }
+
+        inline usize capacity() const
+        {
+            return _capacity;
+        }
+
+        inline bool empty() const
+        {
+            return _size == 0;
+        }
+
+        static constexpr usize column_count()
+        {
+            return sizeof...(Ts);
+        }
+
+        inline iterator begin()
+        {
+            return {this, 0};
+        }
+
+        inline iterator end()
+        {
+            return {this, _size};
+        }
+
+        inline const_iterator begin() const
+        {
+            return {this, 0};
+        }
+
+        inline const_iterator end() const
+        {
+            return {this, _size};
+        }
+    };
+
+    template <typename... Ts>
+    using soa_vector = basic_soa_vector<allocator, Ts...>;
+} // namespace hsd
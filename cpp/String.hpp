@@ -211,18 +211,38 @@ namespace hsd
 
         inline bool operator==(const basic_string& rhs) const
         {
-            return _str_utils::compare(
-                _data, rhs._data, 
-                _size < rhs._size ? 
-                _size : rhs._size
+            return _size == rhs._size && _str_utils::compare(
+                _data, rhs._data, _size
+            ) == 0;
+        }
+
+        inline bool operator==(basic_string_view<CharT> rhs) const
+        {
+            return _size == rhs.size() && _str_utils::compare(
+                _data, rhs.data(), _size
             ) == 0;
         }
 
+        inline bool operator==(const CharT* rhs) const
+        {
+            return operator==(basic_string_view<CharT>{rhs});
+        }
+
         inline bool operator!=(const basic_string& rhs) const
         {
             return !operator==(rhs);
         }
 
+        inline bool operator!=(basic_string_view<CharT> rhs) const
+        {
+            return !operator==(rhs);
+        }
+
+        inline bool operator!=(const CharT* rhs) const
+        {
+            return !operator==(rhs);
+        }
+
         inline bool operator<(const basic_string& rhs) const
         {
             return _str_utils::compare(
@@ -707,6 +727,12 @@ namespace hsd
         }
     };
 
+    // The buffer lives on the heap, a string never points into itself
+    template <typename CharT>
+    struct is_trivially_relocatable<basic_string<CharT>>
+        : true_type
+    {};
+
     template <typename T>
     static inline auto to_string(T val)
     {
@@ -872,10 +898,38 @@ namespace hsd
     struct hash<HashType, basic_string<CharT>>
     {
         using ResultType = HashType;
+        using is_transparent = void;
 
         static constexpr ResultType get_hash(const basic_string<CharT>& str) {
             return hash<HashType, const CharT*>::get_hash(str.begin(), str.end());
         }
+
+        static constexpr ResultType get_hash(basic_string_view<CharT> view) {
+            return hash<HashType, const CharT*>::get_hash(view.begin(), view.end());
+        }
+
+        static constexpr ResultType get_hash(const CharT* str) {
+            return hash<HashType, const CharT*>::get_hash(str);
+        }
+    };
+
+    template <typename HashType, typename CharT>
+    struct fast_hash<HashType, basic_string<CharT>>
+    {
+        using ResultType = HashType;
+        using is_transparent = void;
+
+        static constexpr ResultType get_hash(const basic_string<CharT>& str) {
+            return fast_hash<HashType, const CharT*>::get_hash(str.begin(), str.end());
+        }
+
+        static constexpr ResultType get_hash(basic_string_view<CharT> view) {
+            return fast_hash<HashType, const CharT*>::get_hash(view.begin(), view.end());
+        }
+
+        static constexpr ResultType get_hash(const CharT* str) {
+            return fast_hash<HashType, const CharT*>::get_hash(str);
+        }
     };
 
     using string = basic_string<char>;
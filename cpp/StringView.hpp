@@ -376,10 +376,30 @@ namespace hsd
     struct hash<HashType, basic_string_view<CharT>>
     {
         using ResultType = HashType;
+        using is_transparent = void;
 
         static constexpr ResultType get_hash(basic_string_view<CharT> view) {
             return hash<HashType, const CharT*>::get_hash(view.begin(), view.end());
         }
+
+        static constexpr ResultType get_hash(const CharT* str) {
+            return hash<HashType, const CharT*>::get_hash(str);
+        }
+    };
+
+    template <typename HashType, typename CharT>
+    struct fast_hash<HashType, basic_string_view<CharT>>
+    {
+        using ResultType = HashType;
+        using is_transparent = void;
+
+        static constexpr ResultType get_hash(basic_string_view<CharT> view) {
+            return fast_hash<HashType, const CharT*>::get_hash(view.begin(), view.end());
+        }
+
+        static constexpr ResultType get_hash(const CharT* str) {
+            return fast_hash<HashType, const CharT*>::get_hash(str);
+        }
     };
 
     using string_view = basic_string_view<char>;
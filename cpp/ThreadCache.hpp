@@ -0,0 +1,320 @@
+#pragma once
+
+#include "Atomic.hpp"
+#include "Utility.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <new>
+
+namespace hsd
+{
+    // Per thread caches in front of malloc. Small blocks are served from
+    // a magazine per size class, a fixed array of free blocks, that is
+    // refilled from an overflow list, from the blocks other threads gave
+    // back, or carved from a chunk of the thread. Every block remembers
+    // its owning cache, a block freed by another thread goes back to the
+    // owner through a lock-free queue. When a thread exits its cache is
+    // parked with everything it holds and the next new thread adopts it.
+    // These work like malloc, free and realloc, see `tl_cache_allocator`
+    namespace tl_cache_detail
+    {
+        static constexpr usize header_size = 16;
+        static constexpr usize class_count = 20;
+        static constexpr usize max_small = 1024;
+        static constexpr usize magazine_size = 64;
+        static constexpr usize chunk_size = 64 * 1024;
+
+        // 16 byte steps up to 128, then four classes per doubling up to 1 KiB
+        static constexpr usize class_index(usize size)
+        {
+            if (size <= 128)
+                return size == 0 ? 0 : (size - 1) / 16;
+
+            usize _shift = static_cast<usize>(63 - __builtin_clzll(size - 1));
+            return 8 + (_shift - 7) * 4 + ((size - 1) - (1ull << _shift)) / (1ull << (_shift - 2));
+        }
+
+        static constexpr usize class_size(usize index)
+        {
+            if (index < 8)
+                return (index + 1) * 16;
+
+            usize _base = 128ull << ((index - 8) / 4);
+            return _base + ((index - 8) % 4 + 1) * (_base / 4);
+        }
+
+        struct thread_cache;
+
+        // In front of every block. Blocks bigger than the classes come
+        // straight from malloc and have no owner
+        struct alignas(header_size) block_header
+        {
+            thread_cache* owner;
+            usize capacity;
+        };
+
+        static inline void* payload(block_header* header)
+        {
+            return header + 1;
+        }
+
+        static inline block_header* header_of(void* ptr)
+        {
+            return static_cast<block_header*>(ptr) - 1;
+        }
+
+        // Free blocks are linked through their payload
+        static inline block_header*& next_of(block_header* header)
+        {
+            return *static_cast<block_header**>(payload(header));
+        }
+
+        struct magazine
+        {
+            block_header* items[magazine_size];
+            usize count;
+            block_header* overflow;
+        };
+
+        struct thread_cache
+        {
+            magazine magazines[class_count];
+            atomic<block_header*> remote;
+            uchar* bump;
+            uchar* bump_end;
+            void* chunks;
+            thread_cache* next_orphan;
+
+            // Another thread pushes, only the owner takes, and always
+            // everything at once, so the push cannot suffer from ABA
+            inline void push_remote(block_header* header)
+            {
+                block_header* _head = remote.load(memory_order_relaxed);
+
+                do
+                {
+                    next_of(header) = _head;
+                } while (!remote.compare_exchange_weak(
+                    _head, header, memory_order_release, memory_order_relaxed));
+            }
+
+            inline void push_local(block_header* header)
+            {
+                auto& _magazine = magazines[class_index(header->capacity)];
+
+                // A full magazine spills half of itself to the overflow list
+                if (_magazine.count == magazine_size)
+                {
+                    for (; _magazine.count > magazine_size / 2; _magazine.count--)
+                    {
+                        auto* _spilled = _magazine.items[_magazine.count - 1];
+                        next_of(_spilled) = _magazine.overflow;
+                        _magazine.overflow = _spilled;
+                    }
+                }
+
+                _magazine.items[_magazine.count++] = header;
+            }
+
+            inline void drain_remote()
+            {
+                auto* _header = remote.exchange(nullptr, memory_order_acquire);
+
+                while (_header != nullptr)
+                    push_local(exchange(_header, next_of(_header)));
+            }
+
+            inline bool carve(usize index)
+            {
+                usize _size = header_size + class_size(index);
+
+                if (static_cast<usize>(bump_end - bump) < _size)
+                {
+                    auto* _chunk = static_cast<uchar*>(malloc(chunk_size));
+
+                    if (_chunk == nullptr)
+                        return false;
+
+                    *static_cast<void**>(static_cast<void*>(_chunk)) = chunks;
+                    chunks = _chunk;
+                    bump = _chunk + header_size;
+                    bump_end = _chunk + chunk_size;
+                }
+
+                auto& _magazine = magazines[index];
+
+                for (; _magazine.count < magazine_size / 2 &&
+                    static_cast<usize>(bump_end - bump) >= _size; bump += _size)
+                {
+                    auto* _header = new (bump) block_header{this, class_size(index)};
+                    _magazine.items[_magazine.count++] = _header;
+                }
+
+                return true;
+            }
+
+            // Overflow first, then what other threads gave back, then new memory
+            inline bool refill(usize index)
+            {
+                auto& _magazine = magazines[index];
+
+                if (_magazine.overflow == nullptr)
+                    drain_remote();
+
+                if (_magazine.count != 0)
+                    return true;
+
+                for (; _magazine.overflow != nullptr && _magazine.count < magazine_size / 2;)
+                    _magazine.items[_magazine.count++] = exchange(_magazine.overflow, next_of(_magazine.overflow));
+
+                return _magazine.count != 0 || carve(index);
+            }
+        };
+
+        // Caches of exited threads, waiting for a new thread
+        inline constinit atomic_flag orphans_lock{};
+        inline constinit thread_cache* orphans = nullptr;
+
+        inline thread_local constinit thread_cache* current = nullptr;
+        inline thread_local constinit bool closed = false;
+
+        // Its destructor parks the cache of the thread. It is only
+        // touched when the thread first gets a cache
+        struct thread_flusher
+        {
+            bool armed = false;
+
+            inline ~thread_flusher()
+            {
+                if (!armed)
+                    return;
+
+                thread_cache* _cache = exchange(current, nullptr);
+                closed = true;
+                _cache->drain_remote();
+
+                while (orphans_lock.test_and_set(memory_order_acquire))
+                    ;
+
+                _cache->next_orphan = orphans;
+                orphans = _cache;
+                orphans_lock.clear(memory_order_release);
+            }
+        };
+
+        inline thread_local thread_flusher flusher{};
+
+        // nullptr once the thread has been flushed, everything then
+        // goes to malloc
+        static inline thread_cache* acquire_cache()
+        {
+            if (closed)
+                return nullptr;
+
+            while (orphans_lock.test_and_set(memory_order_acquire))
+                ;
+
+            thread_cache* _cache = orphans;
+
+            if (_cache != nullptr)
+                orphans = _cache->next_orphan;
+
+            orphans_lock.clear(memory_order_release);
+
+            if (_cache == nullptr)
+            {
+                void* _memory = malloc(sizeof(thread_cache));
+
+                if (_memory == nullptr)
+                    return nullptr;
+
+                _cache = new (_memory) thread_cache{};
+            }
+
+            flusher.armed = true;
+            current = _cache;
+            return _cache;
+        }
+
+        static inline void* allocate_large(usize size)
+        {
+            if (size > static_cast<usize>(-1) - header_size)
+                return nullptr;
+
+            void* _memory = malloc(header_size + size);
+
+            if (_memory == nullptr)
+                return nullptr;
+
+            return payload(new (_memory) block_header{nullptr, size});
+        }
+
+        static inline void* allocate(usize size)
+        {
+            if (size > max_small)
+                return allocate_large(size);
+
+            thread_cache* _cache = current;
+
+            if (_cache == nullptr && (_cache = acquire_cache()) == nullptr)
+                return allocate_large(size);
+
+            usize _index = class_index(size);
+            auto& _magazine = _cache->magazines[_index];
+
+            if (_magazine.count == 0 && !_cache->refill(_index))
+                return nullptr;
+
+            return payload(_magazine.items[--_magazine.count]);
+        }
+
+        static inline void deallocate(void* ptr)
+        {
+            if (ptr == nullptr)
+                return;
+
+            block_header* _header = header_of(ptr);
+
+            if (_header->owner == nullptr)
+                free(_header);
+            else if (_header->owner == current)
+                _header->owner->push_local(_header);
+            else
+                _header->owner->push_remote(_header);
+        }
+
+        // A small block is kept while it is big enough
+        static inline void* reallocate(void* ptr, usize size)
+        {
+            if (ptr == nullptr)
+                return allocate(size);
+
+            block_header* _header = header_of(ptr);
+
+            if (_header->owner == nullptr && size > max_small)
+            {
+                void* _memory = realloc(_header, header_size + size);
+
+                if (_memory == nullptr)
+                    return nullptr;
+
+                return payload(new (_memory) block_header{nullptr, size});
+            }
+
+            if (_header->owner != nullptr && size <= _header->capacity)
+                return ptr;
+
+            void* _result = allocate(size);
+
+            if (_result != nullptr)
+            {
+                memcpy(_result, ptr, _header->capacity < size ? _header->capacity : size);
+                deallocate(ptr);
+            }
+
+            return _result;
+        }
+    } // namespace tl_cache_detail
+} // namespace hsd
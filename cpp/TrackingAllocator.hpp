@@ -0,0 +1,560 @@
+#pragma once
+
+#include "Allocator.hpp"
+#include "Atomic.hpp"
+#include "Logging.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace hsd
+{
+    namespace tracking_detail
+    {
+        static constexpr usize max_tags = 256;
+
+        // Up to 16 bytes, up to 32 bytes, ... up to 32 KiB and above
+        static constexpr usize histogram_size = 13;
+
+        static inline usize bucket_of(usize bytes)
+        {
+            if (bytes <= 16)
+                return 0;
+
+            usize _bucket = static_cast<usize>(64 - __builtin_clzll(bytes - 1)) - 4;
+            return _bucket < histogram_size ? _bucket : histogram_size - 1;
+        }
+
+        static constexpr usize bucket_bound(usize bucket)
+        {
+            return static_cast<usize>(16) << bucket;
+        }
+
+        struct tag_info
+        {
+            const char* name;
+            logger_detail::source_location location;
+            bool by_site;
+        };
+
+        // The counters of allocators that were not given a tag
+        inline constinit tag_info untagged{"untagged", {"", "", 0, 0}, false};
+
+        // Only published entries below `tag_count` are read, so the
+        // report does not take the lock
+        inline constinit atomic_flag tags_lock{};
+        inline constinit tag_info* tags[max_tags] = {&untagged};
+        inline constinit atomic_usize tag_count = 1;
+
+        // Counters of one tag on one thread. The thread owning them is
+        // the only writer, so they are updated with plain loads and
+        // stores and stay readable by a report at any time. Memory freed
+        // by another thread than the one that allocated it shows up as a
+        // negative current on the freeing thread, the merge evens it out
+        struct thread_stats
+        {
+            atomic<i64> current;
+            atomic<i64> peak;
+            atomic_u64 total_bytes;
+            atomic_u64 allocations;
+            atomic_u64 deallocations;
+            atomic_u64 histogram[histogram_size];
+        };
+
+        // The counters of every tag for one thread. Blocks are never
+        // freed, a block of an exited thread is taken over by the next
+        // new thread and keeps adding to the same numbers
+        struct thread_block
+        {
+            atomic<thread_stats*> stats[max_tags];
+            atomic_bool in_use;
+            thread_block* next;
+        };
+
+        // Written by every thread that has already been flushed, with
+        // atomic read-modify-writes since there are many writers
+        inline constinit thread_block exited_threads{{}, true, nullptr};
+        inline constinit atomic<thread_block*> blocks = &exited_threads;
+
+        inline thread_local constinit thread_block* current_block = nullptr;
+        inline thread_local constinit bool closed = false;
+
+        static inline void lock_tags()
+        {
+            while (tags_lock.test_and_set(memory_order_acquire))
+                ;
+        }
+
+        static inline void unlock_tags()
+        {
+            tags_lock.clear(memory_order_release);
+        }
+
+        // Copies the name, so it can come from a temporary string.
+        // Past `max_tags` everything goes to the untagged counters
+        static inline usize add_tag(const char* name, logger_detail::source_location loc, bool by_site)
+        {
+            usize _index = tag_count.load(memory_order_relaxed);
+
+            if (_index == max_tags)
+                return 0;
+
+            usize _length = strlen(name);
+            auto* _name = static_cast<char*>(malloc(_length + 1));
+            auto* _info = static_cast<tag_info*>(malloc(sizeof(tag_info)));
+
+            if (_name == nullptr || _info == nullptr)
+            {
+                free(_name);
+                free(_info);
+                return 0;
+            }
+
+            memcpy(_name, name, _length + 1);
+            tags[_index] = new (_info) tag_info{_name, loc, by_site};
+            tag_count.store(_index + 1, memory_order_release);
+            return _index;
+        }
+
+        // Gives the block back when the thread exits
+        struct block_releaser
+        {
+            bool armed = false;
+
+            inline ~block_releaser()
+            {
+                if (!armed)
+                    return;
+
+                closed = true;
+                exchange(current_block, nullptr)->in_use.store(false, memory_order_release);
+            }
+        };
+
+        inline thread_local block_releaser releaser{};
+
+        static inline thread_block* acquire_block()
+        {
+            if (closed)
+                return &exited_threads;
+
+            thread_block* _block = blocks.load(memory_order_acquire);
+
+            for (; _block != nullptr; _block = _block->next)
+            {
+                bool _free = false;
+
+                if (_block->in_use.compare_exchange_strong(
+                    _free, true, memory_order_acquire, memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+
+            if (_block == nullptr)
+            {
+                void* _memory = malloc(sizeof(thread_block));
+
+                if (_memory == nullptr)
+                    return &exited_threads;
+
+                _block = new (_memory) thread_block{};
+                _block->in_use.store(true, memory_order_relaxed);
+                _block->next = blocks.load(memory_order_relaxed);
+
+                while (!blocks.compare_exchange_weak(
+                    _block->next, _block, memory_order_release, memory_order_relaxed))
+                {}
+            }
+
+            releaser.armed = true;
+            current_block = _block;
+            return _block;
+        }
+
+        static inline thread_stats* stats_of(thread_block* block, usize tag)
+        {
+            thread_stats* _stats = block->stats[tag].load(memory_order_acquire);
+
+            if (_stats != nullptr)
+                return _stats;
+
+            void* _memory = malloc(sizeof(thread_stats));
+
+            if (_memory == nullptr)
+                return nullptr;
+
+            auto* _fresh = new (_memory) thread_stats{};
+
+            if (!block->stats[tag].compare_exchange_strong(
+                _stats, _fresh, memory_order_acq_rel, memory_order_acquire))
+            {
+                free(_fresh);
+                return _stats;
+            }
+
+            return _fresh;
+        }
+
+        template <typename U>
+        static inline void add(atomic<U>& counter, U value, bool shared)
+        {
+            if (shared)
+                counter.fetch_add(value, memory_order_relaxed);
+            else
+                counter.store(counter.load(memory_order_relaxed) + value, memory_order_relaxed);
+        }
+
+        static inline void record(usize tag, i64 bytes, bool is_free)
+        {
+            thread_block* _block = current_block;
+
+            if (_block == nullptr)
+                _block = acquire_block();
+
+            thread_stats* _stats = stats_of(_block, tag);
+
+            if (_stats == nullptr)
+                return;
+
+            bool _shared = _block == &exited_threads;
+
+            if (is_free)
+            {
+                add<i64>(_stats->current, -bytes, _shared);
+                add<u64>(_stats->deallocations, 1, _shared);
+                return;
+            }
+
+            add<i64>(_stats->current, bytes, _shared);
+            add<u64>(_stats->total_bytes, static_cast<u64>(bytes), _shared);
+            add<u64>(_stats->allocations, 1, _shared);
+            add<u64>(_stats->histogram[bucket_of(static_cast<usize>(bytes))], 1, _shared);
+
+            i64 _current = _stats->current.load(memory_order_relaxed);
+            i64 _peak = _stats->peak.load(memory_order_relaxed);
+
+            if (!_shared)
+            {
+                if (_current > _peak)
+                    _stats->peak.store(_current, memory_order_relaxed);
+
+                return;
+            }
+
+            while (_current > _peak && !_stats->peak.compare_exchange_weak(
+                _peak, _current, memory_order_relaxed, memory_order_relaxed))
+            {}
+        }
+
+        static inline void write_json_string(FILE* out, const char* str)
+        {
+            putc('"', out);
+
+            for (; *str != '\0'; str++)
+            {
+                if (*str == '"' || *str == '\\')
+                    fprintf(out, "\\%c", *str);
+                else if (static_cast<uchar>(*str) < 0x20)
+                    fprintf(out, "\\u%04x", static_cast<u32>(static_cast<uchar>(*str)));
+                else
+                    putc(*str, out);
+            }
+
+            putc('"', out);
+        }
+    } // namespace tracking_detail
+
+    // The numbers of one tag, summed over every thread. `peak_bytes` is
+    // exact for a tag used by one thread, with more threads it is the
+    // largest of the peaks of each thread and of the current total
+    struct alloc_stats
+    {
+        i64 current_bytes = 0;
+        i64 peak_bytes = 0;
+        u64 total_bytes = 0;
+        u64 allocations = 0;
+        u64 deallocations = 0;
+        u64 histogram[tracking_detail::histogram_size] = {};
+    };
+
+    // Handle to a set of counters. A tag is made once, better at static
+    // scope, and its name and the place it was made are kept for the
+    // report. Copies refer to the same counters
+    class alloc_tag
+    {
+    private:
+        usize _index = 0;
+
+        friend class tracking_report;
+
+        constexpr alloc_tag(usize index)
+            : _index{index}
+        {}
+
+    public:
+        // The counters of allocators that were not given a tag
+        constexpr alloc_tag() = default;
+
+        inline alloc_tag(const char* name, logger_detail::source_location loc = {})
+        {
+            tracking_detail::lock_tags();
+            _index = tracking_detail::add_tag(name, loc, false);
+            tracking_detail::unlock_tags();
+        }
+
+        // The tag of the place this is called from, the same place
+        // always gives back the same tag
+        static inline alloc_tag here(logger_detail::source_location loc = {})
+        {
+            using namespace tracking_detail;
+            lock_tags();
+
+            usize _count = tag_count.load(memory_order_relaxed);
+            usize _index = 0;
+
+            for (; _index < _count; _index++)
+            {
+                if (tags[_index]->by_site && tags[_index]->location.line() == loc.line() &&
+                    strcmp(tags[_index]->location.file_name(), loc.file_name()) == 0)
+                {
+                    break;
+                }
+            }
+
+            if (_index == _count)
+                _index = add_tag(loc.function_name(), loc, true);
+
+            unlock_tags();
+            return {_index};
+        }
+
+        inline usize index() const
+        {
+            return _index;
+        }
+
+        inline const char* name() const
+        {
+            return tracking_detail::tags[_index]->name;
+        }
+
+        inline const logger_detail::source_location& location() const
+        {
+            return tracking_detail::tags[_index]->location;
+        }
+
+        // Merges the counters of every thread
+        inline alloc_stats stats() const
+        {
+            using namespace tracking_detail;
+            alloc_stats _result;
+
+            for (auto* _block = blocks.load(memory_order_acquire); _block != nullptr; _block = _block->next)
+            {
+                thread_stats* _stats = _block->stats[_index].load(memory_order_acquire);
+
+                if (_stats == nullptr)
+                    continue;
+
+                i64 _peak = _stats->peak.load(memory_order_relaxed);
+                _result.current_bytes += _stats->current.load(memory_order_relaxed);
+                _result.total_bytes += _stats->total_bytes.load(memory_order_relaxed);
+                _result.allocations += _stats->allocations.load(memory_order_relaxed);
+                _result.deallocations += _stats->deallocations.load(memory_order_relaxed);
+
+                if (_peak > _result.peak_bytes)
+                    _result.peak_bytes = _peak;
+
+                for (usize _bucket = 0; _bucket < histogram_size; _bucket++)
+                    _result.histogram[_bucket] += _stats->histogram[_bucket].load(memory_order_relaxed);
+            }
+
+            if (_result.current_bytes > _result.peak_bytes)
+                _result.peak_bytes = _result.current_bytes;
+
+            return _result;
+        }
+    };
+
+    // Prints the merged counters of every tag that has been used
+    class tracking_report
+    {
+    public:
+        static inline void write_text(FILE* out = stdout)
+        {
+            using namespace tracking_detail;
+            usize _count = tag_count.load(memory_order_acquire);
+
+            for (usize _index = 0; _index < _count; _index++)
+            {
+                alloc_tag _tag{_index};
+                alloc_stats _stats = _tag.stats();
+
+                if (_stats.allocations == 0 && _stats.deallocations == 0)
+                    continue;
+
+                fprintf(out, "%s", _tag.name());
+
+                if (_tag.location().line() != 0)
+                    fprintf(out, " (%s:%d)", _tag.location().file_name(), _tag.location().line());
+
+                fprintf(
+                    out, "\n\tcurrent: %lld B, peak: %lld B, total: %llu B, "
+                    "allocations: %llu, deallocations: %llu\n\tsizes:",
+                    _stats.current_bytes, _stats.peak_bytes, _stats.total_bytes,
+                    _stats.allocations, _stats.deallocations
+                );
+
+                for (usize _bucket = 0; _bucket < histogram_size; _bucket++)
+                {
+                    if (_stats.histogram[_bucket] == 0)
+                        continue;
+
+                    if (_bucket + 1 < histogram_size)
+                        fprintf(out, " <=%zu: %llu", bucket_bound(_bucket), _stats.histogram[_bucket]);
+                    else
+                        fprintf(out, " >%zu: %llu", bucket_bound(_bucket - 1), _stats.histogram[_bucket]);
+                }
+
+                putc('\n', out);
+            }
+        }
+
+        static inline void write_json(FILE* out = stdout)
+        {
+            using namespace tracking_detail;
+            usize _count = tag_count.load(memory_order_acquire);
+            bool _first = true;
+
+            fprintf(out, "{\"tags\": [");
+
+            for (usize _index = 0; _index < _count; _index++)
+            {
+                alloc_tag _tag{_index};
+                alloc_stats _stats = _tag.stats();
+
+                if (_stats.allocations == 0 && _stats.deallocations == 0)
+                    continue;
+
+                fprintf(out, _first ? "\n" : ",\n");
+                _first = false;
+
+                fprintf(out, "    {\"name\": ");
+                write_json_string(out, _tag.name());
+                fprintf(out, ", \"file\": ");
+                write_json_string(out, _tag.location().file_name());
+
+                fprintf(
+                    out, ", \"line\": %d, \"current\": %lld, \"peak\": %lld, \"total\": %llu, "
+                    "\"allocations\": %llu, \"deallocations\": %llu, \"histogram\": [",
+                    _tag.location().line(), _stats.current_bytes, _stats.peak_bytes,
+                    _stats.total_bytes, _stats.allocations, _stats.deallocations
+                );
+
+                for (usize _bucket = 0; _bucket < histogram_size; _bucket++)
+                    fprintf(out, _bucket == 0 ? "%llu" : ", %llu", _stats.histogram[_bucket]);
+
+                fprintf(out, "]}");
+            }
+
+            fprintf(out, _first ? "]}\n" : "\n]}\n");
+        }
+    };
+
+    // Wraps `Inner` and counts what goes through it under a tag. The
+    // default tag is the untagged one, use `here()` to tag by the place
+    // the allocator is made. The sizes are the ones given to `allocate`
+    // and `deallocate`, in bytes
+    template < typename T, template <typename> typename Inner = allocator >
+    class tracking_allocator
+    {
+    private:
+        Inner<T> _inner;
+        alloc_tag _tag;
+
+        template <typename U, template <typename> typename Alloc>
+        friend class tracking_allocator;
+
+    public:
+        using pointer_type = T*;
+        using value_type = T;
+
+        inline tracking_allocator()
+        requires (std::is_default_constructible_v<Inner<T>>) = default;
+
+        inline tracking_allocator(alloc_tag tag)
+        requires (std::is_default_constructible_v<Inner<T>>)
+            : _tag{tag}
+        {}
+
+        inline tracking_allocator(alloc_tag tag, const Inner<T>& inner)
+            : _inner{inner}, _tag{tag}
+        {}
+
+        template <typename U>
+        inline tracking_allocator(const tracking_allocator<U, Inner>& other)
+            : _inner{other._inner}, _tag{other._tag}
+        {}
+
+        template <typename U>
+        inline tracking_allocator& operator=(const tracking_allocator<U, Inner>& rhs)
+        {
+            _inner = rhs._inner;
+            _tag = rhs._tag;
+            return *this;
+        }
+
+        // Tags the allocator with the place this is called from
+        static inline tracking_allocator here(logger_detail::source_location loc = {})
+        requires (std::is_default_constructible_v<Inner<T>>)
+        {
+            return {alloc_tag::here(loc)};
+        }
+
+        inline alloc_tag tag() const
+        {
+            return _tag;
+        }
+
+        [[nodiscard]] inline auto allocate(usize size)
+        {
+            auto _result = _inner.allocate(size);
+
+            if (_result)
+                tracking_detail::record(_tag.index(), static_cast<i64>(size * sizeof(T)), false);
+
+            return _result;
+        }
+
+        inline auto deallocate(pointer_type ptr, usize size)
+        {
+            if (ptr != nullptr)
+                tracking_detail::record(_tag.index(), static_cast<i64>(size * sizeof(T)), true);
+
+            return _inner.deallocate(ptr, size);
+        }
+
+        [[nodiscard]] inline auto reallocate(pointer_type ptr, usize old_size, usize new_size)
+        requires requires (Inner<T>& inner) { inner.reallocate(ptr, old_size, new_size); }
+        {
+            auto _result = _inner.reallocate(ptr, old_size, new_size);
+
+            if (_result)
+            {
+                if (ptr != nullptr)
+                    tracking_detail::record(_tag.index(), static_cast<i64>(old_size * sizeof(T)), true);
+
+                tracking_detail::record(_tag.index(), static_cast<i64>(new_size * sizeof(T)), false);
+            }
+
+            return _result;
+        }
+
+        template <typename... Args>
+        static inline void construct_at(T* ptr, Args&&... args)
+        {
+            new (ptr) T{forward<Args>(args)...};
+        }
+    };
+} // namespace hsd
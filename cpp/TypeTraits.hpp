@@ -779,6 +779,15 @@ namespace hsd
         >::type;
     };
 
+    // Types whose objects can be moved to another address by copying
+    // their bytes, without calling the move constructor and destructor.
+    // Trivially copyable types are detected, other types that don't
+    // point into themselves can opt in by specializing this template
+    template <typename T>
+    struct is_trivially_relocatable
+        : literal_constant< bool, std::is_trivially_copyable_v<T> >
+    {};
+
     template <typename T>
     auto declval() -> decltype(sfinae::declval<T>(0));
 
@@ -232,6 +232,12 @@ namespace hsd
         }
     };
 
+    // Only owns a pointer, so it can be relocated if its allocator can
+    template < typename T, template <typename> typename Allocator >
+    struct is_trivially_relocatable<unique_ptr<T, Allocator>>
+        : is_trivially_relocatable<Allocator<remove_array_t<T>>>
+    {};
+
     template < typename T, template <typename> typename Allocator >
     struct MakeUniq
     {
@@ -4,6 +4,8 @@
 #include "Pair.hpp"
 #include "Vector.hpp"
 #include "Hash.hpp"
+#include "CString.hpp"
+#include "StackArray.hpp"
 #include "Concepts.hpp"
 
 namespace hsd
@@ -30,6 +32,86 @@ namespace hsd
                 return "Tried to access an element out of bounds";
             }
         };
+
+        class static_map_error
+        {
+        private:
+            const char* _err = nullptr;
+
+        public:
+            constexpr static_map_error(const char* error)
+                : _err{error}
+            {}
+
+            const char* operator()() const
+            {
+                return _err;
+            }
+        };
+
+        static constexpr usize default_bucket_count = 16;
+
+        static constexpr usize next_pow2(usize value)
+        {
+            usize _result = 1;
+
+            while (_result < value)
+                _result <<= 1;
+
+            return _result;
+        }
+
+        // Fibonacci hashing: the multiplication spreads the low
+        // bits of the hash over the whole word, then the high half
+        // is folded back so a mask can pick the bucket (no division)
+        static constexpr usize bucket_index(u64 hash, usize bucket_count)
+        {
+            hash *= 0x9e37'79b9'7f4a'7c15ull;
+            return static_cast<usize>(hash ^ (hash >> 32)) & (bucket_count - 1);
+        }
+
+        template <typename T>
+        concept CharPointer = is_pointer<T>::value && 
+            std::is_integral_v<remove_pointer_t<T>>;
+
+        // Hashers that declare `is_transparent` give the same hash
+        // for every type they accept (e.g. a string, its view and a C
+        // string), so lookups can skip building a temporary key
+        template <typename Hasher>
+        concept Transparent = requires { typename Hasher::is_transparent; };
+
+        template <typename Hasher, typename Key, typename U>
+        concept DirectLookup = IsSame<remove_cvref_t<U>, Key> || Transparent<Hasher>;
+
+        // C strings are compared by their contents, not their address
+        template <typename Lhs, typename Rhs>
+        static constexpr bool key_equal(const Lhs& lhs, const Rhs& rhs)
+        {
+            if constexpr (CharPointer<decay_t<Lhs>> && CharPointer<decay_t<Rhs>>)
+            {
+                using char_type = remove_cv_t<remove_pointer_t<decay_t<Lhs>>>;
+                return basic_cstring<char_type>::compare(lhs, rhs) == 0;
+            }
+            else
+            {
+                return lhs == rhs;
+            }
+        }
+
+        // Maps `hash` uniformly onto [0, range) without a division
+        static constexpr usize reduce(u64 hash, usize range)
+        {
+            #if defined(HSD_COMPILER_GCC)
+            return static_cast<usize>((static_cast<u128>(hash) * range) >> 64);
+            #else
+            return static_cast<usize>(hash % range);
+            #endif
+        }
+
+        static constexpr u64 seeded_mix(u64 hash, u64 seed)
+        {
+            return hash_detail::int_hash(hash ^ (seed * 0x9e37'79b9'7f4a'7c15ull));
+        }
     } // namespace umap_detail
 
     template< typename Key, typename T, typename Hasher = hash<usize, Key>, 
@@ -38,54 +120,119 @@ namespace hsd
     class unordered_map
     {
     private:
-        using ref_value = pair< typename Hasher::ResultType, usize >;
+        using hash_type = typename Hasher::ResultType;
+        using ref_value = pair< hash_type, usize >;
         using ref_vector = vector< ref_value, BucketAllocator >;
-        using bucket_iter = typename ref_vector::iterator;
 
-        static constexpr f64 _limit_ratio = 0.75f;
+        f32 _max_load_factor = 0.75f;
         vector< ref_vector, BucketAllocator > _buckets;
         vector< pair<Key, T>, Allocator > _data;
 
+        // `new_size` must be a power of two
         inline void _replace(usize new_size)
         {
-            _buckets.clear();
+            // Keep the old buckets' storage around for reuse
+            for (auto& _bucket : _buckets)
+                _bucket.clear();
+
             _buckets.resize(new_size);
 
             for (usize _index = 0; _index < _data.size(); _index++)
             {
                 auto _hash_rez = Hasher::get_hash(_data[_index].first);
-                usize _bucket_index = _hash_rez % new_size;
+                usize _bucket_index = umap_detail::bucket_index(_hash_rez, new_size);
                 _buckets[_bucket_index].emplace_back(_hash_rez, _index);
             }
         }
 
-        inline pair<usize, usize> _get(const Key& key) const
+        inline usize _min_bucket_count(usize size) const
         {
-            auto _key_hash = Hasher::get_hash(key);
-            usize _index = _key_hash % _buckets.size();
+            return static_cast<usize>(
+                static_cast<f32>(size) / _max_load_factor
+            ) + 1;
+        }
+
+        template <typename U>
+        inline usize _find(const U& key, hash_type key_hash) const
+        {
+            usize _index = umap_detail::bucket_index(key_hash, _buckets.size());
 
             for (auto& _val : _buckets[_index])
             {
-                if (_key_hash == _val.first)
-                    return {_val.second, _index};
+                if (_val.first == key_hash && 
+                    umap_detail::key_equal(_data[_val.second].first, key))
+                {
+                    return _val.second;
+                }
             }
 
-            return {static_cast<usize>(-1), _index};
+            return static_cast<usize>(-1);
+        }
+
+        template <typename U>
+        inline usize _get(const U& key) const
+        {
+            if constexpr (umap_detail::DirectLookup<Hasher, Key, U>)
+            {
+                return _find(key, Hasher::get_hash(key));
+            }
+            else
+            {
+                Key _key = Key(key);
+                return _find(_key, Hasher::get_hash(_key));
+            }
         }
 
-        inline auto _get_iter(const Key& key)
-            -> Result< pair<bucket_iter, usize>, umap_detail::bad_access >
+        template <typename... Args>
+        inline void _insert(hash_type key_hash, Key&& key, Args&&... args)
         {
-            auto _key_hash = Hasher::get_hash(key);
-            usize _index = _key_hash % _buckets.size();
+            _data.emplace_back(move(key), T{forward<Args>(args)...});
 
-            for (auto _val = _buckets[_index].begin(); _val != _buckets[_index].end(); _val++)
+            if (static_cast<f32>(_data.size()) > 
+                static_cast<f32>(_buckets.size()) * _max_load_factor)
             {
-                if (_key_hash == _val->first)
-                    return pair{_val, _index};
+                _replace(_buckets.size() * 2);
             }
+            else
+            {
+                _buckets[umap_detail::bucket_index(key_hash, _buckets.size())]
+                    .emplace_back(key_hash, _data.size() - 1);
+            }
+        }
+
+        // Removes the bucket entry that refers to `data_index`
+        inline void _unlink(usize data_index)
+        {
+            auto& _bucket = _buckets[umap_detail::bucket_index(
+                Hasher::get_hash(_data[data_index].first), _buckets.size()
+            )];
 
-            return umap_detail::bad_access{};
+            for (auto& _val : _bucket)
+            {
+                if (_val.second == data_index)
+                {
+                    _val = move(_bucket.back());
+                    _bucket.pop_back();
+                    return;
+                }
+            }
+        }
+
+        // Points the bucket entry of `from_index` to `to_index`
+        inline void _relink(usize from_index, usize to_index)
+        {
+            auto& _bucket = _buckets[umap_detail::bucket_index(
+                Hasher::get_hash(_data[from_index].first), _buckets.size()
+            )];
+
+            for (auto& _val : _bucket)
+            {
+                if (_val.second == from_index)
+                {
+                    _val.second = to_index;
+                    return;
+                }
+            }
         }
 
     public:
@@ -98,7 +245,7 @@ namespace hsd
         inline unordered_map()
         requires (umap_detail::DefaultAlloc<Allocator> &&
             umap_detail::DefaultAlloc<BucketAllocator>)
-            : _buckets(10)
+            : _buckets(umap_detail::default_bucket_count)
         {}
 
         template <typename U = uchar>
@@ -108,7 +255,7 @@ namespace hsd
             umap_detail::CopyAlloc<Allocator>) && 
             IsSame<Allocator<U>, BucketAllocator<U>>
         )
-            : _buckets(10, alloc), _data(alloc)
+            : _buckets(umap_detail::default_bucket_count, alloc), _data(alloc)
         {}
 
         template <typename U = uchar>
@@ -119,7 +266,7 @@ namespace hsd
             (umap_detail::DefaultAlloc<Allocator> &&
             !IsSame<Allocator<U>, BucketAllocator<U>>)
         )
-            : _buckets(10, alloc)
+            : _buckets(umap_detail::default_bucket_count, alloc)
         {}
 
         template <typename U = uchar>
@@ -130,7 +277,7 @@ namespace hsd
             (umap_detail::DefaultAlloc<BucketAllocator> &&
             IsSame<Allocator<U>, BucketAllocator<U>>)
         )
-            : _buckets(10), _data(alloc)
+            : _buckets(umap_detail::default_bucket_count), _data(alloc)
         {}
 
         template <typename U1 = uchar, typename U2 = uchar>
@@ -144,29 +291,33 @@ namespace hsd
             umap_detail::DefaultAlloc<BucketAllocator>) &&
             !IsSame<Allocator<U1>, BucketAllocator<U1>>
         )
-            : _buckets(10, bucket_alloc), _data(data_alloc)
+            : _buckets(umap_detail::default_bucket_count, bucket_alloc), _data(data_alloc)
         {}
 
         inline unordered_map(const unordered_map& other)
-            : _buckets{other._buckets.size()}, _data{other._data}
+            : _max_load_factor{other._max_load_factor},
+            _buckets{other._buckets.size()}, _data{other._data}
         {
-            for (auto& _val : _data)
+            for (usize _index = 0; _index < _data.size(); _index++)
             {
-                auto _hash_rez = Hasher::get_hash(_val.get().first);
-                usize _index = _hash_rez % _buckets.size();
-                _buckets[_index].emplace_back(_hash_rez, _index);
+                auto _hash_rez = Hasher::get_hash(_data[_index].first);
+                usize _bucket_index = umap_detail::bucket_index(
+                    _hash_rez, _buckets.size()
+                );
+                _buckets[_bucket_index].emplace_back(_hash_rez, _index);
             }
         }
 
         inline unordered_map(unordered_map&& other)
-            : _buckets{move(other._buckets)}, _data{move(other._data)}
+            : _max_load_factor{other._max_load_factor},
+            _buckets{move(other._buckets)}, _data{move(other._data)}
         {}
 
         template <usize N>
         inline unordered_map(pair<Key, T> (&&other)[N])
         requires ((umap_detail::DefaultAlloc<Allocator> &&
             umap_detail::DefaultAlloc<BucketAllocator>))
-            : _buckets(10)
+            : _buckets(umap_detail::default_bucket_count)
         {
             for (usize _index = 0; _index < N; _index++)
             {
@@ -179,6 +330,7 @@ namespace hsd
 
         inline unordered_map& operator=(unordered_map&& rhs)
         {
+            _max_load_factor = rhs._max_load_factor;
             _buckets = move(rhs._buckets);
             _data = move(rhs._data);
             return *this;
@@ -221,20 +373,26 @@ namespace hsd
             return *this;
         }
 
-        inline auto& operator[](const Key& key) noexcept
+        template <typename U = Key>
+        inline auto& operator[](U&& key) noexcept
         {
-            return emplace(key).first->second;
+            return try_emplace(forward<U>(key)).first->second;
         }
 
-        inline const auto& operator[](const Key& key) const
+        template <typename U = Key>
+        inline const auto& operator[](const U& key) const
         {
             return at(key).unwrap();
         }
 
-        inline auto at(const Key& key)
+        // Every lookup accepts any type the hasher and the key's
+        // operator== understand, with a transparent hasher that
+        // means a string keyed map can be probed without allocating
+        template <typename U = Key>
+        inline auto at(const U& key)
             -> Result< reference<T>, umap_detail::bad_key >
         {
-            usize _data_index = _get(key).first;
+            usize _data_index = _get(key);
 
             if (_data_index == static_cast<usize>(-1))
                 return umap_detail::bad_key{};
@@ -242,10 +400,11 @@ namespace hsd
             return {_data[_data_index].second};
         }
 
-        inline auto at(const Key& key) const
+        template <typename U = Key>
+        inline auto at(const U& key) const
             -> Result< reference<const T>, umap_detail::bad_key >
         {
-            usize _data_index = _get(key).first;
+            usize _data_index = _get(key);
 
             if (_data_index == static_cast<usize>(-1))
                 return umap_detail::bad_key{};
@@ -253,80 +412,145 @@ namespace hsd
             return {_data[_data_index].second};
         }
 
-        template< typename NewKey, typename... Args >
-        inline pair<iterator, bool> emplace(const NewKey& key, const Args&... args)
+        template <typename U = Key>
+        inline iterator find(const U& key)
         {
-            auto [_data_index, _bucket_index] = _get(key);
+            usize _data_index = _get(key);
 
-            if (_data_index != static_cast<usize>(-1))
-            {
-                return {_data.begin() + _data_index, false};
-            }
-            else
-            {
-                _data.emplace_back(key, T{forward<Args>(args)...});
+            if (_data_index == static_cast<usize>(-1))
+                return end();
 
-                if (static_cast<f64>(_data.size()) / static_cast<f64>(_buckets.size()) >= _limit_ratio)
-                {
-                    _replace(_buckets.size() + _buckets.size() / 2);
-                }
-                else
-                {
-                    _buckets[_bucket_index].emplace_back(
-                        Hasher::get_hash(_data.back().first), _data.size() - 1
-                    );
-                }
+            return _data.begin() + _data_index;
+        }
 
-                return {_data.end() - 1, true};
-            }
+        template <typename U = Key>
+        inline const_iterator find(const U& key) const
+        {
+            usize _data_index = _get(key);
+
+            if (_data_index == static_cast<usize>(-1))
+                return cend();
+
+            return _data.cbegin() + _data_index;
         }
 
-        template< typename NewKey, typename... Args >
-        inline pair<iterator, bool> emplace(NewKey&& key, Args&&... args)
+        template <typename U = Key>
+        inline bool contains(const U& key) const
         {
-            auto [_data_index, _bucket_index] = _get(key);
+            return _get(key) != static_cast<usize>(-1);
+        }
 
-            if (_data_index != static_cast<usize>(-1))
-            {
-                return {_data.begin() + _data_index, false};
-            }
-            else
+        // The key and the value are only built when `key` is not
+        // present, so a hit costs one hash and one comparison
+        template < typename NewKey, typename... Args >
+        inline pair<iterator, bool> try_emplace(NewKey&& key, Args&&... args)
+        {
+            if constexpr (umap_detail::DirectLookup<Hasher, Key, NewKey>)
             {
-                _data.emplace_back(move(key), move(T{forward<Args>(args)...}));
+                auto _key_hash = Hasher::get_hash(key);
+                usize _data_index = _find(key, _key_hash);
 
-                if (static_cast<f64>(_data.size()) / static_cast<f64>(_buckets.size()) >= _limit_ratio)
-                {
-                    _replace(_buckets.size() + _buckets.size() / 2);
-                }
-                else
-                {
-                    _buckets[_bucket_index].emplace_back(
-                        Hasher::get_hash(_data.back().first), _data.size() - 1
-                    );
-                }
+                if (_data_index != static_cast<usize>(-1))
+                    return {_data.begin() + _data_index, false};
+
+                _insert(
+                    _key_hash, Key(forward<NewKey>(key)), 
+                    forward<Args>(args)...
+                );
 
                 return {_data.end() - 1, true};
             }
+            else
+            {
+                return try_emplace(
+                    Key(forward<NewKey>(key)), forward<Args>(args)...
+                );
+            }
+        }
+
+        template < typename NewKey, typename... Args >
+        inline pair<iterator, bool> emplace(NewKey&& key, Args&&... args)
+        {
+            return try_emplace(forward<NewKey>(key), forward<Args>(args)...);
         }
 
+        // Moves the last element into the erased slot, so only
+        // one bucket entry has to be patched instead of shifting
+        // (and invalidating) every element after `pos`
         inline auto erase(const_iterator pos)
             -> Result<iterator, umap_detail::bad_access>
         {
-            auto _result = _get_iter(pos->first);
-            
-            if (_result.is_ok() == false)
+            if (pos < _data.cbegin() || pos >= _data.cend())
                 return umap_detail::bad_access{};
-            
-            // now .unwrap() should not fail
-            auto [_iter, _index] = _result.unwrap();
-            _buckets[_index].erase(_iter).unwrap(HSD_FUNCTION_NAME);
-            return _data.erase(pos).unwrap(HSD_FUNCTION_NAME);
+
+            usize _data_index = static_cast<usize>(pos - _data.cbegin());
+            usize _last_index = _data.size() - 1;
+            _unlink(_data_index);
+
+            if (_data_index != _last_index)
+            {
+                _relink(_last_index, _data_index);
+                _data[_data_index] = move(_data[_last_index]);
+            }
+
+            _data.pop_back();
+            return _data.begin() + _data_index;
         }
 
         inline void clear()
         {
             _data.clear();
-            _buckets.clear();
+
+            for (auto& _bucket : _buckets)
+                _bucket.clear();
+        }
+
+        // Sets the number of buckets to at least `count` (rounded
+        // up to a power of two), but never below what the current
+        // size needs to stay under the max load factor
+        inline void rehash(usize count)
+        {
+            usize _min_count = _min_bucket_count(_data.size());
+            usize _new_count = umap_detail::next_pow2(
+                count > _min_count ? count : _min_count
+            );
+
+            if (_new_count != _buckets.size())
+                _replace(_new_count);
+        }
+
+        // Makes room for `count` elements without any further rehashing
+        inline void reserve(usize count)
+        {
+            _data.reserve(count);
+            usize _new_count = umap_detail::next_pow2(_min_bucket_count(count));
+
+            if (_new_count > _buckets.size())
+                _replace(_new_count);
+        }
+
+        inline f32 max_load_factor() const
+        {
+            return _max_load_factor;
+        }
+
+        inline void max_load_factor(f32 ratio)
+        {
+            _max_load_factor = ratio;
+
+            if (load_factor() > _max_load_factor)
+                rehash(0);
+        }
+
+        inline f32 load_factor() const
+        {
+            return static_cast<f32>(_data.size()) / 
+                static_cast<f32>(_buckets.size());
+        }
+
+        inline usize bucket_count() const
+        {
+            return _buckets.size();
         }
 
         inline usize size() const
@@ -399,8 +623,317 @@ namespace hsd
     unordered_map(pair<Key, T> (&&other)[N]) 
         -> unordered_map<Key, T, hash<usize, Key>>;
 
-    template< typename Key, typename T >
+    // Fixed capacity map that works in constant expressions, every
+    // insertion rebuilds a perfect hash of the keys (the "hash and
+    // displace" algorithm of CHD), so a lookup is one hash and one
+    // key comparison, without probing and without any heap memory
+    template < typename Key, typename T, usize N, typename Hasher = hash<usize, Key> >
+    class static_umap
+    {
+    private:
+        static_assert(N > 0, "static_umap needs a capacity of at least 1");
+
+        static constexpr usize _npos = static_cast<usize>(-1);
+        static constexpr usize _max_attempts = 1'000'000;
+
+        // Buckets with a single key store their slot directly
+        static constexpr usize _direct_flag = 
+            static_cast<usize>(1) << (sizeof(usize) * 8 - 1);
+
+        stack_array< pair<Key, T>, N > _data;
+        stack_array<usize, N> _seeds;
+        stack_array<usize, N> _slots;
+        usize _size = 0;
+
+        static constexpr u64 _hash_of(const Key& key)
+        {
+            return static_cast<u64>(Hasher::get_hash(key));
+        }
+
+        static constexpr usize _bucket_of(u64 hash)
+        {
+            return umap_detail::reduce(umap_detail::seeded_mix(hash, 0), N);
+        }
+
+        static constexpr usize _slot_of(u64 hash, usize seed)
+        {
+            return umap_detail::reduce(umap_detail::seeded_mix(hash, seed + 1), N);
+        }
+
+        constexpr usize _linear_find(const Key& key) const
+        {
+            for (usize _index = 0; _index < _size; _index++)
+            {
+                if (umap_detail::key_equal(_data[_index].first, key))
+                    return _index;
+            }
+
+            return _npos;
+        }
+
+        constexpr usize _find(const Key& key) const
+        {
+            if (_size == 0)
+                return _npos;
+
+            u64 _hash = _hash_of(key);
+            usize _seed = _seeds[_bucket_of(_hash)];
+
+            usize _slot = (_seed & _direct_flag) ? 
+                (_seed & ~_direct_flag) : _slot_of(_hash, _seed);
+
+            usize _index = _slots[_slot];
+
+            if (_index != _npos && umap_detail::key_equal(_data[_index].first, key))
+                return _index;
+
+            return _npos;
+        }
+
+        constexpr auto _build()
+            -> Result< void, umap_detail::static_map_error >
+        {
+            u64 _hashes[N]{};
+            usize _buckets[N]{};
+            usize _counts[N]{};
+            bool _used[N]{};
+            usize _max_count = 0;
+
+            for (usize _index = 0; _index < N; _index++)
+            {
+                _seeds[_index] = 0;
+                _slots[_index] = _npos;
+            }
+
+            for (usize _index = 0; _index < _size; _index++)
+            {
+                _hashes[_index] = _hash_of(_data[_index].first);
+                _buckets[_index] = _bucket_of(_hashes[_index]);
+                _counts[_buckets[_index]]++;
+
+                if (_counts[_buckets[_index]] > _max_count)
+                    _max_count = _counts[_buckets[_index]];
+            }
+
+            // The biggest buckets are placed first, while
+            // most of the slots are still free
+            for (usize _count = _max_count; _count > 1; _count--)
+            {
+                for (usize _bucket = 0; _bucket < N; _bucket++)
+                {
+                    if (_counts[_bucket] != _count)
+                        continue;
+
+                    usize _members[N]{};
+                    usize _member_count = 0;
+
+                    for (usize _index = 0; _index < _size; _index++)
+                    {
+                        if (_buckets[_index] == _bucket)
+                        {
+                            for (usize _prev = 0; _prev < _member_count; _prev++)
+                            {
+                                if (_hashes[_members[_prev]] == _hashes[_index])
+                                    return umap_detail::static_map_error{"static_umap: two keys have the same hash"};
+                            }
+
+                            _members[_member_count++] = _index;
+                        }
+                    }
+
+                    usize _seed = 0;
+
+                    for (; _seed < _max_attempts; _seed++)
+                    {
+                        usize _member = 0;
+
+                        for (; _member < _member_count; _member++)
+                        {
+                            usize _slot = _slot_of(_hashes[_members[_member]], _seed);
+
+                            if (_used[_slot])
+                                break;
+
+                            _used[_slot] = true;
+                        }
+
+                        if (_member == _member_count)
+                            break;
+
+                        // Roll back the slots taken by this attempt
+                        for (usize _undo = 0; _undo < _member; _undo++)
+                            _used[_slot_of(_hashes[_members[_undo]], _seed)] = false;
+                    }
+
+                    if (_seed == _max_attempts)
+                        return umap_detail::static_map_error{"static_umap: could not build the perfect hash"};
+
+                    _seeds[_bucket] = _seed;
+
+                    for (usize _member = 0; _member < _member_count; _member++)
+                        _slots[_slot_of(_hashes[_members[_member]], _seed)] = _members[_member];
+                }
+            }
+
+            usize _free_slot = 0;
+
+            for (usize _index = 0; _index < _size; _index++)
+            {
+                if (_counts[_buckets[_index]] == 1)
+                {
+                    while (_used[_free_slot])
+                        _free_slot++;
+
+                    _used[_free_slot] = true;
+                    _slots[_free_slot] = _index;
+                    _seeds[_buckets[_index]] = _direct_flag | _free_slot;
+                }
+            }
+
+            return {};
+        }
+
+        template <typename... Args>
+        constexpr auto _insert(const Key& key, Args&&... args)
+            -> Result< void, umap_detail::static_map_error >
+        {
+            if (_size == N)
+                return umap_detail::static_map_error{"static_umap: no space left for a new key"};
+
+            _data[_size] = pair<Key, T>{key, T{forward<Args>(args)...}};
+            _size++;
+            return _build();
+        }
+
+    public:
+        using reference_type = T&;
+        using iterator = pair<Key, T>*;
+        using const_iterator = const pair<Key, T>*;
+
+        constexpr static_umap() = default;
+
+        template <usize M> requires (M <= N)
+        constexpr static_umap(pair<Key, T> (&&other)[M])
+        {
+            for (usize _index = 0; _index < M; _index++)
+            {
+                if (_linear_find(other[_index].first) == _npos)
+                    _data[_size++] = move(other[_index]);
+            }
+
+            _build().unwrap();
+        }
+
+        constexpr auto& operator[](const Key& key)
+        {
+            return emplace(key).first->second;
+        }
+
+        constexpr const auto& operator[](const Key& key) const
+        {
+            return at(key).unwrap();
+        }
+
+        constexpr auto at(const Key& key)
+            -> Result< reference<T>, umap_detail::bad_key >
+        {
+            usize _index = _find(key);
+
+            if (_index == _npos)
+                return umap_detail::bad_key{};
+
+            return {_data[_index].second};
+        }
+
+        constexpr auto at(const Key& key) const
+            -> Result< reference<const T>, umap_detail::bad_key >
+        {
+            usize _index = _find(key);
+
+            if (_index == _npos)
+                return umap_detail::bad_key{};
+
+            return {_data[_index].second};
+        }
+
+        constexpr iterator find(const Key& key)
+        {
+            usize _index = _find(key);
+            return _index == _npos ? end() : begin() + _index;
+        }
+
+        constexpr const_iterator find(const Key& key) const
+        {
+            usize _index = _find(key);
+            return _index == _npos ? end() : begin() + _index;
+        }
+
+        constexpr bool contains(const Key& key) const
+        {
+            return _find(key) != _npos;
+        }
+
+        template <typename... Args>
+        constexpr pair<iterator, bool> emplace(const Key& key, Args&&... args)
+        {
+            usize _index = _find(key);
+
+            if (_index != _npos)
+                return {begin() + _index, false};
+
+            _insert(key, forward<Args>(args)...).unwrap();
+
+            return {begin() + _size - 1, true};
+        }
+
+        constexpr usize size() const
+        {
+            return _size;
+        }
+
+        constexpr usize capacity() const
+        {
+            return N;
+        }
+
+        constexpr iterator begin()
+        {
+            return _data.begin();
+        }
+
+        constexpr const_iterator begin() const
+        {
+            return cbegin();
+        }
+
+        constexpr iterator end()
+        {
+            return begin() + _size;
+        }
+
+        constexpr const_iterator end() const
+        {
+            return cend();
+        }
+
+        constexpr const_iterator cbegin() const
+        {
+            return _data.cbegin();
+        }
+
+        constexpr const_iterator cend() const
+        {
+            return cbegin() + _size;
+        }
+    };
+
+    template< typename Key, typename T, usize N >
+    static_umap(pair<Key, T> (&&other)[N]) 
+        -> static_umap<Key, T, N>;
+
+    template< typename Key, typename T, 
+        template <typename> typename Allocator = size_class_allocator >
     using buffered_umap = unordered_map<
-        Key, T, hash<usize, Key>, buffered_allocator
+        Key, T, hash<usize, Key>, Allocator
     >;
 } // namespace hsd
\ No newline at end of file
@@ -162,4 +162,22 @@ namespace hsd
     {
         return static_cast<const Elem*>(arr) + Count;
     }
+
+    template <typename T>
+    struct less
+    {
+        constexpr bool operator()(const T& lhs, const T& rhs) const
+        {
+            return lhs < rhs;
+        }
+    };
+
+    template <typename T>
+    struct greater
+    {
+        constexpr bool operator()(const T& lhs, const T& rhs) const
+        {
+            return rhs < lhs;
+        }
+    };
 }
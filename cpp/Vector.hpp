@@ -8,6 +8,104 @@
 
 namespace hsd
 {
+    namespace vector_detail
+    {
+        template < typename Alloc, typename T >
+        concept Reallocatable = requires(Alloc& alloc, T* ptr, usize size)
+        {
+            alloc.reallocate(ptr, size, size).unwrap();
+        };
+
+        // Moves `size` elements from `src` into the uninitialized
+        // `dest`, the old elements must not be destroyed afterwards
+        template < typename T, typename Alloc >
+        inline void relocate(Alloc& alloc, T* dest, T* src, usize size)
+        {
+            if constexpr (is_trivially_relocatable<T>::value)
+            {
+                if (size != 0)
+                    memcpy(static_cast<void*>(dest), static_cast<void*>(src), size * sizeof(T));
+            }
+            else
+            {
+                for (usize _index = 0; _index < size; ++_index)
+                {
+                    alloc.construct_at(&dest[_index], move(src[_index]));
+                    src[_index].~T();
+                }
+            }
+        }
+
+        template <typename Iter>
+        inline usize distance(Iter first, Iter last)
+        {
+            if constexpr (requires { last - first; })
+            {
+                return static_cast<usize>(last - first);
+            }
+            else
+            {
+                usize _count = 0;
+
+                for (; first != last; ++first)
+                    _count++;
+
+                return _count;
+            }
+        }
+
+        // Moves the elements from `pos` onwards `count` places to the
+        // right, into the uninitialized space after the `size` elements
+        template < typename T, typename Alloc >
+        inline void shift_right(Alloc& alloc, T* data, usize size, usize pos, usize count)
+        {
+            if constexpr (is_trivially_relocatable<T>::value)
+            {
+                memmove(
+                    static_cast<void*>(data + pos + count), 
+                    static_cast<void*>(data + pos), (size - pos) * sizeof(T)
+                );
+            }
+            else
+            {
+                for (usize _index = size; _index > pos; --_index)
+                {
+                    alloc.construct_at(&data[_index - 1 + count], move(data[_index - 1]));
+                    data[_index - 1].~T();
+                }
+            }
+        }
+
+        // Erases [from, to) out of the first `size` elements of `data`
+        template <typename T>
+        inline void erase_range(T* data, usize size, usize from, usize to)
+        {
+            if (from == to)
+                return;
+
+            if constexpr (is_trivially_relocatable<T>::value)
+            {
+                for (usize _index = from; _index < to; ++_index)
+                    data[_index].~T();
+
+                memmove(
+                    static_cast<void*>(data + from), 
+                    static_cast<void*>(data + to), (size - to) * sizeof(T)
+                );
+            }
+            else
+            {
+                usize _count = to - from;
+
+                for (usize _index = to; _index < size; ++_index)
+                    data[_index - _count] = move(data[_index]);
+
+                for (usize _index = size; _index > size - _count; --_index)
+                    data[_index - 1].~T();
+            }
+        }
+    } // namespace vector_detail
+
     template < typename T, template <typename> typename Allocator = allocator >
     class vector
     {
@@ -26,6 +124,120 @@ namespace hsd
             }
         };
 
+        // Moves the elements to a buffer of `new_cap` elements, trivially
+        // relocatable ones are resized in place if the allocator can
+        inline void _reallocate(usize new_cap)
+        {
+            if constexpr (
+                is_trivially_relocatable<T>::value && 
+                vector_detail::Reallocatable<alloc_type, T>)
+            {
+                if (_data != nullptr)
+                {
+                    _data = _alloc.reallocate(_data, _capacity, new_cap).unwrap();
+                    _capacity = new_cap;
+                    return;
+                }
+            }
+
+            T* _new_buf = _alloc.allocate(new_cap).unwrap();
+
+            // The first growth has nothing to move or give back
+            if (_data != nullptr)
+            {
+                vector_detail::relocate(_alloc, _new_buf, _data, _size);
+                _alloc.deallocate(_data, _capacity).unwrap();
+            }
+
+            _data = _new_buf;
+            _capacity = new_cap;
+        }
+
+        inline void _copy_from(const T* src, usize size)
+        {
+            _construct_range(0, src, size);
+        }
+
+        // Copy constructs `count` elements from `first` starting at
+        // `pos`, contiguous trivially copyable ones with one memcpy
+        template <typename Iter>
+        inline void _construct_range(usize pos, Iter first, usize count)
+        {
+            if constexpr (
+                std::is_trivially_copyable_v<T> && is_pointer<Iter>::value &&
+                IsSame<remove_cv_t<remove_pointer_t<Iter>>, T>)
+            {
+                if (count != 0)
+                {
+                    memcpy(
+                        static_cast<void*>(_data + pos), 
+                        static_cast<const void*>(first), count * sizeof(T)
+                    );
+                }
+            }
+            else
+            {
+                for (usize _index = 0; _index < count; ++_index, ++first)
+                    _alloc.construct_at(&_data[pos + _index], *first);
+            }
+        }
+
+        // True if `count` elements from `first` are elements of this
+        // vector, those move or die before a copy from them is done
+        template <typename Iter>
+        inline bool _overlaps(Iter first, usize count) const
+        {
+            if constexpr (
+                is_pointer<Iter>::value &&
+                IsSame<remove_cv_t<remove_pointer_t<Iter>>, T>)
+            {
+                auto _first = bit_cast<usize>(first);
+                auto _begin = bit_cast<usize>(_data);
+
+                return count != 0 && _first < _begin + _size * sizeof(T) &&
+                    _first + count * sizeof(T) > _begin;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        inline usize _grown_capacity(usize new_cap) const
+        {
+            if (new_cap <= _capacity)
+                return _capacity;
+
+            // To handle _capacity = 0 case
+            usize _new_capacity = _capacity ? _capacity : 1;
+
+            while (_new_capacity < new_cap)
+                _new_capacity += (_new_capacity + 1) / 2;
+
+            return _new_capacity;
+        }
+
+        // Copies `count` elements from `first` into a new buffer of
+        // `new_cap` at `pos`, and only then moves the old elements
+        // around them and frees the old buffer, so the source may be
+        // the vector itself
+        template <typename Iter>
+        inline void _insert_into_new(usize new_cap, usize pos, Iter first, usize count)
+        {
+            T* _old_buf = exchange(_data, _alloc.allocate(new_cap).unwrap());
+            _construct_range(pos, first, count);
+
+            if (_old_buf != nullptr)
+            {
+                vector_detail::relocate(_alloc, _data, _old_buf, pos);
+                vector_detail::relocate(_alloc, _data + pos + count, _old_buf + pos, _size - pos);
+                _alloc.deallocate(_old_buf, _capacity).unwrap();
+            }
+
+            _capacity = new_cap;
+            _size += count;
+        }
+
     public:
         using value_type = T;
         using iterator = T*;
@@ -66,9 +278,7 @@ namespace hsd
             : _alloc(other._alloc), _size(other._size), _capacity(other._capacity)
         {
             _data = _alloc.allocate(other._capacity).unwrap();
-
-            for (usize _index = 0; _index < _size; ++_index)
-                _alloc.construct_at(&_data[_index], other[_index]);
+            _copy_from(other._data, _size);
         }
 
         inline vector(const vector& other)
@@ -76,9 +286,7 @@ namespace hsd
             : _size(other._size), _capacity(other._capacity)
         {
             _data = _alloc.allocate(other._capacity).unwrap();
-
-            for (usize _index = 0; _index < _size; ++_index)
-                _alloc.construct_at(&_data[_index], other[_index]);
+            _copy_from(other._data, _size);
         }
 
         inline vector(vector&& other)
@@ -120,7 +328,19 @@ namespace hsd
 
         inline vector& operator=(const vector& rhs)
         {
-            if (_capacity < rhs._size)
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                if (_capacity < rhs._size)
+                {
+                    // The old values are overwritten, no need to keep them
+                    _size = 0;
+                    _reallocate(rhs._size);
+                }
+
+                _copy_from(rhs._data, rhs._size);
+                _size = rhs._size;
+            }
+            else if (_capacity < rhs._size)
             {
                 clear();
                 reserve(rhs._size);
@@ -183,7 +403,7 @@ namespace hsd
             else
             {
                 usize _index;
-                usize min_size = _size > N ? _size : N;
+                usize min_size = _size < N ? _size : N;
                 
                 for (_index = 0; _index < min_size; ++_index)
                 {
@@ -222,7 +442,7 @@ namespace hsd
             else
             {
                 usize _index;
-                usize min_size = _size > N ? _size : N;
+                usize min_size = _size < N ? _size : N;
                 
                 for (_index = 0; _index < min_size; ++_index)
                 {
@@ -287,27 +507,97 @@ namespace hsd
             if (from < begin() || from > end() || to < begin() || to > end() || from > to)
                 return bad_access{};
 
-            if (to == end())
+            usize _current_pos = static_cast<usize>(from - begin());
+            usize _last_pos = static_cast<usize>(to - begin());
+
+            vector_detail::erase_range(_data, _size, _current_pos, _last_pos);
+            _size -= _last_pos - _current_pos;
+            return begin() + _current_pos;
+        }
+
+        // Inserts copies of [first, last) before `pos`, growing at most once
+        template <typename Iter>
+        inline auto insert(const_iterator pos, Iter first, Iter last)
+            -> Result<iterator, bad_access>
+        {
+            if (pos < begin() || pos > end())
+                return bad_access{};
+
+            usize _pos = static_cast<usize>(pos - begin());
+            usize _count = vector_detail::distance(first, last);
+
+            if (_size + _count > _capacity || _overlaps(first, _count))
             {
-                for(; from != end(); from++)
-                    from->~T();
-    
-                return end();
+                _insert_into_new(_grown_capacity(_size + _count), _pos, first, _count);
+            }
+            else if (_count != 0)
+            {
+                vector_detail::shift_right(_alloc, _data, _size, _pos, _count);
+                _construct_range(_pos, first, _count);
+                _size += _count;
+            }
+
+            return begin() + _pos;
+        }
+
+        template <typename Iter>
+        inline void append(const span<Iter>& values)
+        {
+            usize _count = values.size();
+
+            if (_count == 0)
+                return;
+
+            // Appending to the end leaves the elements where they are,
+            // only a growth has to keep a source inside the vector alive
+            if (_size + _count > _capacity)
+            {
+                if constexpr (is_pointer<Iter>::value)
+                    _insert_into_new(_grown_capacity(_size + _count), _size, &*values.begin(), _count);
+                else
+                    _insert_into_new(_grown_capacity(_size + _count), _size, values.begin(), _count);
+
+                return;
+            }
+
+            if constexpr (is_pointer<Iter>::value)
+            {
+                _construct_range(_size, &*values.begin(), _count);
             }
             else
             {
-                usize _current_pos = static_cast<usize>(from - begin());
-                usize _last_pos = static_cast<usize>(to - begin());
+                _construct_range(_size, values.begin(), _count);
+            }
 
-                for (usize _index = 0; _index < _capacity - _last_pos; _index++)
-                {
-                    _data[_current_pos + _index] = 
-                        move(_data[_last_pos + _index]);
-                }
+            _size += _count;
+        }
+
+        // Replaces the elements with copies of [first, last)
+        template <typename Iter>
+        inline void assign(Iter first, Iter last)
+        {
+            usize _count = vector_detail::distance(first, last);
+
+            // The source is part of this vector, it is copied into a
+            // new buffer before the old elements are destroyed
+            if (_overlaps(first, _count))
+            {
+                usize _old_size = exchange(_size, 0u);
+                T* _old_buf = exchange(_data, _alloc.allocate(_capacity).unwrap());
+                _construct_range(0, first, _count);
+
+                for (usize _index = _old_size; _index > 0; --_index)
+                    _old_buf[_index - 1].~T();
 
-                _size -= static_cast<usize>(to - from) + 1;
-                return begin() + _last_pos;
+                _alloc.deallocate(_old_buf, _capacity).unwrap();
+                _size = _count;
+                return;
             }
+
+            clear();
+            reserve(_count);
+            _construct_range(0, first, _count);
+            _size = _count;
         }
 
         inline auto at(usize index)
@@ -349,27 +639,7 @@ namespace hsd
         inline void reserve(usize new_cap)
         {
             if (new_cap > _capacity)
-            {
-                // To handle _capacity = 0 case
-                usize _new_capacity = _capacity ? _capacity : 1;
-
-                while (_new_capacity < new_cap)
-                    _new_capacity += (_new_capacity + 1) / 2;
-
-                T* _new_buf = _alloc.allocate(_new_capacity).unwrap();
-
-                for (usize _index = 0; _index < _size; ++_index)
-                {
-                    auto& _value = at_unchecked(_index);
-                    _alloc.construct_at(&_new_buf[_index], move(_value));
-                    _value.~T();
-                }
-
-                _alloc.deallocate(_data, _capacity).unwrap();
-                _data = _new_buf;
-                
-                _capacity = _new_capacity;
-            }
+                _reallocate(_grown_capacity(new_cap));
         }
 
         inline void shrink_to_fit()
@@ -377,63 +647,25 @@ namespace hsd
             if (_size == 0)
             {
                 T* _old_buf = exchange(_data, nullptr);
-                deallocate(_old_buf, _capacity).unwrap();
+                _alloc.deallocate(_old_buf, _capacity).unwrap();
                 _capacity = 0;
             }
             else if (_size < _capacity)
             {
-                T* _new_buf = _alloc.allocate(_size).unwrap();
-                move<T>(_data, _data + _size, _new_buf);
-                deallocate(_data, _capacity).unwrap();
-                _capacity = _size;
-                _data = _new_buf;
+                _reallocate(_size);
             }
         }
 
         inline void resize(usize new_size)
         {
-            if (new_size > _capacity)
+            if (new_size > _size)
             {
-                // To handle _capacity = 0 case
-                usize _new_capacity = _capacity ? _capacity : 1;
-                
-                while (_new_capacity < new_size)
-                    _new_capacity += (_new_capacity + 1) / 2;
-
-                T* _new_buf = _alloc.allocate(_new_capacity).unwrap();
-                usize _index = 0;
-
-                for (; _index < _size; ++_index)
-                {
-                    auto& _value = at_unchecked(_index);
-                    _alloc.construct_at(&_new_buf[_index], move(_value));
-                    _value.~T();
-                }
-                for (; _index < new_size; ++_index)
-                {
-                    if constexpr(
-                        std::is_constructible_v<T, alloc_type> && 
-                        !std::is_default_constructible_v<T>)
-                    {
-                        _alloc.construct_at(&_new_buf[_index], _alloc);
-                    }
-                    else
-                    {
-                        _alloc.construct_at(&_new_buf[_index]);
-                    }
-                }
+                reserve(new_size);
 
-                _alloc.deallocate(_data, _capacity).unwrap();
-                _data = _new_buf;
-                _capacity = _new_capacity;
-                _size = new_size;
-            }
-            else if (new_size > _size)
-            {
                 for (usize _index = _size; _index < new_size; ++_index)
                 {
                     if constexpr(
-                        std::is_copy_constructible_v<alloc_type> &&
+                        std::is_constructible_v<T, alloc_type> && 
                         !std::is_default_constructible_v<T>)
                     {
                         _alloc.construct_at(&_data[_index], _alloc);
@@ -455,6 +687,17 @@ namespace hsd
             }
         }
 
+        // Like resize, but the new elements are left uninitialized,
+        // for buffers that are about to be written over anyway
+        inline void resize_for_overwrite(usize new_size)
+        requires (
+            std::is_trivially_default_constructible_v<T> && 
+            std::is_trivially_destructible_v<T>)
+        {
+            reserve(new_size);
+            _size = new_size;
+        }
+
         inline void push_back(const T& val)
         {
             emplace_back(val);
@@ -468,7 +711,9 @@ namespace hsd
         template <typename... Args>
         inline void emplace_back(Args&&... args)
         {
-            reserve(_size + 1);
+            if (_size == _capacity)
+                reserve(_size + 1);
+
             _alloc.construct_at(&_data[_size], forward<Args>(args)...);
             ++_size;
         }
@@ -752,27 +997,12 @@ namespace hsd
             if (from < begin() || from > end() || to < begin() || to > end() || from > to)
                 return bad_access{};
 
-            if (to == end())
-            {
-                for (; from != end(); from++)
-                    from->~T();
-    
-                return end();
-            }
-            else
-            {
-                usize _current_pos = static_cast<usize>(from - begin());
-                usize _last_pos = static_cast<usize>(to - begin());
-
-                for (usize _index = 0; _index < _capacity - _last_pos; _index++)
-                {
-                    _data[_current_pos + _index] = 
-                        move(_data[_last_pos + _index]);
-                }
+            usize _current_pos = static_cast<usize>(from - begin());
+            usize _last_pos = static_cast<usize>(to - begin());
 
-                _size -= static_cast<usize>(to - from) + 1;
-                return begin() + _last_pos;
-            }
+            vector_detail::erase_range(data(), _size, _current_pos, _last_pos);
+            _size -= _last_pos - _current_pos;
+            return begin() + _current_pos;
         }
 
         constexpr auto at(usize index)
@@ -938,9 +1168,505 @@ namespace hsd
         }
     };
 
+    // Keeps up to `N` elements inside the object itself and moves
+    // them to memory from `Allocator` only once it grows past that,
+    // so short lived, mostly small collections don't allocate at all
+    template < typename T, usize N, template <typename> typename Allocator = allocator >
+    class small_vector
+    {
+    private:
+        static_assert(N > 0, "small_vector needs room for at least one element");
+
+        using alloc_type = Allocator<T>;
+        alloc_type _alloc;
+        T* _data = _inline_data();
+        usize _size = 0;
+        usize _capacity = N;
+        alignas(T) uchar _inline[N * sizeof(T)];
+
+        struct bad_access
+        {
+            const char* operator()() const
+            {
+                return "Tried to access an element out of bounds";
+            }
+        };
+
+        inline T* _inline_data()
+        {
+            return bit_cast<T*>(&_inline[0]);
+        }
+
+        inline void _destroy_all()
+        {
+            for (usize _index = _size; _index > 0; --_index)
+                at_unchecked(_index - 1).~T();
+
+            _size = 0;
+        }
+
+        inline void _release()
+        {
+            if (!is_inline())
+                _alloc.deallocate(_data, _capacity).unwrap();
+
+            _data = _inline_data();
+            _capacity = N;
+        }
+
+        // Moves the elements into `new_buf` (inline if null)
+        inline void _relocate(T* new_buf, usize new_capacity)
+        {
+            T* _target = new_buf != nullptr ? new_buf : _inline_data();
+            vector_detail::relocate(_alloc, _target, _data, _size);
+
+            if (!is_inline())
+                _alloc.deallocate(_data, _capacity).unwrap();
+
+            _data = _target;
+            _capacity = new_capacity;
+        }
+
+        // Takes the elements of `other`, stealing its buffer if it has one
+        inline void _steal(small_vector& other)
+        {
+            if (other.is_inline())
+            {
+                vector_detail::relocate(_alloc, _data, other._data, other._size);
+                _size = exchange(other._size, 0u);
+            }
+            else
+            {
+                _data = exchange(other._data, other._inline_data());
+                _capacity = exchange(other._capacity, N);
+                _size = exchange(other._size, 0u);
+            }
+        }
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        inline ~small_vector()
+        {
+            _destroy_all();
+            _release();
+        }
+
+        inline small_vector()
+            requires (std::is_default_constructible_v<alloc_type>)
+        {}
+
+        inline small_vector(usize size)
+            requires (std::is_default_constructible_v<alloc_type>)
+        {
+            resize(size);
+        }
+
+        template <typename Alloc = alloc_type>
+        inline small_vector(const Alloc& alloc)
+        requires (std::is_constructible_v<alloc_type, Alloc>)
+            : _alloc(alloc)
+        {}
+
+        template <typename Alloc = alloc_type>
+        inline small_vector(usize size, const Alloc& alloc)
+        requires (std::is_constructible_v<alloc_type, Alloc>)
+            : _alloc(alloc)
+        {
+            resize(size);
+        }
+
+        inline small_vector(const small_vector& other)
+            : _alloc(other._alloc)
+        {
+            reserve(other._size);
+
+            for (usize _index = 0; _index < other._size; _index++)
+                _alloc.construct_at(&_data[_index], other[_index]);
+
+            _size = other._size;
+        }
+
+        // Inline elements are moved one by one, a heap buffer is stolen
+        inline small_vector(small_vector&& other)
+            : _alloc(other._alloc)
+        {
+            _steal(other);
+        }
+
+        template <usize M>
+        inline small_vector(const T (&arr)[M])
+        {
+            reserve(M);
+
+            for (usize _index = 0; _index < M; _index++)
+                _alloc.construct_at(&_data[_index], arr[_index]);
+
+            _size = M;
+        }
+
+        template <usize M>
+        inline small_vector(T (&&arr)[M])
+        {
+            reserve(M);
+
+            for (usize _index = 0; _index < M; _index++)
+                _alloc.construct_at(&_data[_index], move(arr[_index]));
+
+            _size = M;
+        }
+
+        inline small_vector& operator=(const small_vector& rhs)
+        {
+            if (this != &rhs)
+            {
+                clear();
+                reserve(rhs._size);
+
+                for (usize _index = 0; _index < rhs._size; _index++)
+                    _alloc.construct_at(&_data[_index], rhs[_index]);
+
+                _size = rhs._size;
+            }
+
+            return *this;
+        }
+
+        inline small_vector& operator=(small_vector&& rhs)
+        {
+            if (this != &rhs)
+            {
+                _destroy_all();
+                _release();
+                _alloc = rhs._alloc;
+                _steal(rhs);
+            }
+
+            return *this;
+        }
+
+        template <usize M>
+        inline small_vector& operator=(const T (&arr)[M])
+        {
+            clear();
+            reserve(M);
+
+            for (usize _index = 0; _index < M; _index++)
+                _alloc.construct_at(&_data[_index], arr[_index]);
+
+            _size = M;
+            return *this;
+        }
+
+        template <usize M>
+        inline small_vector& operator=(T (&&arr)[M])
+        {
+            clear();
+            reserve(M);
+
+            for (usize _index = 0; _index < M; _index++)
+                _alloc.construct_at(&_data[_index], move(arr[_index]));
+
+            _size = M;
+            return *this;
+        }
+
+        inline auto& operator[](usize index)
+        {
+            return at_unchecked(index);
+        }
+
+        inline auto& operator[](usize index) const
+        {
+            return at_unchecked(index);
+        }
+
+        inline auto& front()
+        {
+            return *begin();
+        }
+
+        inline auto& front() const
+        {
+            return *begin();
+        }
+
+        inline auto& back() noexcept
+        {
+            return *(begin() + size() - 1);
+        }
+
+        inline auto& back() const
+        {
+            return *(begin() + size() - 1);
+        }
+
+        inline auto erase(const_iterator pos)
+            -> Result<iterator, bad_access>
+        {
+            return erase_for(pos, pos + 1);
+        }
+
+        // Erases [from, to), returns the iterator to the element after them
+        inline auto erase_for(const_iterator from, const_iterator to)
+            -> Result<iterator, bad_access>
+        {
+            if (from < begin() || from > end() || to < begin() || to > end() || from > to)
+                return bad_access{};
+
+            usize _current_pos = static_cast<usize>(from - begin());
+            usize _last_pos = static_cast<usize>(to - begin());
+
+            vector_detail::erase_range(_data, _size, _current_pos, _last_pos);
+            _size -= _last_pos - _current_pos;
+            return begin() + _current_pos;
+        }
+
+        inline auto at(usize index)
+            -> Result<reference<T>, bad_access>
+        {
+            if (index >= _size)
+                return bad_access{};
+
+            return {_data[index]};
+        }
+
+        inline auto at(usize index) const
+            -> Result< const reference<T>, bad_access >
+        {
+            if (index >= _size)
+                return bad_access{};
+
+            return {_data[index]};
+        }
+
+        inline auto& at_unchecked(usize index)
+        {
+            return _data[index];
+        }
+
+        inline const auto& at_unchecked(usize index) const
+        {
+            return _data[index];
+        }
+
+        inline void clear() noexcept
+        {
+            _destroy_all();
+        }
+
+        inline void reserve(usize new_cap)
+        {
+            if (new_cap > _capacity)
+            {
+                usize _new_capacity = _capacity;
+
+                while (_new_capacity < new_cap)
+                    _new_capacity += (_new_capacity + 1) / 2;
+
+                _relocate(_alloc.allocate(_new_capacity).unwrap(), _new_capacity);
+            }
+        }
+
+        // Goes back to the inline storage when the elements fit in it
+        inline void shrink_to_fit()
+        {
+            if (is_inline() || _size == _capacity)
+                return;
+
+            if (_size <= N)
+                _relocate(nullptr, N);
+            else
+                _relocate(_alloc.allocate(_size).unwrap(), _size);
+        }
+
+        inline void resize(usize new_size)
+        {
+            if (new_size > _size)
+            {
+                reserve(new_size);
+
+                for (usize _index = _size; _index < new_size; ++_index)
+                {
+                    if constexpr(
+                        std::is_constructible_v<T, alloc_type> &&
+                        !std::is_default_constructible_v<T>)
+                    {
+                        _alloc.construct_at(&_data[_index], _alloc);
+                    }
+                    else
+                    {
+                        _alloc.construct_at(&_data[_index]);
+                    }
+                }
+
+                _size = new_size;
+            }
+            else if (new_size < _size)
+            {
+                for (usize _index = _size; _index > new_size; --_index)
+                    at_unchecked(_index - 1).~T();
+
+                _size = new_size;
+            }
+        }
+
+        inline void push_back(const T& val)
+        {
+            emplace_back(val);
+        }
+
+        inline void push_back(T&& val)
+        {
+            emplace_back(move(val));
+        }
+
+        template <typename... Args>
+        inline void emplace_back(Args&&... args)
+        {
+            if (_size == _capacity)
+            {
+                // `args` may refer to an element, build the value first
+                T _value{forward<Args>(args)...};
+                reserve(_size + 1);
+                _alloc.construct_at(&_data[_size], move(_value));
+            }
+            else
+            {
+                _alloc.construct_at(&_data[_size], forward<Args>(args)...);
+            }
+
+            ++_size;
+        }
+
+        inline void pop_back() noexcept
+        {
+            if(_size > 0)
+            {
+                at_unchecked(_size - 1).~T();
+                _size--;
+            }
+        }
+
+        inline auto to_span()
+        {
+            return span<iterator>{*this};
+        }
+
+        inline auto to_span() const
+        {
+            return span<const_iterator>{*this};
+        }
+
+        inline bool is_inline() const
+        {
+            return _data == bit_cast<const T*>(&_inline[0]);
+        }
+
+        static constexpr usize inline_capacity()
+        {
+            return N;
+        }
+
+        inline usize size() const
+        {
+            return _size;
+        }
+
+        inline usize capacity() const
+        {
+            return _capacity;
+        }
+
+        inline bool empty() const
+        {
+            return _size == 0;
+        }
+
+        inline iterator data()
+        {
+            return _data;
+        }
+
+        inline const_iterator data() const
+        {
+            return _data;
+        }
+
+        inline iterator begin()
+        {
+            return data();
+        }
+
+        inline iterator end()
+        {
+            return begin() + size();
+        }
+
+        inline const_iterator begin() const
+        {
+            return cbegin();
+        }
+
+        inline const_iterator end() const
+        {
+            return cend();
+        }
+
+        inline const_iterator cbegin() const
+        {
+            return _data;
+        }
+
+        inline const_iterator cend() const
+        {
+            return cbegin() + size();
+        }
+
+        inline iterator rbegin()
+        {
+            return end() - 1;
+        }
+
+        inline iterator rend()
+        {
+            return begin() - 1;
+        }
+
+        inline const_iterator rbegin() const
+        {
+            return crbegin();
+        }
+
+        inline const_iterator rend() const
+        {
+            return crend();
+        }
+
+        inline const_iterator crbegin() const
+        {
+            return cend() - 1;
+        }
+
+        inline const_iterator crend() const
+        {
+            return cbegin() - 1;
+        }
+    };
+
+    // Only owns a pointer to its elements, so it can be relocated if its allocator can
+    template < typename T, template <typename> typename Allocator >
+    struct is_trivially_relocatable<vector<T, Allocator>>
+        : is_trivially_relocatable<Allocator<T>>
+    {};
+
     template < typename T, usize N > vector(const T (&)[N]) -> vector<T>;
     template < typename T, usize N > vector(T (&&)[N]) -> vector<T>;
-    template < typename T > using buffered_vector = vector< T, buffered_allocator >;
+    template < typename T, template <typename> typename Allocator = size_class_allocator >
+    using buffered_vector = vector< T, Allocator >;
+    template < typename T, usize N > using buffered_small_vector = small_vector< T, N, buffered_allocator >;
 
     template< typename L, typename... U >
     requires (std::is_constructible_v<L, U> && ...)